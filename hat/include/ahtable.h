@@ -14,6 +14,10 @@
  * store keys contiguously in one big array, thereby improving the caching
  * behavior, and reducing space requirments.
  *
+ * Every slot starts with a one byte tag per key, taken from the key's hash,
+ * followed by the keys. The tags are compared 16 at a time with SSE2, so only
+ * keys with a matching tag have to be compared.
+ *
  */
 
 #ifndef HATTRIE_AHTABLE_H
@@ -41,8 +45,15 @@ typedef struct ahtable_t_
     size_t m;        // numbur of key/value pairs stored
     size_t max_m;    // number of stored keys before we resize
 
-    size_t*  slot_sizes;
-    slot_t*  slots;
+    size_t*   slot_sizes;  // bytes used by the keys of every slot
+    uint32_t* slot_counts; // number of keys in every slot
+    slot_t*   slots;
+
+    /* position (slot, offset) of the smallest and largest key, kept up to date
+     * on insertion and recomputed when deleting or resizing moves them, so
+     * lookups never write to the table */
+    size_t min_slot, min_offset;
+    size_t max_slot, max_offset;
 } ahtable_t;
 
 extern const double ahtable_max_load_factor;
@@ -75,6 +86,13 @@ value_t* ahtable_tryget (ahtable_t*, const char* key, size_t len);
 int ahtable_del(ahtable_t*, const char* key, size_t len);
 
 
+/** Find the smallest and largest key (in sorted iteration order) that start
+ * with the given prefix, without sorting the table. Returns false if there is
+ * no such key. With an empty prefix, this takes constant time. */
+bool ahtable_prefix_range(const ahtable_t*, const char* prefix, size_t len,
+                          value_t** min, value_t** max);
+
+
 typedef struct ahtable_iter_t_ ahtable_iter_t;
 
 ahtable_iter_t* ahtable_iter_begin     (const ahtable_t*, bool sorted);
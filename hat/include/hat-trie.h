@@ -62,6 +62,17 @@ typedef int (*hattrie_walk_cb)(const char* key, size_t len, value_t* val, void*
  */
 void hattrie_walk (hattrie_t*, const char* key, size_t len, void* user_data, hattrie_walk_cb);
 
+/** Find the values of the smallest and largest key (in sorted iteration
+ * order) that start with the given prefix. Returns false if there is no such
+ * key.
+ *
+ * Unlike a prefixed iterator, this does not visit or sort the matching keys:
+ * it follows the prefix down the trie, then the leftmost and rightmost paths
+ * below it. Only a bucket that holds keys both inside and outside the range is
+ * scanned, once.
+ */
+bool hattrie_prefix_range(const hattrie_t*, const char* prefix, size_t len, value_t** min, value_t** max);
+
 /** Delete a given key from trie. Returns 0 if successful or -1 if not found.
 */
 int hattrie_del(hattrie_t* T, const char* key, size_t len);
@@ -10,6 +10,7 @@
 #include "murmurhash3.h"
 #include <assert.h>
 #include <string.h>
+#include <emmintrin.h> // x86 SSE2 intrinsics
 
 
 
@@ -27,6 +28,191 @@ static size_t keylen(slot_t s) {
 }
 
 
+static size_t keysize(size_t len) {
+    return (len < 128 ? 1 : 2) + len + sizeof(value_t);
+}
+
+
+static slot_t next_key(slot_t s) {
+    return s + keysize(keylen(s));
+}
+
+
+/* Tags are padded to whole blocks, so blocks can be loaded without checking
+ * the end of the slot. */
+#define TAG_BLOCK 16
+
+static size_t tag_bytes(size_t count) {
+    return (count + TAG_BLOCK - 1) & ~((size_t) TAG_BLOCK - 1);
+}
+
+
+static slot_t slot_keys(const ahtable_t* T, size_t i) {
+    return T->slots[i] + tag_bytes(T->slot_counts[i]);
+}
+
+
+static unsigned char key_tag(uint32_t h) {
+    /* the slot is chosen by the low bits */
+    return (unsigned char) (h >> 24);
+}
+
+
+/* bit mask of the tags in a block that equal tag */
+static unsigned tag_mask(const unsigned char* tags, size_t count, unsigned char tag)
+{
+    __m128i cmp = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) tags),
+                                 _mm_set1_epi8((char) tag));
+    unsigned mask = (unsigned) _mm_movemask_epi8(cmp);
+    return count < TAG_BLOCK ? mask & ((1u << count) - 1) : mask;
+}
+
+
+static inline uint64_t mum(uint64_t a, uint64_t b)
+{
+    __uint128_t r = (__uint128_t) a * b;
+    return (uint64_t) r ^ (uint64_t) (r >> 64);
+}
+
+
+static inline uint64_t load64(const char* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+
+static inline uint64_t load32(const char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+
+/* Most keys in a bucket are short suffixes, for which MurmurHash3's block
+ * loop and tail handling dominate. Keys of up to 16 bytes are read with two
+ * (possibly overlapping) fixed-size loads instead, and mixed with 64x64->128
+ * bit multiplications. */
+static uint32_t key_hash(const char* key, size_t len)
+{
+    uint64_t a, b;
+    if (len > 16) {
+        return hash(key, len);
+    }
+    else if (len >= 8) {
+        a = load64(key);
+        b = load64(key + len - 8);
+    }
+    else if (len >= 4) {
+        a = load32(key);
+        b = load32(key + len - 4);
+    }
+    else if (len > 0) {
+        const unsigned char* k = (const unsigned char*) key;
+        a = ((uint64_t) k[0] << 16) | ((uint64_t) k[len >> 1] << 8) | k[len - 1];
+        b = 0;
+    }
+    else {
+        a = b = 0;
+    }
+
+    uint64_t h = mum(a ^ 0xa0761d6478bd642full, b ^ 0xe7037ed1a0b428dbull);
+    h = mum(h ^ 0x8ebc6af09c88c6e3ull, len ^ 0x589965cc75374cc3ull);
+    return (uint32_t) (h ^ (h >> 32));
+}
+
+
+static int cmpkey(const void* a_, const void* b_)
+{
+    slot_t a = *(slot_t*) a_;
+    slot_t b = *(slot_t*) b_;
+
+    size_t ka = keylen(a), kb = keylen(b);
+
+    a += ka < 128 ? 1 : 2;
+    b += kb < 128 ? 1 : 2;
+
+    int c = memcmp(a, b, ka < kb ? ka : kb);
+    return c == 0 ? (int) ka - (int) kb : c;
+}
+
+
+static value_t* slot_val(slot_t s)
+{
+    size_t k = keylen(s);
+    return (value_t*) (s + (k < 128 ? 1 : 2) + k);
+}
+
+
+/* find the smallest and largest key starting with the given prefix in a single
+ * pass over the keys, instead of sorting them */
+static bool scan_range(const ahtable_t* T, const char* prefix, size_t len,
+                       slot_t* smin, size_t* min_slot, slot_t* smax, size_t* max_slot)
+{
+    slot_t s;
+    size_t j, k;
+    *smin = *smax = NULL;
+    for (j = 0; j < T->n; ++j) {
+        s = slot_keys(T, j);
+        while ((size_t) (s - slot_keys(T, j)) < T->slot_sizes[j]) {
+            k = keylen(s);
+            if (k >= len && memcmp(s + (k < 128 ? 1 : 2), prefix, len) == 0) {
+                if (*smin == NULL || cmpkey(&s, smin) < 0) {
+                    *smin = s;
+                    *min_slot = j;
+                }
+                if (*smax == NULL || cmpkey(&s, smax) > 0) {
+                    *smax = s;
+                    *max_slot = j;
+                }
+            }
+            s += keysize(k);
+        }
+    }
+    return *smin != NULL;
+}
+
+
+/* recompute the position of the smallest and largest key, after keys have
+ * moved */
+static void reset_range(ahtable_t* T)
+{
+    slot_t smin, smax;
+    T->min_slot = T->min_offset = 0;
+    T->max_slot = T->max_offset = 0;
+    if (scan_range(T, NULL, 0, &smin, &T->min_slot, &smax, &T->max_slot)) {
+        T->min_offset = (size_t) (smin - slot_keys(T, T->min_slot));
+        T->max_offset = (size_t) (smax - slot_keys(T, T->max_slot));
+    }
+}
+
+
+/* keep track of the smallest and largest key after inserting the key at the
+ * given position */
+static void update_range(ahtable_t* T, size_t i, size_t offset)
+{
+    slot_t s = slot_keys(T, i) + offset;
+    if (T->m == 1) {
+        T->min_slot = T->max_slot = i;
+        T->min_offset = T->max_offset = offset;
+        return;
+    }
+
+    slot_t min = slot_keys(T, T->min_slot) + T->min_offset;
+    slot_t max = slot_keys(T, T->max_slot) + T->max_offset;
+    if (cmpkey(&s, &min) < 0) {
+        T->min_slot = i;
+        T->min_offset = offset;
+    }
+    if (cmpkey(&s, &max) > 0) {
+        T->max_slot = i;
+        T->max_offset = offset;
+    }
+}
+
+
 ahtable_t* ahtable_create()
 {
     return ahtable_create_n(ahtable_initial_size);
@@ -48,6 +234,12 @@ ahtable_t* ahtable_create_n(size_t n)
     T->slot_sizes = malloc_or_die(n * sizeof(size_t));
     memset(T->slot_sizes, 0, n * sizeof(size_t));
 
+    T->slot_counts = malloc_or_die(n * sizeof(uint32_t));
+    memset(T->slot_counts, 0, n * sizeof(uint32_t));
+
+    T->min_slot = T->min_offset = 0;
+    T->max_slot = T->max_offset = 0;
+
     return T;
 }
 
@@ -59,6 +251,7 @@ void ahtable_free(ahtable_t* T)
     for (i = 0; i < T->n; ++i) free(T->slots[i]);
     free(T->slots);
     free(T->slot_sizes);
+    free(T->slot_counts);
     free(T);
 }
 
@@ -79,6 +272,14 @@ void ahtable_clear(ahtable_t* T)
 
     T->slot_sizes = realloc_or_die(T->slot_sizes, T->n * sizeof(size_t));
     memset(T->slot_sizes, 0, T->n * sizeof(size_t));
+
+    T->slot_counts = realloc_or_die(T->slot_counts, T->n * sizeof(uint32_t));
+    memset(T->slot_counts, 0, T->n * sizeof(uint32_t));
+
+    T->m = 0;
+    T->max_m = (size_t) (ahtable_max_load_factor * (double) T->n);
+    T->min_slot = T->min_offset = 0;
+    T->max_slot = T->max_offset = 0;
 }
 
 
@@ -119,15 +320,19 @@ static void ahtable_expand(ahtable_t* T)
     size_t new_n = 2 * T->n;
     size_t* slot_sizes = malloc_or_die(new_n * sizeof(size_t));
     memset(slot_sizes, 0, new_n * sizeof(size_t));
+    uint32_t* slot_counts = malloc_or_die(new_n * sizeof(uint32_t));
+    memset(slot_counts, 0, new_n * sizeof(uint32_t));
 
     const char* key;
     size_t len = 0;
     size_t m = 0;
+    uint32_t h;
     ahtable_iter_t* i = ahtable_iter_begin(T, false);
     while (!ahtable_iter_finished(i)) {
         key = ahtable_iter_key(i, &len);
-        slot_sizes[hash(key, len) % new_n] +=
-            len + sizeof(value_t) + (len >= 128 ? 2 : 1);
+        h = key_hash(key, len) % new_n;
+        slot_sizes[h] += keysize(len);
+        ++slot_counts[h];
 
         ++m;
         ahtable_iter_next(i);
@@ -141,7 +346,8 @@ static void ahtable_expand(ahtable_t* T)
     size_t j;
     for (j = 0; j < new_n; ++j) {
         if (slot_sizes[j] > 0) {
-            slots[j] = malloc_or_die(slot_sizes[j]);
+            slots[j] = malloc_or_die(tag_bytes(slot_counts[j]) + slot_sizes[j]);
+            memset(slots[j], 0, tag_bytes(slot_counts[j]));
         }
         else slots[j] = NULL;
     }
@@ -151,8 +357,12 @@ static void ahtable_expand(ahtable_t* T)
      * we keep track of the ends of every slot and simply insert keys.
      * */
     slot_t* slots_next = malloc_or_die(new_n * sizeof(slot_t));
-    memcpy(slots_next, slots, new_n * sizeof(slot_t));
-    size_t h;
+    uint32_t* tags_next = malloc_or_die(new_n * sizeof(uint32_t));
+    memset(tags_next, 0, new_n * sizeof(uint32_t));
+    for (j = 0; j < new_n; ++j) {
+        slots_next[j] = slots[j] + tag_bytes(slot_counts[j]);
+    }
+    uint32_t hk;
     m = 0;
     value_t* u;
     value_t* v;
@@ -160,8 +370,10 @@ static void ahtable_expand(ahtable_t* T)
     while (!ahtable_iter_finished(i)) {
 
         key = ahtable_iter_key(i, &len);
-        h = hash(key, len) % new_n;
+        hk = key_hash(key, len);
+        h = hk % new_n;
 
+        slots[h][tags_next[h]++] = key_tag(hk);
         slots_next[h] = ins_key(slots_next[h], key, len, &u);
         v = ahtable_iter_val(i);
         *u = *v;
@@ -173,6 +385,7 @@ static void ahtable_expand(ahtable_t* T)
     ahtable_iter_free(i);
 
 
+    free(tags_next);
     free(slots_next);
     for (j = 0; j < T->n; ++j) free(T->slots[j]);
 
@@ -182,8 +395,47 @@ static void ahtable_expand(ahtable_t* T)
     free(T->slot_sizes);
     T->slot_sizes = slot_sizes;
 
+    free(T->slot_counts);
+    T->slot_counts = slot_counts;
+
     T->n = new_n;
     T->max_m = (size_t) (ahtable_max_load_factor * (double) T->n);
+
+    /* key positions have changed */
+    reset_range(T);
+}
+
+
+/* Find a key in slot i, comparing only keys whose tag matches. Returns the
+ * key's position and sets pos to its index within the slot, or returns NULL.
+ */
+static slot_t find_key(const ahtable_t* T, size_t i, const char* key, size_t len,
+                       unsigned char tag, size_t* pos)
+{
+    const size_t count = T->slot_counts[i];
+    const unsigned char* tags = T->slots[i];
+    slot_t s = slot_keys(T, i);
+    size_t j = 0, block, c, k;
+    unsigned mask;
+
+    for (block = 0; block < count; block += TAG_BLOCK) {
+        mask = tag_mask(tags + block, count - block, tag);
+        while (mask) {
+            c = block + (size_t) __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            /* candidates are in ascending order, walk up to this one */
+            for (; j < c; ++j) s = next_key(s);
+
+            k = keylen(s);
+            if (k == len && memcmp(s + (k < 128 ? 1 : 2), key, len) == 0) {
+                *pos = j;
+                return s;
+            }
+        }
+    }
+
+    return NULL;
 }
 
 
@@ -195,49 +447,42 @@ static value_t* get_key(ahtable_t* T, const char* key, size_t len, bool insert_m
     }
 
 
-    uint32_t i = hash(key, len) % T->n;
-    size_t k;
+    uint32_t h = key_hash(key, len);
+    uint32_t i = h % T->n;
+    unsigned char tag = key_tag(h);
+    size_t pos;
     slot_t s;
     value_t* val;
 
     /* search the array for our key */
-    s = T->slots[i];
-    while ((size_t) (s - T->slots[i]) < T->slot_sizes[i]) {
-        /* get the key length */
-        k = keylen(s);
-        s += k < 128 ? 1 : 2;
-
-        /* skip keys that are longer than ours */
-        if (k != len) {
-            s += k + sizeof(value_t);
-            continue;
-        }
-
-        /* key found. */
-        if (memcmp(s, key, len) == 0) {
-            if (inserted != NULL) *inserted = false;
-            return (value_t*) (s + len);
-        }
-        /* key not found. */
-        else {
-            s += k + sizeof(value_t);
-            continue;
-        }
+    s = find_key(T, i, key, len, tag, &pos);
+    if (s != NULL) {
+        if (inserted != NULL) *inserted = false;
+        return slot_val(s);
     }
 
 
     if (insert_missing) {
         if (inserted != NULL) *inserted = true;
         /* the key was not found, so we must insert it. */
-        size_t new_size = T->slot_sizes[i];
-        new_size += 1 + (len >= 128 ? 1 : 0);    // key length
-        new_size += len * sizeof(unsigned char); // key
-        new_size += sizeof(value_t);             // value
+        size_t count    = T->slot_counts[i];
+        size_t old_tags = tag_bytes(count);
+        size_t new_tags = tag_bytes(count + 1);
+        size_t new_size = T->slot_sizes[i] + keysize(len);
 
-        T->slots[i] = realloc_or_die(T->slots[i], new_size);
+        T->slots[i] = realloc_or_die(T->slots[i], new_tags + new_size);
+
+        /* make room for another block of tags */
+        if (new_tags != old_tags) {
+            memmove(T->slots[i] + new_tags, T->slots[i] + old_tags, T->slot_sizes[i]);
+            memset(T->slots[i] + old_tags, 0, new_tags - old_tags);
+        }
+        T->slots[i][count] = tag;
+        T->slot_counts[i] = (uint32_t) (count + 1);
 
         ++T->m;
-        ins_key(T->slots[i] + T->slot_sizes[i], key, len, &val);
+        ins_key(slot_keys(T, i) + T->slot_sizes[i], key, len, &val);
+        update_range(T, i, T->slot_sizes[i]);
         T->slot_sizes[i] = new_size;
 
         return val;
@@ -260,58 +505,56 @@ value_t* ahtable_tryget(ahtable_t* T, const char* key, size_t len )
 
 int ahtable_del(ahtable_t* T, const char* key, size_t len)
 {
-    uint32_t i = hash(key, len) % T->n;
-    size_t k;
-    slot_t s;
+    uint32_t h = key_hash(key, len);
+    uint32_t i = h % T->n;
+    size_t pos;
 
     /* search the array for our key */
-    s = T->slots[i];
-    while ((size_t) (s - T->slots[i]) < T->slot_sizes[i]) {
-        /* get the key length */
-        k = keylen(s);
-        s += k < 128 ? 1 : 2;
-
-        /* skip keys that are longer than ours */
-        if (k != len) {
-            s += k + sizeof(value_t);
-            continue;
-        }
+    slot_t s = find_key(T, i, key, len, key_tag(h), &pos);
+    if (s == NULL) {
+        // Key was not found. Do nothing.
+        return -1;
+    }
 
-        /* key found. */
-        if (memcmp(s, key, len) == 0) {
-            /* move everything over, resize the array */
-            unsigned char* t = s + len + sizeof(value_t);
-            s -= k < 128 ? 1 : 2;
-            memmove(s, t, T->slot_sizes[i] - (size_t) (t - T->slots[i]));
-            T->slot_sizes[i] -= (size_t) (t - s);
-            --T->m;
-            return 0;
-        }
-        /* key not found. */
-        else {
-            s += k + sizeof(value_t);
-            continue;
-        }
+    /* move everything over, resize the array */
+    slot_t t = next_key(s);
+    memmove(s, t, T->slot_sizes[i] - (size_t) (t - slot_keys(T, i)));
+    T->slot_sizes[i] -= (size_t) (t - s);
+
+    size_t count = T->slot_counts[i];
+    memmove(T->slots[i] + pos, T->slots[i] + pos + 1, count - pos - 1);
+    T->slot_counts[i] = (uint32_t) (count - 1);
+    if (tag_bytes(count - 1) != tag_bytes(count)) {
+        memmove(T->slots[i] + tag_bytes(count - 1), T->slots[i] + tag_bytes(count), T->slot_sizes[i]);
     }
+    --T->m;
 
-    // Key was not found. Do nothing.
-    return -1;
+    /* keys behind the deleted one have moved, and it may have been the
+     * smallest or largest key */
+    if (i == T->min_slot || i == T->max_slot) reset_range(T);
+    return 0;
 }
 
 
 
-static int cmpkey(const void* a_, const void* b_)
+bool ahtable_prefix_range(const ahtable_t* T, const char* prefix, size_t len,
+                          value_t** min, value_t** max)
 {
-    slot_t a = *(slot_t*) a_;
-    slot_t b = *(slot_t*) b_;
+    if (T->m == 0) return false;
 
-    size_t ka = keylen(a), kb = keylen(b);
+    if (len == 0) {
+        *min = slot_val(slot_keys(T, T->min_slot) + T->min_offset);
+        *max = slot_val(slot_keys(T, T->max_slot) + T->max_offset);
+        return true;
+    }
 
-    a += ka < 128 ? 1 : 2;
-    b += kb < 128 ? 1 : 2;
+    slot_t smin, smax;
+    size_t min_slot, max_slot;
+    if (!scan_range(T, prefix, len, &smin, &min_slot, &smax, &max_slot)) return false;
 
-    int c = memcmp(a, b, ka < kb ? ka : kb);
-    return c == 0 ? (int) ka - (int) kb : c;
+    *min = slot_val(smin);
+    *max = slot_val(smax);
+    return true;
 }
 
 
@@ -336,8 +579,8 @@ static ahtable_sorted_iter_t* ahtable_sorted_iter_begin(const ahtable_t* T)
     slot_t s;
     size_t j, k, u;
     for (j = 0, u = 0; j < T->n; ++j) {
-        s = T->slots[j];
-        while (s < T->slots[j] + T->slot_sizes[j]) {
+        s = slot_keys(T, j);
+        while (s < slot_keys(T, j) + T->slot_sizes[j]) {
             i->xs[u++] = s;
             k = keylen(s);
             s += k < 128 ? 1 : 2;
@@ -411,8 +654,8 @@ static ahtable_unsorted_iter_t* ahtable_unsorted_iter_begin(const ahtable_t* T)
     i->T = T;
 
     for (i->i = 0; i->i < i->T->n; ++i->i) {
-        i->s = T->slots[i->i];
-        if ((size_t) (i->s - T->slots[i->i]) >= T->slot_sizes[i->i]) continue;
+        i->s = slot_keys(T, i->i);
+        if ((size_t) (i->s - slot_keys(T, i->i)) >= T->slot_sizes[i->i]) continue;
         break;
     }
 
@@ -437,13 +680,13 @@ static void ahtable_unsorted_iter_next(ahtable_unsorted_iter_t* i)
     /* skip to the next key */
     i->s += k + sizeof(value_t);
 
-    if ((size_t) (i->s - i->T->slots[i->i]) >= i->T->slot_sizes[i->i]) {
+    if ((size_t) (i->s - slot_keys(i->T, i->i)) >= i->T->slot_sizes[i->i]) {
         do {
             ++i->i;
         } while(i->i < i->T->n &&
                 i->T->slot_sizes[i->i] == 0);
 
-        if (i->i < i->T->n) i->s = i->T->slots[i->i];
+        if (i->i < i->T->n) i->s = slot_keys(i->T, i->i);
         else i->s = NULL;
     }
 }
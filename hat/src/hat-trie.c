@@ -462,6 +462,77 @@ void hattrie_walk (hattrie_t* T, const char* key, size_t len, void* user_data, h
 }
 
 
+/* value of the smallest key below node, NULL if there is none */
+static value_t* hattrie_node_min(node_ptr node)
+{
+  value_t* min;
+  value_t* max;
+
+  if (!(*node.flag & NODE_TYPE_TRIE)) {
+    return ahtable_prefix_range(node.b, NULL, 0, &min, &max) ? min : NULL;
+  }
+
+  /* the key consumed on this node precedes all keys below it */
+  if (node.t->flag & NODE_HAS_VAL) return &node.t->val;
+
+  size_t i;
+  for (i = 0; i < NODE_CHILDS; ++i) {
+    if (i > 0 && node.t->xs[i].t == node.t->xs[i - 1].t) continue;
+    if ((min = hattrie_node_min(node.t->xs[i])) != NULL) return min;
+  }
+  return NULL;
+}
+
+
+/* value of the largest key below node, NULL if there is none */
+static value_t* hattrie_node_max(node_ptr node)
+{
+  value_t* min;
+  value_t* max;
+
+  if (!(*node.flag & NODE_TYPE_TRIE)) {
+    return ahtable_prefix_range(node.b, NULL, 0, &min, &max) ? max : NULL;
+  }
+
+  int i;
+  for (i = NODE_MAXCHAR; i >= 0; --i) {
+    if (i < NODE_MAXCHAR && node.t->xs[i].t == node.t->xs[i + 1].t) continue;
+    if ((max = hattrie_node_max(node.t->xs[i])) != NULL) return max;
+  }
+
+  if (node.t->flag & NODE_HAS_VAL) return &node.t->val;
+  return NULL;
+}
+
+
+bool hattrie_prefix_range(const hattrie_t* T, const char* prefix, size_t len, value_t** min, value_t** max)
+{
+  node_ptr node = T->root;
+  const char* k = prefix;
+
+  /* follow the prefix until it is consumed or a bucket is reached */
+  while (len > 0 && *node.flag & NODE_TYPE_TRIE) {
+    node = node.t->xs[(unsigned char) *k];
+    ++k;
+    --len;
+  }
+
+  if (*node.flag & NODE_TYPE_TRIE) {
+    *min = hattrie_node_min(node);
+    *max = hattrie_node_max(node);
+    return *min != NULL;
+  }
+
+  /* hybrid buckets store the character that led to them */
+  if (*node.flag & NODE_TYPE_HYBRID_BUCKET) {
+    --k;
+    ++len;
+  }
+
+  return ahtable_prefix_range(node.b, k, len, min, max);
+}
+
+
 int hattrie_del(hattrie_t* T, const char* key, size_t len)
 {
   node_ptr parent = T->root;
@@ -1,8 +1,12 @@
 #include "ARTBase.hpp"
+#include "Exception.hpp"
+#include "FrozenART.hpp"
+#include "NodeSearch.hpp"
 
+#include <algorithm>
 #include <cstdlib>    // malloc, free
 #include <cstring>    // memset, memcpy
-#include <emmintrin.h> // x86 SSE intrinsics
+#include <new>        // placement new
 #undef NDEBUG
 #include <cassert>
 
@@ -18,7 +22,11 @@
 
 using namespace std;
 
-ARTBase::ARTBase(LeafStore* store) : tree(NULL), leafStore(store) {
+ARTBase::ARTBase(LeafStore* store, bool hugePages) : tree(NULL), leafStore(store), arena(hugePages) {
+}
+
+ARTBase::ARTBase(ARTBase&& other) : tree(other.tree), leafStore(other.leafStore), arena(std::move(other.arena)) {
+  other.tree = NULL;
 }
 
 ARTBase::~ARTBase() {
@@ -43,27 +51,21 @@ uint8_t flipSign(uint8_t keyByte) {
 }
 
 
-void ARTBase::Node::print(uint32_t indent) {
-  cout << ind(indent) << "Children: " << count << endl;
-  cout << ind(indent) << "Prefix: " << string(reinterpret_cast<char*>(prefix), min(prefixLength, 9 /* ARTBase::maxPrefixLength */)) << endl;
-}
-
 // Node with up to 4 children
 struct ARTBase::Node4 : Node {
   uint8_t key[4];
   Node* child[4];
 
   Node4() : Node(NodeType4) {
+    static_assert(sizeof(Node4)==48, "Node4 should take 48 bytes");
     memset(key,0,sizeof(key));
     memset(child,0,sizeof(child));
   }
 
-  void print(uint32_t indent);
+  void printChildren(uint32_t indent);
 };
 
-void ARTBase::Node4::print(uint32_t indent) {
-  Node::print(indent);
-
+void ARTBase::Node4::printChildren(uint32_t indent) {
   for (size_t i = 0; i < count; i++) {
     cout << ind(indent) << "Key byte: " << (char)key[i] << endl;
     printChild(child[i], indent);
@@ -80,12 +82,10 @@ struct ARTBase::Node16 : Node {
     memset(child,0,sizeof(child));
   }
 
-  void print(uint32_t indent);
+  void printChildren(uint32_t indent);
 };
 
-void ARTBase::Node16::print(uint32_t indent) {
-  Node::print(indent);
-
+void ARTBase::Node16::printChildren(uint32_t indent) {
   for (size_t i = 0; i < count; i++) {
     cout << ind(indent) << "Key byte: " << (char)flipSign(key[i]) << endl;
     printChild(child[i], indent);
@@ -94,7 +94,7 @@ void ARTBase::Node16::print(uint32_t indent) {
 
 static const uint8_t emptyMarker=48;
 
-// Node with up to 48 childreconst n
+// Node with up to 48 children
 struct ARTBase::Node48 : Node {
   uint8_t childIndex[256];
   Node* child[48];
@@ -104,12 +104,10 @@ struct ARTBase::Node48 : Node {
     memset(child,0,sizeof(child));
   }
 
-  void print(uint32_t indent);
+  void printChildren(uint32_t indent);
 };
 
-void ARTBase::Node48::print(uint32_t indent) {
-  Node::print(indent);
-
+void ARTBase::Node48::printChildren(uint32_t indent) {
   for (uint16_t i = 0; i < 256; i++) {
     if (childIndex[i] == emptyMarker) continue;
     cout << ind(indent) << "Key byte: " << (char)i << endl;
@@ -126,12 +124,10 @@ struct ARTBase::Node256 : Node {
     memset(child,0,sizeof(child));
   }
 
-  void print(uint32_t indent);
+  void printChildren(uint32_t indent);
 };
 
-void ARTBase::Node256::print(uint32_t indent) {
-  Node::print(indent);
-
+void ARTBase::Node256::printChildren(uint32_t indent) {
   for (uint16_t i = 0; i < 256; i++) {
     if (!child[i]) continue;
     cout << ind(indent) << "Key byte: " << (char)i << endl;
@@ -139,54 +135,51 @@ void ARTBase::Node256::print(uint32_t indent) {
   }
 }
 
-inline ARTBase::Node* ARTBase::makeLeaf(uintptr_t tid) const {
-  // Create a pseudo-leaf
-  return reinterpret_cast<Node*>((tid<<1)|1);
+static_assert(sizeof(ARTBase::Node)==12, "Node header should take 12 bytes");
+
+void ARTBase::Node::print(uint32_t indent) {
+  cout << ind(indent) << "Children: " << count << endl;
+  cout << ind(indent) << "Prefix: " << string(reinterpret_cast<char*>(prefix), min(prefixLength, maxPrefixLength)) << endl;
+
+  switch (type) {
+    case NodeType4: static_cast<Node4*>(this)->printChildren(indent); break;
+    case NodeType16: static_cast<Node16*>(this)->printChildren(indent); break;
+    case NodeType48: static_cast<Node48*>(this)->printChildren(indent); break;
+    case NodeType256: static_cast<Node256*>(this)->printChildren(indent); break;
+  }
 }
 
-uintptr_t ARTBase::getLeafValue(Node* node) {
-  // The the value stored in the pseudo-leaf
-  return reinterpret_cast<uintptr_t>(node)>>1;
+template<class TNode>
+TNode* ARTBase::allocateNode() {
+  return new (arena.allocate(sizeof(TNode))) TNode();
 }
 
-bool ARTBase::isLeaf(Node* node) {
-  // Is the node a leaf?
-  return reinterpret_cast<uintptr_t>(node)&1;
+template<class TNode>
+void ARTBase::freeNode(TNode* node) {
+  node->~TNode();
+  arena.deallocate(node, sizeof(TNode));
 }
 
+const unsigned ARTBase::maxPrefixLength;
+
 // This address is used to communicate that search failed
 ARTBase::Node* ARTBase::nullNode=NULL;
 
-static inline unsigned ctz(uint16_t x) {
-  // Count trailing zeros, only defined for x>0
-#ifdef __GNUC__
-  return static_cast<unsigned>(__builtin_ctz(x));
-#else
-  // Adapted from Hacker's Delight
-  unsigned n=1;
-  if ((x&0xFF)==0) {n+=8; x=x>>8;}
-  if ((x&0x0F)==0) {n+=4; x=x>>4;}
-  if ((x&0x03)==0) {n+=2; x=x>>2;}
-  return n-(x&1);
-#endif
-}
-
 ARTBase::Node** ARTBase::findChild(Node* n,uint8_t keyByte) const {
   // Find the next child for the keyByte
   switch (n->type) {
     case NodeType4: {
                       Node4* node=static_cast<Node4*>(n);
-                      for (unsigned i=0;i<node->count;i++)
-                        if (node->key[i]==keyByte)
-                          return &node->child[i];
-                      return &nullNode;
+                      unsigned pos=nodesearch::find4(node->key,node->count,keyByte);
+                      if (pos<node->count)
+                        return &node->child[pos]; else
+                          return &nullNode;
                     }
     case NodeType16: {
                        Node16* node=static_cast<Node16*>(n);
-                       __m128i cmp=_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(flipSign(keyByte))),_mm_loadu_si128(reinterpret_cast<__m128i*>(node->key)));
-                       unsigned bitfield=_mm_movemask_epi8(cmp)&((1<<node->count)-1);
-                       if (bitfield)
-                         return &node->child[ctz(static_cast<uint16_t>(bitfield))]; else
+                       unsigned pos=nodesearch::find16(node->key,node->count,flipSign(keyByte));
+                       if (pos<node->count)
+                         return &node->child[pos]; else
                            return &nullNode;
                      }
     case NodeType48: {
@@ -222,9 +215,7 @@ ARTBase::Node* ARTBase::minimum(ARTBase::Node* node) const {
                      }
     case NodeType48: {
                        Node48* n=static_cast<Node48*>(node);
-                       unsigned pos=0;
-                       while (n->childIndex[pos]==emptyMarker)
-                         pos++;
+                       unsigned pos=nodesearch::nextOccupied(n->childIndex,0,emptyMarker);
                        return minimum(n->child[n->childIndex[pos]]);
                      }
     case NodeType256: {
@@ -257,9 +248,7 @@ ARTBase::Node* ARTBase::lastChild(ARTBase::Node* node) const {
                      }
     case NodeType48: {
                        Node48* n=static_cast<Node48*>(node);
-                       unsigned pos=255;
-                       while (n->childIndex[pos]==emptyMarker)
-                         pos--;
+                       unsigned pos=nodesearch::previousOccupied(n->childIndex,256,emptyMarker);
                        return (n->child[n->childIndex[pos]]);
                      }
     case NodeType256: {
@@ -292,9 +281,7 @@ ARTBase::Node* ARTBase::maximum(ARTBase::Node* node) const {
                      }
     case NodeType48: {
                        Node48* n=static_cast<Node48*>(node);
-                       unsigned pos=255;
-                       while (n->childIndex[pos]==emptyMarker)
-                         pos--;
+                       unsigned pos=nodesearch::previousOccupied(n->childIndex,256,emptyMarker);
                        return maximum(n->child[n->childIndex[pos]]);
                      }
     case NodeType256: {
@@ -308,105 +295,6 @@ ARTBase::Node* ARTBase::maximum(ARTBase::Node* node) const {
   throw; // Unreachable
 }
 
-bool ARTBase::leafMatches(Node* leaf,uint8_t key[],unsigned keyLength,unsigned depth) const {
-  // Check if the key of the leaf is equal to the searched key
-  if (depth!=keyLength) {
-    uint8_t leafKey[keyLength];
-    loadKey(getLeafValue(leaf), leafKey, keyLength);
-    for (unsigned i=depth;i<keyLength;i++)
-      if (leafKey[i]!=key[i])
-        return false;
-  }
-  return true;
-}
-
-unsigned ARTBase::prefixMismatch(Node* node,uint8_t key[],unsigned depth, unsigned keyLength) const {
-  // Compare the key with the prefix of the node, return the number matching bytes
-  unsigned pos;
-  if (node->prefixLength>maxPrefixLength) {
-    for (pos=0;pos<maxPrefixLength;pos++)
-      if (key[depth+pos]!=node->prefix[pos])
-        return pos;
-    uint8_t minKey[keyLength];
-    loadKey(getLeafValue(minimum(node)), minKey, keyLength);
-    for (;pos<node->prefixLength;pos++)
-      if (key[depth+pos]!=minKey[depth+pos])
-        return pos;
-  } else {
-    for (pos=0;pos<node->prefixLength;pos++)
-      if (key[depth+pos]!=node->prefix[pos])
-        return pos;
-  }
-  return pos;
-}
-
-ARTBase::Node* ARTBase::lookupValue(ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
-  // Find the node with a matching key, optimistic version
-
-  bool skippedPrefix=false; // Did we optimistically skip some prefix without checking it?
-
-  while (node!=NULL) {
-    if (isLeaf(node)) {
-      if (!skippedPrefix&&depth==keyLength) // No check required
-        return node;
-
-      if (depth!=keyLength) {
-        // Check leaf
-        uint8_t leafKey[keyLength];
-        loadKey(getLeafValue(node), leafKey, keyLength);
-        for (unsigned i=(skippedPrefix?0:depth);i<keyLength;i++)
-          if (leafKey[i]!=key[i])
-            return NULL;
-      }
-      return node;
-    }
-
-    if (node->prefixLength) {
-      if (node->prefixLength<maxPrefixLength) {
-        for (unsigned pos=0;pos<node->prefixLength;pos++)
-          if (key[depth+pos]!=node->prefix[pos])
-            return NULL;
-      } else
-        skippedPrefix=true;
-      depth+=node->prefixLength;
-    }
-
-    node=*findChild(node,key[depth]);
-    depth++;
-  }
-
-  return NULL;
-}
-
-ARTBase::Node* ARTBase::lookupPrefix(ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
-  // Find the node with a matching prefix
-
-  while (node!=NULL) {
-    if (isLeaf(node)) {
-      if (keyLength == depth) {
-        return node;
-      }
-      return NULL;
-    }
-
-    unsigned matchingChars = prefixMismatch(node, key, depth, keyLength);
-    if (matchingChars == keyLength) {
-      // Return inner node
-      return node;
-    }
-    else if (matchingChars != node->prefixLength) {
-      return NULL;
-    }
-
-    depth+=node->prefixLength;
-
-    node=*findChild(node,key[depth]);
-    depth++;
-  }
-
-  return NULL;
-}
-
 ARTBase::Node* ARTBase::secondChild(ARTBase::Node* node) const {
   assert(node->count > 1);
   Node* child;
@@ -425,10 +313,8 @@ ARTBase::Node* ARTBase::secondChild(ARTBase::Node* node) const {
     case NodeType48:
                     {
                       Node48* n = static_cast<Node48*>(node);
-                      unsigned i = 47;
-                      while (n->childIndex[i]==emptyMarker) i--;
-                      i--;
-                      while (n->childIndex[i]==emptyMarker) i--;
+                      unsigned i = nodesearch::previousOccupied(n->childIndex, 256, emptyMarker);
+                      i = nodesearch::previousOccupied(n->childIndex, i, emptyMarker);
                       child = n->child[n->childIndex[i]];
                       break;
                     }
@@ -448,142 +334,23 @@ ARTBase::Node* ARTBase::secondChild(ARTBase::Node* node) const {
   return maximum(child);
 }
 
-ARTBase::Node* ARTBase::sartLookupValue(ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
-  //std::cout << "lookup" << std::endl;
-
-  while (node != NULL) {
-    if (isLeaf(node)) {
-      return node;
-    }
-
-    unsigned mismatchPos = prefixMismatch(node, key, depth, keyLength);
-    if (mismatchPos != node->prefixLength) {
-      return minimum(node);
-    }
-
-    if (keyLength == depth+node->prefixLength) {
-      return minimum(node);
-    }
-
-    depth += node->prefixLength;
-
-    Node** child = findChild(node, key[depth]);
-    if (child != NULL && *child) {
-      node = *child;
-      depth++;
-      continue;
-    }
-
-    assert(node != NULL);
-    child = greaterThan(node, key[depth]);
-    if (child == NULL || !(*child)) {
-      return maximum(*lowerThan(node, key[depth]));
-    }
-    return minimum(*child);
-  }
-
-  return NULL;
-}
-
-ARTBase::Node* ARTBase::lookupValuePessimistic(ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
-  // Find the node with a matching key, alternative pessimistic version
-
-  while (node!=NULL) {
-    if (isLeaf(node)) {
-      if (leafMatches(node,key,keyLength,depth))
-        return node;
-      return NULL;
-    }
-
-    if (prefixMismatch(node,key,depth,keyLength)!=node->prefixLength)
-      return NULL; else
-        depth+=node->prefixLength;
-
-    node=*findChild(node,key[depth]);
-    depth++;
-  }
-
-  return NULL;
-}
-
 void ARTBase::copyPrefix(ARTBase::Node* src,ARTBase::Node* dst) const {
   // Helper function that copies the prefix from the source to the destination node
   dst->prefixLength=src->prefixLength;
   memcpy(dst->prefix,src->prefix,min(src->prefixLength,maxPrefixLength));
 }
 
-void ARTBase::insertValue(Node* node,Node** nodeRef,uint8_t key[],unsigned depth,uintptr_t value, unsigned maxKeyLength) {
-  // Insert the leaf value into the tree
-
-  if (node==NULL) {
-    *nodeRef=makeLeaf(value);
-    return;
-  }
-
-  if (isLeaf(node)) {
-    // Replace leaf with Node4 and store both leaves in it
-    uint8_t existingKey[maxKeyLength];
-    loadKey(getLeafValue(node), existingKey, maxKeyLength);
-#ifdef DEBUG
-    assert(existingKey != nullptr);
-#endif
-    unsigned newPrefixLength=0;
-    while (true) {
-      if (existingKey[depth+newPrefixLength]!=key[depth+newPrefixLength]) break;
-      newPrefixLength++;
-    }
-
-    Node4* newNode=new Node4();
-    newNode->prefixLength=newPrefixLength;
-    memcpy(newNode->prefix,key+depth,min(newPrefixLength,maxPrefixLength));
-    *nodeRef=newNode;
-
-    insertNode4(newNode,nodeRef,existingKey[depth+newPrefixLength],node);
-    insertNode4(newNode,nodeRef,key[depth+newPrefixLength],makeLeaf(value));
-    return;
-  }
-
-  // Handle prefix of inner node
-  if (node->prefixLength) {
-    unsigned mismatchPos=prefixMismatch(node,key,depth,maxKeyLength);
-    if (mismatchPos!=node->prefixLength) {
-      // Prefix differs, create new node
-      Node4* newNode=new Node4();
-      *nodeRef=newNode;
-      newNode->prefixLength=mismatchPos;
-      memcpy(newNode->prefix,node->prefix,min(mismatchPos,maxPrefixLength));
-      // Break up prefix
-      if (node->prefixLength<maxPrefixLength) {
-        insertNode4(newNode,nodeRef,node->prefix[mismatchPos],node);
-        node->prefixLength-=(mismatchPos+1);
-        memmove(node->prefix,node->prefix+mismatchPos+1,min(node->prefixLength,maxPrefixLength));
-      } else {
-        node->prefixLength-=(mismatchPos+1);
-        uint8_t minKey[maxKeyLength];
-        loadKey(getLeafValue(minimum(node)), minKey, maxKeyLength);
-        insertNode4(newNode,nodeRef,minKey[depth+mismatchPos],node);
-        memmove(node->prefix,minKey+depth+mismatchPos+1,min(node->prefixLength,maxPrefixLength));
-      }
-      insertNode4(newNode,nodeRef,key[depth+mismatchPos],makeLeaf(value));
-      return;
-    }
-    depth+=node->prefixLength;
-  }
-
-  // Recurse
-  Node** child=findChild(node,key[depth]);
-  if (*child) {
-    insertValue(*child,child,key,depth+1,value,maxKeyLength);
-    return;
-  }
+ARTBase::Node* ARTBase::makeNode4() {
+  return allocateNode<Node4>();
+}
 
-  // Insert leaf into inner node
-  Node* newNode=makeLeaf(value);
+void ARTBase::insertChild(Node* node,Node** nodeRef,uint8_t keyByte,Node* child) {
+  // Insert the child into an inner node of any type
   switch (node->type) {
-    case NodeType4: insertNode4(static_cast<Node4*>(node),nodeRef,key[depth],newNode); break;
-    case NodeType16: insertNode16(static_cast<Node16*>(node),nodeRef,key[depth],newNode); break;
-    case NodeType48: insertNode48(static_cast<Node48*>(node),nodeRef,key[depth],newNode); break;
-    case NodeType256: insertNode256(static_cast<Node256*>(node),key[depth],newNode); break;
+    case NodeType4: insertNode4(static_cast<Node4*>(node),nodeRef,keyByte,child); break;
+    case NodeType16: insertNode16(static_cast<Node16*>(node),nodeRef,keyByte,child); break;
+    case NodeType48: insertNode48(static_cast<Node48*>(node),nodeRef,keyByte,child); break;
+    case NodeType256: insertNode256(static_cast<Node256*>(node),keyByte,child); break;
   }
 }
 
@@ -600,14 +367,14 @@ void ARTBase::insertNode4(Node4* node,Node** nodeRef,uint8_t keyByte,Node* child
     node->count++;
   } else {
     // Grow to Node16
-    Node16* newNode=new Node16();
+    Node16* newNode=allocateNode<Node16>();
     *nodeRef=newNode;
     newNode->count=4;
     copyPrefix(node,newNode);
     for (unsigned i=0;i<4;i++)
       newNode->key[i]=flipSign(node->key[i]);
     memcpy(newNode->child,node->child,node->count*sizeof(uintptr_t));
-    delete node;
+    freeNode(node);
     return insertNode16(newNode,nodeRef,keyByte,child);
   }
 }
@@ -617,9 +384,7 @@ void ARTBase::insertNode16(Node16* node,Node** nodeRef,uint8_t keyByte,Node* chi
   if (node->count<16) {
     // Insert element
     uint8_t keyByteFlipped=flipSign(keyByte);
-    __m128i cmp=_mm_cmplt_epi8(_mm_set1_epi8(static_cast<char>(keyByteFlipped)),_mm_loadu_si128(reinterpret_cast<__m128i*>(node->key)));
-    uint16_t bitfield=_mm_movemask_epi8(cmp)&(0xFFFF>>(16-node->count));
-    unsigned pos=bitfield?ctz(bitfield):node->count;
+    unsigned pos=nodesearch::greater16(node->key,node->count,keyByteFlipped);
     memmove(node->key+pos+1,node->key+pos,node->count-pos);
     memmove(node->child+pos+1,node->child+pos,(node->count-pos)*sizeof(uintptr_t));
     node->key[pos]=keyByteFlipped;
@@ -627,14 +392,14 @@ void ARTBase::insertNode16(Node16* node,Node** nodeRef,uint8_t keyByte,Node* chi
     node->count++;
   } else {
     // Grow to Node48
-    Node48* newNode=new Node48();
+    Node48* newNode=allocateNode<Node48>();
     *nodeRef=newNode;
     memcpy(newNode->child,node->child,node->count*sizeof(uintptr_t));
     for (uint8_t i=0;i<node->count;i++)
       newNode->childIndex[flipSign(node->key[i])]=i;
     copyPrefix(node,newNode);
     newNode->count=node->count;
-    delete node;
+    freeNode(node);
     return insertNode48(newNode,nodeRef,keyByte,child);
   }
 }
@@ -651,14 +416,14 @@ void ARTBase::insertNode48(Node48* node,Node** nodeRef,uint8_t keyByte,Node* chi
     node->count++;
   } else {
     // Grow to Node256
-    Node256* newNode=new Node256();
+    Node256* newNode=allocateNode<Node256>();
     for (unsigned i=0;i<256;i++)
       if (node->childIndex[i]!=48)
         newNode->child[i]=node->child[node->childIndex[i]];
     newNode->count=node->count;
     copyPrefix(node,newNode);
     *nodeRef=newNode;
-    delete node;
+    freeNode(node);
     return insertNode256(newNode,keyByte,child);
   }
 }
@@ -669,38 +434,13 @@ void ARTBase::insertNode256(Node256* node,uint8_t keyByte,Node* child) {
   node->child[keyByte]=child;
 }
 
-void ARTBase::erase(Node* node,Node** nodeRef,uint8_t key[],unsigned keyLength,unsigned depth, unsigned maxKeyLength) {
-  // Delete a leaf from a tree
-
-  if (!node)
-    return;
-
-  if (isLeaf(node)) {
-    // Make sure we have the right leaf
-    if (leafMatches(node,key,keyLength,depth))
-      *nodeRef=NULL;
-    return;
-  }
-
-  // Handle prefix
-  if (node->prefixLength) {
-    if (prefixMismatch(node,key,depth,maxKeyLength)!=node->prefixLength)
-      return;
-    depth+=node->prefixLength;
-  }
-
-  Node** child=findChild(node,key[depth]);
-  if (isLeaf(*child)&&leafMatches(*child,key,keyLength,depth)) {
-    // Leaf found, delete it in inner node
-    switch (node->type) {
-      case NodeType4: eraseNode4(static_cast<Node4*>(node),nodeRef,child); break;
-      case NodeType16: eraseNode16(static_cast<Node16*>(node),nodeRef,child); break;
-      case NodeType48: eraseNode48(static_cast<Node48*>(node),nodeRef,key[depth]); break;
-      case NodeType256: eraseNode256(static_cast<Node256*>(node),nodeRef,key[depth]); break;
-    }
-  } else {
-    //Recurse
-    erase(*child,child,key,keyLength,depth+1,maxKeyLength);
+void ARTBase::eraseChild(Node* node,Node** nodeRef,Node** leafPlace,uint8_t keyByte) {
+  // Delete the leaf from an inner node of any type
+  switch (node->type) {
+    case NodeType4: eraseNode4(static_cast<Node4*>(node),nodeRef,leafPlace); break;
+    case NodeType16: eraseNode16(static_cast<Node16*>(node),nodeRef,leafPlace); break;
+    case NodeType48: eraseNode48(static_cast<Node48*>(node),nodeRef,keyByte); break;
+    case NodeType256: eraseNode256(static_cast<Node256*>(node),nodeRef,keyByte); break;
   }
 }
 
@@ -731,7 +471,7 @@ void ARTBase::eraseNode4(Node4* node,Node** nodeRef,Node** leafPlace) {
       child->prefixLength+=node->prefixLength+1;
     }
     *nodeRef=child;
-    delete node;
+    freeNode(node);
   }
 }
 
@@ -744,14 +484,14 @@ void ARTBase::eraseNode16(Node16* node,Node** nodeRef,Node** leafPlace) {
 
   if (node->count==3) {
     // Shrink to Node4
-    Node4* newNode=new Node4();
+    Node4* newNode=allocateNode<Node4>();
     newNode->count=4;
     copyPrefix(node,newNode);
     for (unsigned i=0;i<4;i++)
       newNode->key[i]=flipSign(node->key[i]);
     memcpy(newNode->child,node->child,sizeof(uintptr_t)*4);
     *nodeRef=newNode;
-    delete node;
+    freeNode(node);
   }
 }
 
@@ -763,7 +503,7 @@ void ARTBase::eraseNode48(Node48* node,Node** nodeRef,uint8_t keyByte) {
 
   if (node->count==12) {
     // Shrink to Node16
-    Node16 *newNode=new Node16();
+    Node16 *newNode=allocateNode<Node16>();
     *nodeRef=newNode;
     copyPrefix(node,newNode);
     for (uint8_t b=0;b<=255;b++) {
@@ -773,7 +513,7 @@ void ARTBase::eraseNode48(Node48* node,Node** nodeRef,uint8_t keyByte) {
         newNode->count++;
       }
     }
-    delete node;
+    freeNode(node);
   }
 }
 
@@ -784,7 +524,7 @@ void ARTBase::eraseNode256(Node256* node,Node** nodeRef,uint8_t keyByte) {
 
   if (node->count==37) {
     // Shrink to Node48
-    Node48 *newNode=new Node48();
+    Node48 *newNode=allocateNode<Node48>();
     *nodeRef=newNode;
     copyPrefix(node,newNode);
     for (uint8_t b=0;b<=255;b++) {
@@ -794,7 +534,7 @@ void ARTBase::eraseNode256(Node256* node,Node** nodeRef,uint8_t keyByte) {
         newNode->count++;
       }
     }
-    delete node;
+    freeNode(node);
   }
 }
 
@@ -812,19 +552,17 @@ ARTBase::Node** ARTBase::greaterThan(Node* n,uint8_t keyByte) const {
                     }
     case NodeType16: {
                        Node16* node=static_cast<Node16*>(n);
-                       for (int i=0;i<node->count;i++) {
-                         if (keyByte<flipSign(node->key[i])) {
-                           return &node->child[i];
-                         }
+                       unsigned pos=nodesearch::greater16(node->key,node->count,flipSign(keyByte));
+                       if (pos<node->count) {
+                         return &node->child[pos];
                        }
                        return &nullNode;
                      }
     case NodeType48: {
                        Node48* node=static_cast<Node48*>(n);
-                       for (int i=keyByte+1;i<256;i++) {
-                         if (node->childIndex[i]!=emptyMarker) {
-                           return &node->child[node->childIndex[i]];
-                         }
+                       unsigned pos=nodesearch::nextOccupied(node->childIndex,keyByte+1u,emptyMarker);
+                       if (pos<256) {
+                         return &node->child[node->childIndex[pos]];
                        }
                        return &nullNode;
                      }
@@ -855,19 +593,17 @@ ARTBase::Node** ARTBase::lowerThan(Node* n,uint8_t keyByte) const {
                     }
     case NodeType16: {
                        Node16* node=static_cast<Node16*>(n);
-                       for (int i=node->count-1;i>=0;i--) {
-                         if (flipSign(node->key[i])<keyByte) {
-                           return &node->child[i];
-                         }
+                       unsigned pos=nodesearch::lower16(node->key,node->count,flipSign(keyByte));
+                       if (pos<node->count) {
+                         return &node->child[pos];
                        }
                        return &nullNode;
                      }
     case NodeType48: {
                        Node48* node=static_cast<Node48*>(n);
-                       for (int i=keyByte-1;i>=0;i--) {
-                         if (node->childIndex[i]!=emptyMarker) {
-                           return &node->child[node->childIndex[i]];
-                         }
+                       unsigned pos=nodesearch::previousOccupied(node->childIndex,keyByte,emptyMarker);
+                       if (pos<256) {
+                         return &node->child[node->childIndex[pos]];
                        }
                        return &nullNode;
                      }
@@ -884,43 +620,91 @@ ARTBase::Node** ARTBase::lowerThan(Node* n,uint8_t keyByte) const {
   throw; // Unreachable
 }
 
-ARTBase::Node* ARTBase::sartLookupPrefix(ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
-  // Find the inner node with a matching prefix
+uint32_t ARTBase::writeFrozen(KeyLoader loadKey, std::vector<uint32_t>& nodes, std::vector<uint64_t>& leaves) const {
+  if (tree==NULL)
+    return frozen::emptyRoot;
+  return writeFrozen(tree, 0, loadKey, nodes, leaves);
+}
 
-  while (node != NULL) {
-    if (isLeaf(node) && keyLength >= depth) {
-      return node;
-    }
+uint32_t ARTBase::writeFrozen(Node* node, unsigned depth, KeyLoader loadKey, std::vector<uint32_t>& nodes, std::vector<uint64_t>& leaves) const {
+  // Write the subtree in depth-first order, return the reference to it
+  if (isLeaf(node)) {
+    if (leaves.size()>=frozen::leafFlag-1)
+      throw Exception("Too many leaves for a frozen ART");
+    leaves.push_back(getLeafValue(node));
+    return frozen::leafFlag|static_cast<uint32_t>(leaves.size()-1);
+  }
 
-    unsigned matchingChars = prefixMismatch(node, key, depth, keyLength);
-    if (matchingChars == keyLength) {
-      // Return inner node
-      return node;
-    }
-    else if (matchingChars != node->prefixLength) {
-      return NULL;
-    }
-    depth += node->prefixLength;
-
-    // find child node
-    Node* child = *findChild(node, key[depth]);
-    if (child) {
-      node = child;
-      depth++;
-      continue;
-    }
+  // Collect the children in key order
+  uint8_t keys[256];
+  Node* children[256];
+  unsigned count=0;
+  switch (node->type) {
+    case NodeType4: {
+                      Node4* n=static_cast<Node4*>(node);
+                      for (unsigned i=0;i<n->count;i++) {
+                        keys[count]=n->key[i];
+                        children[count++]=n->child[i];
+                      }
+                      break;
+                    }
+    case NodeType16: {
+                       Node16* n=static_cast<Node16*>(node);
+                       for (unsigned i=0;i<n->count;i++) {
+                         keys[count]=flipSign(n->key[i]);
+                         children[count++]=n->child[i];
+                       }
+                       break;
+                     }
+    case NodeType48: {
+                       Node48* n=static_cast<Node48*>(node);
+                       for (unsigned i=0;i<256;i++) {
+                         if (n->childIndex[i]!=emptyMarker) {
+                           keys[count]=static_cast<uint8_t>(i);
+                           children[count++]=n->child[n->childIndex[i]];
+                         }
+                       }
+                       break;
+                     }
+    case NodeType256: {
+                        Node256* n=static_cast<Node256*>(node);
+                        for (unsigned i=0;i<256;i++) {
+                          if (n->child[i]) {
+                            keys[count]=static_cast<uint8_t>(i);
+                            children[count++]=n->child[i];
+                          }
+                        }
+                        break;
+                      }
+  }
 
-    // No child node found; we're at the last matching inner node
-    // find the lower child instead
-    child = *lowerThan(node, key[depth]);
-    if (child) {
-      // we need the previous page, which is either the maximum of the parent (recursive)
-      // or the current minimum
-      return minimum(node);
-    }
-    return maximum(child);
+  // The inline prefix may be truncated, the frozen one is complete
+  std::vector<uint8_t> key;
+  const uint8_t* prefix=node->prefix;
+  if (node->prefixLength>maxPrefixLength) {
+    key.resize(std::max<size_t>(depth+node->prefixLength, sizeof(uint64_t)));
+    loadKey(*leafStore, getLeafValue(minimum(node)), key.data(), static_cast<unsigned>(key.size()));
+    prefix=key.data()+depth;
   }
 
-  return NULL;
-}
+  const bool dense=count>frozen::maxSparseChildren;
+  const size_t offset=nodes.size();
+  const size_t childOffset=offset+2+frozen::words(node->prefixLength)+(dense?0:frozen::words(count));
+  const size_t size=childOffset-offset+(dense?256:count);
+  if (offset+size>=frozen::leafFlag)
+    throw Exception("Too many nodes for a frozen ART");
+
+  nodes.resize(offset+size, 0);
+  nodes[offset]=(dense?frozen::denseNode:frozen::sparseNode)|(count<<8);
+  nodes[offset+1]=node->prefixLength;
+  memcpy(&nodes[offset+2], prefix, node->prefixLength);
+  if (!dense)
+    memcpy(&nodes[offset+2+frozen::words(node->prefixLength)], keys, count);
 
+  for (unsigned i=0;i<count;i++) {
+    // Nodes may be reallocated while writing the child
+    uint32_t child=writeFrozen(children[i], depth+node->prefixLength+1, loadKey, nodes, leaves);
+    nodes[childOffset+(dense?keys[i]:i)]=child;
+  }
+  return static_cast<uint32_t>(offset);
+}
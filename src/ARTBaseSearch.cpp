@@ -0,0 +1,327 @@
+#ifdef DEBUG
+#undef NDEBUG
+#include <cassert>
+#endif
+#include <algorithm>
+#include <cstring>
+#include "ARTBase.hpp"
+
+/**
+ * @file
+ * Adapted from ART.cpp, http://www-db.in.tum.de/~leis/
+ *
+ * > Adaptive Radix Tree
+ * > Viktor Leis, 2012
+ * > leis@in.tum.de
+ *
+ */
+
+inline ARTBase::Node* ARTBase::makeLeaf(uintptr_t tid) const {
+  // Create a pseudo-leaf
+  return reinterpret_cast<Node*>((tid<<1)|1);
+}
+
+inline uintptr_t ARTBase::getLeafValue(Node* node) {
+  // The the value stored in the pseudo-leaf
+  return reinterpret_cast<uintptr_t>(node)>>1;
+}
+
+inline bool ARTBase::isLeaf(Node* node) {
+  // Is the node a leaf?
+  return reinterpret_cast<uintptr_t>(node)&1;
+}
+
+template<class TTree, class TStore>
+bool ARTBase::leafMatches(const TStore& store,Node* leaf,uint8_t key[],unsigned keyLength,unsigned depth) const {
+  // Check if the key of the leaf is equal to the searched key
+  if (depth!=keyLength) {
+    return TTree::fingerprintMatches(getLeafValue(leaf), key, keyLength) && TTree::keyMismatch(store, getLeafValue(leaf), key, depth, keyLength)==keyLength;
+  }
+  return true;
+}
+
+template<class TTree, class TStore>
+unsigned ARTBase::prefixMismatch(const TStore& store,Node* node,uint8_t key[],unsigned depth) const {
+  // Compare the key with the prefix of the node, return the number matching bytes
+  unsigned pos;
+  if (node->prefixLength>maxPrefixLength) {
+    for (pos=0;pos<maxPrefixLength;pos++)
+      if (key[depth+pos]!=node->prefix[pos])
+        return pos;
+    return TTree::keyMismatch(store, getLeafValue(minimum(node)), key, depth+pos, depth+node->prefixLength)-depth;
+  } else {
+    for (pos=0;pos<node->prefixLength;pos++)
+      if (key[depth+pos]!=node->prefix[pos])
+        return pos;
+  }
+  return pos;
+}
+
+template<class TTree, class TStore>
+ARTBase::Node* ARTBase::lookupValue(const TStore& store,ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
+  // Find the node with a matching key, optimistic version
+
+  bool skippedPrefix=false; // Did we optimistically skip some prefix without checking it?
+
+  while (node!=NULL) {
+    if (isLeaf(node)) {
+      if (!skippedPrefix&&depth==keyLength) // No check required
+        return node;
+
+      // Check leaf, also if the whole key was consumed but a prefix was
+      // skipped; most mismatches are rejected before the key is loaded
+      if (!TTree::fingerprintMatches(getLeafValue(node), key, keyLength) ||
+          TTree::keyMismatch(store, getLeafValue(node), key, skippedPrefix?0:depth, keyLength)!=keyLength)
+        return NULL;
+      return node;
+    }
+
+    if (node->prefixLength) {
+      if (node->prefixLength<maxPrefixLength) {
+        for (unsigned pos=0;pos<node->prefixLength;pos++)
+          if (key[depth+pos]!=node->prefix[pos])
+            return NULL;
+      } else
+        skippedPrefix=true;
+      depth+=node->prefixLength;
+    }
+
+    node=*findChild(node,key[depth]);
+    depth++;
+  }
+
+  return NULL;
+}
+
+template<class TTree, class TStore>
+ARTBase::Node* ARTBase::lookupPrefix(const TStore& store,ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
+  // Find the node with a matching prefix
+
+  while (node!=NULL) {
+    if (isLeaf(node)) {
+      if (keyLength == depth) {
+        return node;
+      }
+      return NULL;
+    }
+
+    unsigned matchingChars = prefixMismatch<TTree>(store, node, key, depth);
+    if (matchingChars == keyLength) {
+      // Return inner node
+      return node;
+    }
+    else if (matchingChars != node->prefixLength) {
+      return NULL;
+    }
+
+    depth+=node->prefixLength;
+
+    node=*findChild(node,key[depth]);
+    depth++;
+  }
+
+  return NULL;
+}
+
+template<class TTree, class TStore>
+ARTBase::Node* ARTBase::sartLookupValue(const TStore& store,ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
+  //std::cout << "lookup" << std::endl;
+
+  while (node != NULL) {
+    if (isLeaf(node)) {
+      return node;
+    }
+
+    unsigned mismatchPos = prefixMismatch<TTree>(store, node, key, depth);
+    if (mismatchPos != node->prefixLength) {
+      return minimum(node);
+    }
+
+    if (keyLength == depth+node->prefixLength) {
+      return minimum(node);
+    }
+
+    depth += node->prefixLength;
+
+    Node** child = findChild(node, key[depth]);
+    if (child != NULL && *child) {
+      node = *child;
+      depth++;
+      continue;
+    }
+
+#ifdef DEBUG
+    assert(node != NULL);
+#endif
+    child = greaterThan(node, key[depth]);
+    if (child == NULL || !(*child)) {
+      return maximum(*lowerThan(node, key[depth]));
+    }
+    return minimum(*child);
+  }
+
+  return NULL;
+}
+
+template<class TTree, class TStore>
+ARTBase::Node* ARTBase::lookupValuePessimistic(const TStore& store,ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
+  // Find the node with a matching key, alternative pessimistic version
+
+  while (node!=NULL) {
+    if (isLeaf(node)) {
+      if (leafMatches<TTree>(store,node,key,keyLength,depth))
+        return node;
+      return NULL;
+    }
+
+    if (prefixMismatch<TTree>(store,node,key,depth)!=node->prefixLength)
+      return NULL; else
+        depth+=node->prefixLength;
+
+    node=*findChild(node,key[depth]);
+    depth++;
+  }
+
+  return NULL;
+}
+
+template<class TTree>
+void ARTBase::insertValue(Node* node,Node** nodeRef,uint8_t key[],unsigned depth,uintptr_t value, unsigned maxKeyLength) {
+  // Insert the leaf value into the tree
+
+  if (node==NULL) {
+    *nodeRef=makeLeaf(value);
+    return;
+  }
+
+  if (isLeaf(node)) {
+    // Replace leaf with Node4 and store both leaves in it
+    uint8_t existingKey[maxKeyLength];
+    TTree::loadKey(*leafStore, getLeafValue(node), existingKey, maxKeyLength);
+    unsigned newPrefixLength=0;
+    while (true) {
+      if (existingKey[depth+newPrefixLength]!=key[depth+newPrefixLength]) break;
+      newPrefixLength++;
+    }
+
+    Node* newNode=makeNode4();
+    newNode->prefixLength=newPrefixLength;
+    memcpy(newNode->prefix,key+depth,std::min(newPrefixLength,maxPrefixLength));
+    *nodeRef=newNode;
+
+    insertChild(newNode,nodeRef,existingKey[depth+newPrefixLength],node);
+    insertChild(newNode,nodeRef,key[depth+newPrefixLength],makeLeaf(value));
+    return;
+  }
+
+  // Handle prefix of inner node
+  if (node->prefixLength) {
+    unsigned mismatchPos=prefixMismatch<TTree>(*leafStore,node,key,depth);
+    if (mismatchPos!=node->prefixLength) {
+      // Prefix differs, create new node
+      Node* newNode=makeNode4();
+      *nodeRef=newNode;
+      newNode->prefixLength=mismatchPos;
+      memcpy(newNode->prefix,node->prefix,std::min(mismatchPos,maxPrefixLength));
+      // Break up prefix
+      if (node->prefixLength<maxPrefixLength) {
+        insertChild(newNode,nodeRef,node->prefix[mismatchPos],node);
+        node->prefixLength-=(mismatchPos+1);
+        memmove(node->prefix,node->prefix+mismatchPos+1,std::min(node->prefixLength,maxPrefixLength));
+      } else {
+        node->prefixLength-=(mismatchPos+1);
+        // The rest of the prefix comes from a key that may be longer than the inserted one
+        const unsigned minKeyLength=std::max(maxKeyLength,depth+mismatchPos+1+std::min(node->prefixLength,maxPrefixLength));
+        uint8_t minKey[minKeyLength];
+        TTree::loadKey(*leafStore, getLeafValue(minimum(node)), minKey, minKeyLength);
+        insertChild(newNode,nodeRef,minKey[depth+mismatchPos],node);
+        memmove(node->prefix,minKey+depth+mismatchPos+1,std::min(node->prefixLength,maxPrefixLength));
+      }
+      insertChild(newNode,nodeRef,key[depth+mismatchPos],makeLeaf(value));
+      return;
+    }
+    depth+=node->prefixLength;
+  }
+
+  // Recurse
+  Node** child=findChild(node,key[depth]);
+  if (*child) {
+    insertValue<TTree>(*child,child,key,depth+1,value,maxKeyLength);
+    return;
+  }
+
+  // Insert leaf into inner node
+  insertChild(node,nodeRef,key[depth],makeLeaf(value));
+}
+
+template<class TTree>
+void ARTBase::erase(Node* node,Node** nodeRef,uint8_t key[],unsigned keyLength,unsigned depth, unsigned maxKeyLength) {
+  // Delete a leaf from a tree
+
+  if (!node)
+    return;
+
+  if (isLeaf(node)) {
+    // Make sure we have the right leaf
+    if (leafMatches<TTree>(*leafStore,node,key,keyLength,depth))
+      *nodeRef=NULL;
+    return;
+  }
+
+  // Handle prefix
+  if (node->prefixLength) {
+    if (prefixMismatch<TTree>(*leafStore,node,key,depth)!=node->prefixLength)
+      return;
+    depth+=node->prefixLength;
+  }
+
+  Node** child=findChild(node,key[depth]);
+  if (isLeaf(*child)&&leafMatches<TTree>(*leafStore,*child,key,keyLength,depth)) {
+    // Leaf found, delete it in inner node
+    eraseChild(node,nodeRef,child,key[depth]);
+  } else {
+    //Recurse
+    erase<TTree>(*child,child,key,keyLength,depth+1,maxKeyLength);
+  }
+}
+
+template<class TTree, class TStore>
+ARTBase::Node* ARTBase::sartLookupPrefix(const TStore& store,ARTBase::Node* node,uint8_t key[],unsigned keyLength,unsigned depth) const {
+  // Find the inner node with a matching prefix
+
+  while (node != NULL) {
+    if (isLeaf(node) && keyLength >= depth) {
+      return node;
+    }
+
+    unsigned matchingChars = prefixMismatch<TTree>(store, node, key, depth);
+    if (matchingChars == keyLength) {
+      // Return inner node
+      return node;
+    }
+    else if (matchingChars != node->prefixLength) {
+      return NULL;
+    }
+    depth += node->prefixLength;
+
+    // find child node
+    Node* child = *findChild(node, key[depth]);
+    if (child) {
+      node = child;
+      depth++;
+      continue;
+    }
+
+    // No child node found; we're at the last matching inner node
+    // find the lower child instead
+    child = *lowerThan(node, key[depth]);
+    if (child) {
+      // we need the previous page, which is either the maximum of the parent (recursive)
+      // or the current minimum
+      return minimum(node);
+    }
+    return maximum(child);
+  }
+
+  return NULL;
+}
@@ -0,0 +1,139 @@
+#ifdef DEBUG
+#undef NDEBUG
+#include <cassert>
+#endif
+#include <limits>
+#include <cstring>
+#include "ART.hpp"
+
+// Generic implementations
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+template<class TKey>
+inline bool ART<TKey>::fingerprintMatches(uintptr_t leafValue, uint8_t key[], unsigned keyLength) {
+  // Leaves carry no fingerprint, so every leaf has to be loaded
+  return true;
+}
+#pragma GCC diagnostic pop
+
+template<class TKey>
+template<class TStore>
+bool ART<TKey>::lookup(TKey key, uintptr_t& value, const TStore& store) const {
+  return lookupLeaf<ART>(key, value, store);
+}
+
+// uint64_t implementations
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+template<>
+template<class TStore>
+void ART<uint64_t>::loadKey(const TStore& store, uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength) {
+#ifdef DEBUG
+  assert(maxKeyLength == sizeof(uint64_t));
+#endif
+  uint64_t id = store.getId(leafValue);
+  reinterpret_cast<uint64_t*>(key)[0]=__builtin_bswap64(id);
+}
+#pragma GCC diagnostic pop
+
+template<>
+template<class TStore>
+unsigned ART<uint64_t>::keyMismatch(const TStore& store, uintptr_t leafValue, uint8_t key[], unsigned from, unsigned to) {
+#ifdef DEBUG
+  assert(to <= sizeof(uint64_t));
+#endif
+  // Keys are always complete IDs, even if only a part is compared
+  uint8_t leafKey[sizeof(uint64_t)];
+  loadKey(store, leafValue, leafKey, sizeof(uint64_t));
+  unsigned pos;
+  for (pos=from;pos<to;pos++)
+    if (leafKey[pos]!=key[pos])
+      return pos;
+  return pos;
+}
+
+template<>
+template<class TTree, class TStore>
+bool ART<uint64_t>::lookupLeaf(uint64_t key, uintptr_t& value, const TStore& store) const {
+  uint8_t swappedKey[sizeof(uint64_t)];
+  reinterpret_cast<uint64_t*>(swappedKey)[0] = __builtin_bswap64(key);
+
+  Node* leaf = lookupValue<TTree>(store, tree, swappedKey, sizeof(uint64_t), 0);
+  if (leaf == nullNode) {
+    return false;
+  }
+#ifdef DEBUG
+  assert(isLeaf(leaf));
+#endif
+  value = getLeafValue(leaf);
+  return true;
+}
+
+template<>
+template<class TTree>
+void ART<uint64_t>::insertLeaf(uint64_t key, uintptr_t value) {
+  uint8_t swappedKey[sizeof(uint64_t)];
+  reinterpret_cast<uint64_t*>(swappedKey)[0] = __builtin_bswap64(key);
+
+  insertValue<TTree>(tree, &tree, swappedKey, 0, value, sizeof(uint64_t));
+}
+
+// std::string implementations
+
+template<>
+template<class TStore>
+void ART<std::string>::loadKey(const TStore& store, uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength) {
+  std::string value = store.getValue(leafValue);
+  strncpy(reinterpret_cast<char*>(key), value.c_str(), maxKeyLength);
+}
+
+template<>
+template<class TStore>
+unsigned ART<std::string>::keyMismatch(const TStore& store, uintptr_t leafValue, uint8_t key[], unsigned from, unsigned to) {
+  // Compare in place instead of materializing the value
+  return store.valueMismatch(leafValue, key, from, to);
+}
+
+template<>
+template<class TTree, class TStore>
+bool ART<std::string>::lookupLeaf(std::string key, uintptr_t& value, const TStore& store) const {
+#ifdef DEBUG
+  assert(key.size() < std::numeric_limits<unsigned>::max());
+#endif
+  Node* leaf = lookupValue<TTree>(store, tree, reinterpret_cast<uint8_t*>(const_cast<char*>(key.c_str())), static_cast<unsigned>(key.size()+1), 0);
+  if (leaf == nullNode) {
+    return false;
+  }
+#ifdef DEBUG
+  assert(isLeaf(leaf));
+#endif
+  value = getLeafValue(leaf);
+  return true;
+}
+
+template<>
+template<class TTree>
+void ART<std::string>::insertLeaf(std::string key, uintptr_t value) {
+#ifdef DEBUG
+  assert(key.size() < std::numeric_limits<unsigned>::max());
+#endif
+
+  insertValue<TTree>(tree, &tree, reinterpret_cast<uint8_t*>(const_cast<char*>(key.c_str())), 0, value, static_cast<unsigned>(key.size()+1));
+}
+
+template<>
+template<class TTree>
+std::pair<uintptr_t, uintptr_t> ART<std::string>::rangeLookupLeaves(std::string prefix) const {
+#ifdef DEBUG
+  assert(prefix.size() <= std::numeric_limits<unsigned>::max());
+#endif
+
+  // Use only prefix.size() to exclude NULL terminator!
+  Node* prefixNode = lookupPrefix<TTree>(*leafStore, tree, reinterpret_cast<uint8_t*>(const_cast<char*>((prefix.c_str()))), static_cast<unsigned>(prefix.size()), 0);
+
+  return std::make_pair(
+      getLeafValue(minimum(prefixNode)),
+      getLeafValue(maximum(prefixNode)));
+}
@@ -0,0 +1,76 @@
+#include "BloomFilter.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace {
+  // Odd multipliers selecting the bit in every word of a block
+  const uint32_t salts[] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+  };
+}
+
+BloomFilter::BloomFilter(double bits) : bitsPerValue(bits), numberOfBlocks(0) {
+}
+
+uint64_t BloomFilter::blockIndex(uint64_t hash) const {
+  // The upper half of the hash selects the block, the lower half the bits
+  return ((hash >> 32) * numberOfBlocks) >> 32;
+}
+
+uint32_t BloomFilter::mask(uint64_t hash, unsigned word) {
+  return 1u << ((static_cast<uint32_t>(hash) * salts[word]) >> 27);
+}
+
+void BloomFilter::insert(const std::string& value) {
+  pendingHashes.push_back(std::hash<std::string>()(value));
+}
+
+void BloomFilter::freeze() {
+  if (isFrozen()) {
+    return;
+  }
+
+  const uint64_t blockCount = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(pendingHashes.size() * bitsPerValue / (wordsPerBlock * 32))), 1);
+  void* memory;
+  if (posix_memalign(&memory, alignof(Block), blockCount * sizeof(Block)) != 0) {
+    throw Exception("Could not allocate Bloom filter");
+  }
+  memset(memory, 0, blockCount * sizeof(Block));
+  blocks.reset(static_cast<Block*>(memory));
+  numberOfBlocks = blockCount;
+
+  for (uint64_t hash : pendingHashes) {
+    Block& b = blocks[blockIndex(hash)];
+    for (unsigned word = 0; word < wordsPerBlock; word++) {
+      b.words[word] |= mask(hash, word);
+    }
+  }
+  std::vector<uint64_t>().swap(pendingHashes);
+}
+
+bool BloomFilter::isFrozen() const {
+  return numberOfBlocks != 0;
+}
+
+bool BloomFilter::mayContain(const std::string& value) const {
+  if (!isFrozen()) {
+    return true;
+  }
+
+  const uint64_t hash = std::hash<std::string>()(value);
+  const Block& b = blocks[blockIndex(hash)];
+  bool result = true;
+  for (unsigned word = 0; word < wordsPerBlock; word++) {
+    // No early exit, so the loop is vectorized
+    result &= (b.words[word] & mask(hash, word)) != 0;
+  }
+  return result;
+}
+
+uint64_t BloomFilter::size() const {
+  return numberOfBlocks * sizeof(Block);
+}
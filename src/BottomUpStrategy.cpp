@@ -2,8 +2,8 @@
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
 PageIterator<TLeaf> BottomUpStrategy<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(uint64_t leafValue) const {
-  TLeaf* leaf = reinterpret_cast<TLeaf*>(leafValue >> 16);
-  uint16_t offset = leafValue & 0xFFFF;
+  TLeaf* leaf = this->decodeLeafPointer(leafValue);
+  uint16_t offset = this->decodeAdditionalValue(leafValue);
 
   if (offset == 1) {
     // Special value; get last value in leaf
@@ -15,7 +15,7 @@ PageIterator<TLeaf> BottomUpStrategy<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
 PageIterator<TLeaf> BottomUpStrategy<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(uint64_t leafValue, std::string lookupValue) const {
-  return reinterpret_cast<TLeaf*>(leafValue >> 16)->find(lookupValue);
+  return this->decodeLeafPointer(leafValue)->find(lookupValue);
 }
 
 #pragma GCC diagnostic push
@@ -51,14 +51,14 @@ bool BottomUpStrategy<TIdIndex, TStringIndex, TLeaf>::rangeLookup(std::string pr
     return false;
   }
 
-  start = reinterpret_cast<TLeaf*>(range.first >> 16)->firstPrefix(prefix);
+  start = this->decodeLeafPointer(range.first)->firstPrefix(prefix);
 
   if (!start) {
     // Prefix not found
     return false;
   }
 
-  end = reinterpret_cast<TLeaf*>(range.second >> 16)->lastPrefix(prefix);
+  end = this->decodeLeafPointer(range.second)->lastPrefix(prefix);
 
 #ifdef DEBUG
   assert(range.second != 0);
@@ -0,0 +1,147 @@
+#include "ConcurrentEncoder.hpp"
+#include "ExternalSorter.hpp"
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include "murmurhash3.h"
+}
+
+namespace {
+  inline uint64_t hashValue(const char* value, uint64_t length) {
+    // Spread the 32-bit hash, the upper bits select the stripe
+    return static_cast<uint64_t>(hash(value, length)) * 0x9E3779B97F4A7C15ull;
+  }
+
+  inline int compare(const char* lhs, uint64_t lhsLength, const char* rhs, uint64_t rhsLength) {
+    int result = memcmp(lhs, rhs, std::min(lhsLength, rhsLength));
+    if (result != 0) {
+      return result;
+    }
+    return lhsLength < rhsLength ? -1 : (lhsLength > rhsLength ? 1 : 0);
+  }
+}
+
+ConcurrentEncoder::ConcurrentEncoder(uint8_t bits) : stripeBits(bits), stripes(new Stripe[1ull << bits]), nextId(0) {
+}
+
+const char* ConcurrentEncoder::Stripe::store(const std::string& value) {
+  if (value.size() > blockRemaining) {
+    if (value.size() > blockSize / 4) {
+      // Long values get their own block, so the current one isn't wasted
+      blocks.push_back(std::unique_ptr<char[]>(new char[value.size()]));
+      memcpy(blocks.back().get(), value.data(), value.size());
+      return blocks.back().get();
+    }
+    blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+    blockPtr = blocks.back().get();
+    blockRemaining = blockSize;
+  }
+
+  char* result = blockPtr;
+  memcpy(result, value.data(), value.size());
+  blockPtr += value.size();
+  blockRemaining -= value.size();
+  return result;
+}
+
+void ConcurrentEncoder::Stripe::grow() {
+  std::vector<Entry> oldSlots(slots.empty() ? initialCapacity : slots.size() * 2, Entry { 0, nullptr, 0, 0 });
+  oldSlots.swap(slots);
+
+  const uint64_t mask = slots.size() - 1;
+  for (const auto& entry : oldSlots) {
+    if (entry.value != nullptr) {
+      uint64_t slot = entry.hash & mask;
+      while (slots[slot].value != nullptr) {
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = entry;
+    }
+  }
+}
+
+uint64_t ConcurrentEncoder::encode(const std::string& term) {
+  const uint64_t hash = hashValue(term.data(), term.size());
+  Stripe& stripe = stripes[hash >> (64 - stripeBits)];
+
+  std::lock_guard<std::mutex> lock(stripe.mutex);
+
+  // Keep the load factor below 1/2
+  if ((stripe.used + 1) * 2 > stripe.slots.size()) {
+    stripe.grow();
+  }
+
+  const uint64_t mask = stripe.slots.size() - 1;
+  uint64_t slot = hash & mask;
+  while (stripe.slots[slot].value != nullptr) {
+    const Entry& entry = stripe.slots[slot];
+    if (entry.hash == hash && entry.length == term.size() && memcmp(entry.value, term.data(), term.size()) == 0) {
+      return entry.id;
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  // Empty strings still need a non-null value pointer
+  const char* value = term.empty() ? "" : stripe.store(term);
+  const uint64_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+  stripe.slots[slot] = Entry { hash, value, term.size(), id };
+  stripe.used++;
+
+  return id;
+}
+
+uint64_t ConcurrentEncoder::size() const {
+  return nextId.load();
+}
+
+std::vector<const ConcurrentEncoder::Entry*> ConcurrentEncoder::sortedEntries(std::vector<uint64_t>& finalIds) const {
+  const uint64_t numberOfTerms = nextId.load();
+  std::vector<const Entry*> entries;
+  entries.reserve(numberOfTerms);
+
+  for (uint64_t i = 0; i < (1ull << stripeBits); i++) {
+    for (const auto& entry : stripes[i].slots) {
+      if (entry.value != nullptr) {
+        entries.push_back(&entry);
+      }
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry* lhs, const Entry* rhs) {
+    return compare(lhs->value, lhs->length, rhs->value, rhs->length) < 0;
+  });
+
+  finalIds.assign(numberOfTerms, 0);
+  for (uint64_t i = 0; i < entries.size(); i++) {
+    finalIds[entries[i]->id] = i + 1;
+  }
+  return entries;
+}
+
+void ConcurrentEncoder::clear() {
+  stripes.reset(new Stripe[1ull << stripeBits]);
+  nextId = 0;
+}
+
+void ConcurrentEncoder::finish(std::vector<std::string>& sortedTerms, std::vector<uint64_t>& finalIds) {
+  std::vector<const Entry*> entries = sortedEntries(finalIds);
+
+  sortedTerms.clear();
+  sortedTerms.reserve(entries.size());
+  for (const Entry* entry : entries) {
+    sortedTerms.push_back(std::string(entry->value, entry->length));
+  }
+
+  clear();
+}
+
+void ConcurrentEncoder::finish(ExternalSorter& sortedTerms, std::vector<uint64_t>& finalIds) {
+  std::vector<const Entry*> entries = sortedEntries(finalIds);
+
+  for (const Entry* entry : entries) {
+    sortedTerms.add(std::string(entry->value, entry->length));
+  }
+
+  clear();
+}
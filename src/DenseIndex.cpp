@@ -0,0 +1,34 @@
+#include "DenseIndex.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <limits>
+
+template<typename TKey>
+void DenseIndex<TKey>::insert(TKey key, uint64_t value) {
+  if (value == 0 || value > std::numeric_limits<uint32_t>::max()) {
+    throw Exception("Leaf value does not fit into dense index: " + std::to_string(value));
+  }
+
+  if (key >= index.size()) {
+    // IDs are mostly inserted in ascending order
+    index.resize(std::max<uint64_t>(key + 1, index.size() * 2), 0);
+  }
+  index[key] = static_cast<uint32_t>(value);
+}
+
+template<typename TKey>
+bool DenseIndex<TKey>::lookup(TKey key, uint64_t& value) const {
+  if (key >= index.size() || index[key] == 0) {
+    return false;
+  }
+
+  value = index[key];
+  return true;
+}
+
+template<typename TKey>
+std::string DenseIndex<TKey>::description() {
+  return "DenseIndex";
+}
+
+template class DenseIndex<uint64_t>;
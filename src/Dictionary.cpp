@@ -1,8 +1,22 @@
 #include "Dictionary.hpp"
+#include "ExternalSorter.hpp"
+#include <vector>
 
 Dictionary::~Dictionary() noexcept {
 }
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+void Dictionary::bulkInsert(ExternalSorter& values, size_t chunkSize) {
+  std::vector<std::string> allValues;
+  std::string value;
+  while (values.next(value)) {
+    allValues.push_back(value);
+  }
+  bulkInsert(allValues.size(), allValues.data());
+}
+#pragma GCC diagnostic pop
+
 uint64_t Dictionary::size() const {
   return nextId-1;
 }
@@ -0,0 +1,145 @@
+#include "ExternalSorter.hpp"
+#include "Exception.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+  uint64_t instanceCounter = 0;
+}
+
+ExternalSorter::Run::Run(const std::string& fileName) : stream(fileName, std::ios::binary) {
+  if (!stream) {
+    throw Exception("Could not open run file " + fileName);
+  }
+}
+
+bool ExternalSorter::Run::read() {
+  uint32_t length;
+  if (!stream.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+    return false;
+  }
+  value.resize(length);
+  if (length > 0 && !stream.read(&value[0], length)) {
+    throw Exception("Truncated run file");
+  }
+  return true;
+}
+
+ExternalSorter::ExternalSorter(uint64_t budget, std::string dir) : memoryBudget(budget), directory(dir), memoryUsage(0), finished(false), hasLastValue(false) {
+  if (directory.empty()) {
+    const char* tmpDir = std::getenv("TMPDIR");
+    directory = tmpDir != nullptr ? tmpDir : "/tmp";
+  }
+  directory += "/dict-run-" + std::to_string(getpid()) + "-" + std::to_string(instanceCounter++) + "-";
+}
+
+ExternalSorter::~ExternalSorter() {
+  runs.clear();
+  for (const auto& fileName : runFiles) {
+    std::remove(fileName.c_str());
+  }
+}
+
+void ExternalSorter::add(const std::string& value) {
+  if (finished) {
+    throw Exception("Values added to finished sorter");
+  }
+
+  if (values.insert(value).second) {
+    memoryUsage += entryOverhead + value.size();
+    if (memoryUsage >= memoryBudget) {
+      spill();
+    }
+  }
+}
+
+void ExternalSorter::spill() {
+  std::string fileName = directory + std::to_string(runFiles.size());
+  std::ofstream stream(fileName, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    throw Exception("Could not create run file " + fileName);
+  }
+  runFiles.push_back(fileName);
+
+  for (const auto& value : values) {
+    uint32_t length = static_cast<uint32_t>(value.size());
+    stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    stream.write(value.data(), length);
+  }
+
+  if (!stream) {
+    throw Exception("Could not write run file " + fileName);
+  }
+
+  values.clear();
+  memoryUsage = 0;
+}
+
+void ExternalSorter::finish() {
+  if (finished) {
+    return;
+  }
+  finished = true;
+
+  if (runFiles.empty()) {
+    // Everything fit into memory; no need to merge
+    valuesIt = values.cbegin();
+    return;
+  }
+
+  if (!values.empty()) {
+    spill();
+  }
+
+  for (size_t i = 0; i < runFiles.size(); i++) {
+    runs.push_back(std::unique_ptr<Run>(new Run(runFiles[i])));
+    if (runs[i]->read()) {
+      mergeQueue.push(make_pair(std::move(runs[i]->value), i));
+    }
+  }
+}
+
+bool ExternalSorter::next(std::string& value) {
+  finish();
+
+  if (runFiles.empty()) {
+    if (valuesIt == values.cend()) {
+      return false;
+    }
+    value = *valuesIt;
+    ++valuesIt;
+    return true;
+  }
+
+  while (nextMerged(value)) {
+    // Runs are deduplicated, but the same value may occur in several runs
+    if (!hasLastValue || value != lastValue) {
+      hasLastValue = true;
+      lastValue = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ExternalSorter::nextMerged(std::string& value) {
+  if (mergeQueue.empty()) {
+    return false;
+  }
+
+  size_t runIndex = mergeQueue.top().second;
+  value = mergeQueue.top().first;
+  mergeQueue.pop();
+
+  Run& run = *runs[runIndex];
+  if (run.read()) {
+    mergeQueue.push(make_pair(std::move(run.value), runIndex));
+  }
+
+  return true;
+}
+
+uint64_t ExternalSorter::numberOfRuns() const {
+  return runFiles.size();
+}
@@ -0,0 +1,92 @@
+#include "FingerprintART.hpp"
+#include "Exception.hpp"
+#ifdef DEBUG
+#undef NDEBUG
+#include <cassert>
+#endif
+#include <cstring>
+#include <limits>
+
+// Generic implementations
+
+template<class TKey>
+FingerprintART<TKey>::FingerprintART(LeafStore* leafStore, bool hugePages) : ART<TKey>(leafStore, hugePages) {
+}
+
+template<class TKey>
+std::string FingerprintART<TKey>::description() {
+  return "FingerprintART";
+}
+
+template<class TKey>
+uint16_t FingerprintART<TKey>::fingerprint(const uint8_t* key, unsigned keyLength) {
+  // Multiply-xorshift over whole words; only the top bits are used
+  uint64_t hash = keyLength * 0x9E3779B97F4A7C15ull;
+  unsigned pos = 0;
+  for (; pos + sizeof(uint64_t) <= keyLength; pos += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, key + pos, sizeof(word));
+    hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 32;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, key + pos, keyLength - pos);
+  hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+  hash ^= hash >> 29;
+  hash *= 0xFF51AFD7ED558CCDull;
+  return static_cast<uint16_t>(hash >> 48);
+}
+
+template<class TKey>
+uintptr_t FingerprintART<TKey>::tag(uintptr_t value, uint16_t fingerprint) {
+  if (value >> valueBits) {
+    throw Exception("Leaf value does not fit into fingerprint ART: " + std::to_string(value));
+  }
+  return (static_cast<uintptr_t>(fingerprint) << valueBits) | value;
+}
+
+template<class TKey>
+uintptr_t FingerprintART<TKey>::untag(uintptr_t leafValue) {
+  return leafValue & ((1ull << valueBits) - 1);
+}
+
+template<class TKey>
+bool FingerprintART<TKey>::lookup(TKey key, uintptr_t& value) const {
+  return lookup(key, value, *this->leafStore);
+}
+
+// uint64_t implementations
+
+template<>
+void FingerprintART<uint64_t>::insert(uint64_t key, uintptr_t value) {
+  uint64_t swappedKey = __builtin_bswap64(key);
+  insertLeaf<FingerprintART>(key, tag(value, fingerprint(reinterpret_cast<const uint8_t*>(&swappedKey), sizeof(uint64_t))));
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+template<>
+std::pair<uintptr_t, uintptr_t> FingerprintART<uint64_t>::rangeLookup(uint64_t prefix) const {
+  throw Exception("FingerprintART does not support range lookups on IDs");
+}
+#pragma GCC diagnostic pop
+
+// std::string implementations
+
+template<>
+void FingerprintART<std::string>::insert(std::string key, uintptr_t value) {
+#ifdef DEBUG
+  assert(key.size() < std::numeric_limits<unsigned>::max());
+#endif
+  // Include the NULL terminator, like ART
+  insertLeaf<FingerprintART>(key, tag(value, fingerprint(reinterpret_cast<const uint8_t*>(key.c_str()), static_cast<unsigned>(key.size()+1))));
+}
+
+template<>
+std::pair<uintptr_t, uintptr_t> FingerprintART<std::string>::rangeLookup(std::string prefix) const {
+  std::pair<uintptr_t, uintptr_t> range = rangeLookupLeaves<FingerprintART>(prefix);
+  return std::make_pair(untag(range.first), untag(range.second));
+}
+
+template class FingerprintART<uint64_t>;
+template class FingerprintART<std::string>;
@@ -0,0 +1,160 @@
+#include "FingerprintHash.hpp"
+#include "Exception.hpp"
+#include <emmintrin.h> // x86 SSE intrinsics
+#include <functional>
+#include <utility>
+
+namespace {
+  const unsigned groupSize = 16;
+  const uint8_t emptySlot = 0x80;
+
+  inline uint8_t fingerprint(uint64_t hash) {
+    return hash & 0x7F;
+  }
+
+  inline uint64_t groupIndex(uint64_t hash) {
+    return hash >> 7;
+  }
+
+  inline unsigned matchMask(const uint8_t* group, uint8_t byte) {
+    __m128i cmp = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)), _mm_set1_epi8(static_cast<char>(byte)));
+    return static_cast<unsigned>(_mm_movemask_epi8(cmp));
+  }
+}
+
+// Generic implementations
+
+template<class TKey>
+FingerprintHash<TKey>::FingerprintHash(LeafStore* store) : leafStore(store), control(groupSize, emptySlot), leafValues(groupSize), groupMask(0), size(0) {
+}
+
+template<class TKey>
+std::string FingerprintHash<TKey>::description() {
+  return "FingerprintHash";
+}
+
+template<class TKey>
+uint64_t FingerprintHash<TKey>::tableSize() const {
+  return control.size() * sizeof(uint8_t) + leafValues.size() * sizeof(uint32_t);
+}
+
+template<class TKey>
+void FingerprintHash<TKey>::insert(TKey key, uint64_t value) {
+  if (value >> 32) {
+    throw Exception("Leaf value does not fit into fingerprint hash: " + std::to_string(value));
+  }
+  // Keep the load factor below 7/8
+  if ((size + 1) * 8 > control.size() * 7) {
+    grow();
+  }
+  insertHashed(hashKey(key), static_cast<uint32_t>(value));
+  size++;
+}
+
+template<class TKey>
+void FingerprintHash<TKey>::insertHashed(uint64_t hash, uint32_t value) {
+  // Triangular probing over groups visits every group of a power-of-two table
+  uint64_t group = groupIndex(hash) & groupMask;
+  for (uint64_t step = 1; ; step++) {
+    unsigned empty = matchMask(&control[group * groupSize], emptySlot);
+    if (empty != 0) {
+      uint64_t slot = group * groupSize + static_cast<unsigned>(__builtin_ctz(empty));
+      control[slot] = fingerprint(hash);
+      leafValues[slot] = value;
+      return;
+    }
+    group = (group + step) & groupMask;
+  }
+}
+
+template<class TKey>
+void FingerprintHash<TKey>::grow() {
+  std::vector<uint8_t> oldControl(std::move(control));
+  std::vector<uint32_t> oldLeafValues(std::move(leafValues));
+  control.assign(oldControl.size() * 2, emptySlot);
+  leafValues.assign(oldLeafValues.size() * 2, 0);
+  groupMask = control.size() / groupSize - 1;
+
+  // Keys are not stored, so their hashes are recomputed from the leaf store
+  for (uint64_t slot = 0; slot < oldControl.size(); slot++) {
+    if (oldControl[slot] != emptySlot) {
+      insertHashed(hashLeaf(oldLeafValues[slot]), oldLeafValues[slot]);
+    }
+  }
+}
+
+template<class TKey>
+bool FingerprintHash<TKey>::lookup(TKey key, uint64_t& value) const {
+  const uint64_t hash = hashKey(key);
+  uint64_t group = groupIndex(hash) & groupMask;
+  for (uint64_t step = 1; ; step++) {
+    const uint8_t* groupControl = &control[group * groupSize];
+    for (unsigned matches = matchMask(groupControl, fingerprint(hash)); matches != 0; matches &= matches - 1) {
+      uint64_t slot = group * groupSize + static_cast<unsigned>(__builtin_ctz(matches));
+      if (leafMatches(leafValues[slot], key)) {
+        value = leafValues[slot];
+        return true;
+      }
+    }
+
+    // Slots are never removed, so an empty slot ends the probe sequence
+    if (matchMask(groupControl, emptySlot) != 0) {
+      return false;
+    }
+    group = (group + step) & groupMask;
+  }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+template<class TKey>
+std::pair<uint64_t, uint64_t> FingerprintHash<TKey>::rangeLookup(TKey prefix) const {
+  throw Exception("FingerprintHash does not support range lookups");
+}
+#pragma GCC diagnostic pop
+
+// uint64_t implementations
+
+template<>
+uint64_t FingerprintHash<uint64_t>::hashKey(const uint64_t& key) {
+  // MurmurHash3 finalizer
+  uint64_t hash = key;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+template<>
+uint64_t FingerprintHash<uint64_t>::hashLeaf(uint64_t leafValue) const {
+  return hashKey(leafStore->getId(leafValue));
+}
+
+template<>
+bool FingerprintHash<uint64_t>::leafMatches(uint64_t leafValue, const uint64_t& key) const {
+  return leafStore->getId(leafValue) == key;
+}
+
+// std::string implementations
+
+template<>
+uint64_t FingerprintHash<std::string>::hashKey(const std::string& key) {
+  return std::hash<std::string>()(key);
+}
+
+template<>
+uint64_t FingerprintHash<std::string>::hashLeaf(uint64_t leafValue) const {
+  return hashKey(leafStore->getValue(leafValue));
+}
+
+template<>
+bool FingerprintHash<std::string>::leafMatches(uint64_t leafValue, const std::string& key) const {
+  // Include the NULL terminator, so prefixes of the value do not match
+  const unsigned keyLength = static_cast<unsigned>(key.size() + 1);
+  return leafStore->valueMismatch(leafValue, reinterpret_cast<const uint8_t*>(key.c_str()), 0, keyLength) == keyLength;
+}
+
+template class FingerprintHash<uint64_t>;
+template class FingerprintHash<std::string>;
@@ -0,0 +1,314 @@
+#include "FrozenART.hpp"
+#include "Exception.hpp"
+#ifdef DEBUG
+#undef NDEBUG
+#include <cassert>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+  const uint32_t magic = 0x54524146; // "FART"
+
+  /**
+   * Header of a saved frozen tree; node words are padded to an even
+   * number, so the leaf values behind them stay 8-byte aligned.
+   */
+  struct Header {
+    uint32_t magic;
+    uint32_t root;
+    uint64_t numberOfNodeWords;
+    uint64_t numberOfLeaves;
+  };
+
+  inline uint64_t paddedNodeWords(uint64_t numberOfNodeWords) {
+    return (numberOfNodeWords + 1) & ~1ull;
+  }
+}
+
+// Generic implementations
+
+template<class TKey>
+FrozenART<TKey>::FrozenART(LeafStore* store) : leafStore(store), art(new ART<TKey>(store)), nodes(nullptr), leaves(nullptr), root(frozen::emptyRoot) {
+}
+
+template<class TKey>
+std::string FrozenART<TKey>::description() {
+  return "FrozenART";
+}
+
+template<class TKey>
+void FrozenART<TKey>::insert(TKey key, uintptr_t value) {
+  if (!art) {
+    throw Exception("Frozen ART is read-only");
+  }
+  art->insert(key, value);
+}
+
+template<class TKey>
+bool FrozenART<TKey>::isFrozen() const {
+  return !art;
+}
+
+template<class TKey>
+void FrozenART<TKey>::freeze() {
+  if (!art) {
+    return;
+  }
+
+  root = art->writeFrozen(nodeStorage, leafStorage);
+  nodeStorage.shrink_to_fit();
+  leafStorage.shrink_to_fit();
+  nodes = nodeStorage.data();
+  leaves = leafStorage.data();
+
+  art.reset();
+}
+
+template<class TKey>
+uint64_t FrozenART<TKey>::frozenSize() const {
+  return nodeStorage.size() * sizeof(uint32_t) + leafStorage.size() * sizeof(uint64_t);
+}
+
+template<class TKey>
+uint32_t FrozenART<TKey>::findChild(const uint32_t* node, uint8_t keyByte) const {
+  // Find the child for the keyByte, 0 if there is none
+  const unsigned count = node[0] >> 8;
+  const uint32_t* body = node + 2 + frozen::words(node[1]);
+
+  if ((node[0] & 0xFF) == frozen::denseNode) {
+    return body[keyByte];
+  }
+
+  const uint8_t* keys = reinterpret_cast<const uint8_t*>(body);
+  const uint8_t* key = static_cast<const uint8_t*>(memchr(keys, keyByte, count));
+  if (key == nullptr) {
+    return 0;
+  }
+  return body[frozen::words(count) + (key - keys)];
+}
+
+template<class TKey>
+uint32_t FrozenART<TKey>::minimum(uint32_t ref) const {
+  // Find the leaf with the smallest key
+  while (!(ref & frozen::leafFlag)) {
+    const uint32_t* node = nodes + ref;
+    const uint32_t* body = node + 2 + frozen::words(node[1]);
+    if ((node[0] & 0xFF) == frozen::denseNode) {
+      unsigned pos = 0;
+      while (body[pos] == 0)
+        pos++;
+      ref = body[pos];
+    }
+    else {
+      ref = body[frozen::words(node[0] >> 8)];
+    }
+  }
+  return ref & ~frozen::leafFlag;
+}
+
+template<class TKey>
+uint32_t FrozenART<TKey>::maximum(uint32_t ref) const {
+  // Find the leaf with the largest key
+  while (!(ref & frozen::leafFlag)) {
+    const uint32_t* node = nodes + ref;
+    const uint32_t* body = node + 2 + frozen::words(node[1]);
+    if ((node[0] & 0xFF) == frozen::denseNode) {
+      unsigned pos = 255;
+      while (body[pos] == 0)
+        pos--;
+      ref = body[pos];
+    }
+    else {
+      const unsigned count = node[0] >> 8;
+      ref = body[frozen::words(count) + count - 1];
+    }
+  }
+  return ref & ~frozen::leafFlag;
+}
+
+template<class TKey>
+bool FrozenART<TKey>::lookupFrozen(const uint8_t* key, unsigned keyLength, uintptr_t& value) const {
+  if (root == frozen::emptyRoot) {
+    return false;
+  }
+
+  uint32_t ref = root;
+  unsigned depth = 0;
+  while (!(ref & frozen::leafFlag)) {
+    const uint32_t* node = nodes + ref;
+    const unsigned prefixLength = node[1];
+    if (depth + prefixLength >= keyLength || memcmp(node + 2, key + depth, prefixLength) != 0) {
+      return false;
+    }
+    depth += prefixLength;
+
+    ref = findChild(node, key[depth]);
+    if (ref == 0) {
+      return false;
+    }
+    depth++;
+  }
+
+  // Everything up to depth was compared exactly on the way down
+  uint64_t leafValue = leaves[ref & ~frozen::leafFlag];
+  if (depth < keyLength && !leafMatches(leafValue, key, depth, keyLength)) {
+    return false;
+  }
+  value = leafValue;
+  return true;
+}
+
+template<class TKey>
+void FrozenART<TKey>::save(std::ostream& stream) const {
+  if (art) {
+    throw Exception("Only frozen ARTs can be saved");
+  }
+
+  Header header { magic, root, nodeStorage.size(), leafStorage.size() };
+  const uint32_t padding = 0;
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  stream.write(reinterpret_cast<const char*>(nodes), header.numberOfNodeWords * sizeof(uint32_t));
+  stream.write(reinterpret_cast<const char*>(&padding), (paddedNodeWords(header.numberOfNodeWords) - header.numberOfNodeWords) * sizeof(uint32_t));
+  stream.write(reinterpret_cast<const char*>(leaves), header.numberOfLeaves * sizeof(uint64_t));
+  if (!stream) {
+    throw Exception("Could not write frozen ART");
+  }
+}
+
+template<class TKey>
+void FrozenART<TKey>::load(std::istream& stream) {
+  Header header;
+  if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != magic) {
+    throw Exception("Invalid frozen ART");
+  }
+
+  nodeStorage.resize(paddedNodeWords(header.numberOfNodeWords));
+  leafStorage.resize(header.numberOfLeaves);
+  stream.read(reinterpret_cast<char*>(nodeStorage.data()), nodeStorage.size() * sizeof(uint32_t));
+  stream.read(reinterpret_cast<char*>(leafStorage.data()), leafStorage.size() * sizeof(uint64_t));
+  if (!stream) {
+    throw Exception("Truncated frozen ART");
+  }
+  nodeStorage.resize(header.numberOfNodeWords);
+
+  root = header.root;
+  nodes = nodeStorage.data();
+  leaves = leafStorage.data();
+  art.reset();
+}
+
+template<class TKey>
+void FrozenART<TKey>::attach(const void* data, uint64_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  if (size < sizeof(Header)) {
+    throw Exception("Invalid frozen ART");
+  }
+  Header header;
+  memcpy(&header, bytes, sizeof(header));
+  const uint64_t nodeBytes = paddedNodeWords(header.numberOfNodeWords) * sizeof(uint32_t);
+  if (header.magic != magic || size < sizeof(Header) + nodeBytes + header.numberOfLeaves * sizeof(uint64_t)) {
+    throw Exception("Invalid frozen ART");
+  }
+
+  nodeStorage.clear();
+  leafStorage.clear();
+  root = header.root;
+  nodes = reinterpret_cast<const uint32_t*>(bytes + sizeof(Header));
+  leaves = reinterpret_cast<const uint64_t*>(bytes + sizeof(Header) + nodeBytes);
+  art.reset();
+}
+
+// uint64_t implementations
+
+template<>
+bool FrozenART<uint64_t>::leafMatches(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const {
+  uint64_t swappedId = __builtin_bswap64(leafStore->getId(leafValue));
+  return memcmp(reinterpret_cast<const uint8_t*>(&swappedId) + from, key + from, to - from) == 0;
+}
+
+template<>
+bool FrozenART<uint64_t>::lookup(uint64_t key, uintptr_t& value) const {
+  if (art) {
+    return art->lookup(key, value);
+  }
+
+  uint64_t swappedKey = __builtin_bswap64(key);
+  return lookupFrozen(reinterpret_cast<const uint8_t*>(&swappedKey), sizeof(uint64_t), value);
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+template<>
+std::pair<uintptr_t, uintptr_t> FrozenART<uint64_t>::rangeLookup(uint64_t prefix) const {
+  throw Exception("FrozenART does not support range lookups on IDs");
+}
+#pragma GCC diagnostic pop
+
+// std::string implementations
+
+template<>
+bool FrozenART<std::string>::leafMatches(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const {
+  return leafStore->valueMismatch(leafValue, key, from, to) == to;
+}
+
+template<>
+bool FrozenART<std::string>::lookup(std::string key, uintptr_t& value) const {
+  if (art) {
+    return art->lookup(key, value);
+  }
+
+#ifdef DEBUG
+  assert(key.size() < std::numeric_limits<unsigned>::max());
+#endif
+  // Include the NULL terminator, like ART
+  return lookupFrozen(reinterpret_cast<const uint8_t*>(key.c_str()), static_cast<unsigned>(key.size()+1), value);
+}
+
+template<>
+std::pair<uintptr_t, uintptr_t> FrozenART<std::string>::rangeLookup(std::string prefix) const {
+  if (art) {
+    return art->rangeLookup(prefix);
+  }
+
+  const uint8_t* key = reinterpret_cast<const uint8_t*>(prefix.c_str());
+  const unsigned keyLength = static_cast<unsigned>(prefix.size());
+  if (root == frozen::emptyRoot) {
+    return std::make_pair(0, 0);
+  }
+
+  // Find the subtree whose keys all start with the prefix
+  uint32_t ref = root;
+  unsigned depth = 0;
+  while (depth < keyLength) {
+    if (ref & frozen::leafFlag) {
+      if (!leafMatches(leaves[ref & ~frozen::leafFlag], key, depth, keyLength)) {
+        return std::make_pair(0, 0);
+      }
+      break;
+    }
+
+    const uint32_t* node = nodes + ref;
+    const unsigned prefixLength = node[1];
+    const unsigned compareLength = std::min(prefixLength, keyLength - depth);
+    if (memcmp(node + 2, key + depth, compareLength) != 0) {
+      return std::make_pair(0, 0);
+    }
+    if (depth + prefixLength >= keyLength) {
+      break;
+    }
+    depth += prefixLength;
+
+    ref = findChild(node, key[depth]);
+    if (ref == 0) {
+      return std::make_pair(0, 0);
+    }
+    depth++;
+  }
+
+  return std::make_pair(leaves[minimum(ref)], leaves[maximum(ref)]);
+}
+
+template class FrozenART<uint64_t>;
+template class FrozenART<std::string>;
@@ -39,23 +39,12 @@ bool HAT<std::string>::lookup(std::string key, uint64_t& value) const {
 
 template<>
 std::pair<uint64_t, uint64_t> HAT<std::string>::rangeLookup(std::string prefix) const {
-  uint64_t start = 0;
-  uint64_t end = 0;
-
-  hattrie_iter_t* it = hattrie_iter_with_prefix(index, true, prefix.c_str(), prefix.size());
-  if (!hattrie_iter_finished(it)) {
-    start = end = *hattrie_iter_val(it);
-    hattrie_iter_next(it);
-
-    while (!hattrie_iter_finished(it)) {
-      end = *hattrie_iter_val(it);
-      hattrie_iter_next(it);
-    }
-
-    hattrie_iter_free(it);
+  uint64_t* start = nullptr;
+  uint64_t* end = nullptr;
+  if (!hattrie_prefix_range(index, prefix.c_str(), prefix.size(), &start, &end)) {
+    return std::make_pair(0, 0);
   }
-
-  return std::make_pair(start, end);
+  return std::make_pair(*start, *end);
 }
 
 template class HAT<std::string>;
@@ -2,8 +2,8 @@
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
 PageIterator<TLeaf> IndirectStrategy<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(uint64_t leafValue) const {
-  TLeaf* leaf = reinterpret_cast<TLeaf*>(leafValue >> 16);
-  uint16_t indexEntry = leafValue & 0xFFFF;
+  TLeaf* leaf = this->decodeLeafPointer(leafValue);
+  uint16_t indexEntry = this->decodeAdditionalValue(leafValue);
 
   return leaf->getIndexEntry(indexEntry);
 }
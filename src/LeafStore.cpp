@@ -3,3 +3,19 @@
 LeafStore::~LeafStore() {
 }
 
+
+unsigned LeafStore::valueMismatch(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const {
+  std::string value = getValue(leafValue);
+  unsigned pos = from;
+  for (; pos < to && pos < value.size(); pos++) {
+    if (static_cast<uint8_t>(value[pos]) != key[pos]) {
+      return pos;
+    }
+  }
+  for (; pos < to; pos++) {
+    if (key[pos] != 0) {
+      return pos;
+    }
+  }
+  return pos;
+}
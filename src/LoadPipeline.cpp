@@ -0,0 +1,260 @@
+#include "LoadPipeline.hpp"
+#include "ExternalSorter.hpp"
+#include "RecentTermCache.hpp"
+#include "rdf3x/TurtleParser.hpp"
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+  /**
+   * Remembers the first exception thrown by any stage.
+   */
+  class ErrorState {
+    private:
+      std::mutex mutex;
+      std::exception_ptr error;
+
+    public:
+      void set(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+          error = e;
+        }
+      }
+
+      void rethrow() {
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+  };
+
+  template<size_t TSize>
+  inline uint64_t encodeCached(const std::string& term, RecentTermCache<TSize>& cache, ConcurrentEncoder& encoder, uint64_t& cacheHits) {
+    uint64_t id;
+    if (cache.lookup(term, id)) {
+      cacheHits++;
+      return id;
+    }
+    id = encoder.encode(term);
+    cache.insert(term, id);
+    return id;
+  }
+}
+
+const size_t LoadPipeline::chunkSize;
+
+LoadPipeline::LoadPipeline(Dictionary* dict, size_t encoders, size_t batch, size_t capacity, uint64_t sortMemory) : dictionary(dict), numberOfEncoders(encoders), batchSize(batch), queueCapacity(capacity), sortMemoryBudget(sortMemory) {
+}
+
+LoadPipeline::Statistics LoadPipeline::run(std::istream& turtleStream, const std::string& tripleFileName) {
+  Statistics statistics;
+  ConcurrentEncoder encoder;
+  std::atomic<uint64_t> cacheHits(0);
+  std::atomic<size_t> runningEncoders(numberOfEncoders);
+  TermQueue termQueue(queueCapacity);
+  IdQueue idQueue(queueCapacity);
+  // Batches parsed but not written yet
+  Semaphore window(queueCapacity + numberOfEncoders);
+  ErrorState errorState;
+  const std::string tempFileName = tripleFileName + ".tmp";
+
+  auto stage = [&](std::function<void()> body) {
+    try {
+      body();
+    }
+    catch (...) {
+      errorState.set(std::current_exception());
+      // Unblock the other stages
+      termQueue.close();
+      idQueue.close();
+      window.close();
+    }
+  };
+
+  std::thread parseThread(stage, [&] { parse(turtleStream, termQueue, window, statistics); });
+  std::vector<std::thread> encodeThreads;
+  for (size_t i = 0; i < numberOfEncoders; i++) {
+    encodeThreads.push_back(std::thread(stage, [&] {
+      encode(termQueue, idQueue, encoder, cacheHits);
+      if (--runningEncoders == 0) {
+        idQueue.close();
+      }
+    }));
+  }
+  stage([&] { write(idQueue, window, tempFileName, statistics); });
+
+  parseThread.join();
+  for (auto& thread : encodeThreads) {
+    thread.join();
+  }
+  statistics.cacheHits = cacheHits;
+
+  try {
+    errorState.rethrow();
+
+    ExternalSorter sortedTerms(sortMemoryBudget);
+    std::vector<uint64_t> finalIds;
+    encoder.finish(sortedTerms, finalIds);
+    statistics.terms = finalIds.size();
+
+    if (dictionary->numbersByRank()) {
+      dictionary->bulkInsert(sortedTerms, chunkSize);
+    }
+    else {
+      // Dictionaries that don't number the terms by their rank, e.g. because
+      // they encode some of them in the ID, are asked for the IDs. They
+      // transform the values before loading them, so they can only be bulk
+      // loaded at once, and the terms have to be kept in memory.
+      std::vector<std::string> terms;
+      terms.reserve(finalIds.size());
+      std::string term;
+      while (sortedTerms.next(term)) {
+        terms.push_back(term);
+      }
+      dictionary->bulkInsert(terms.size(), terms.data());
+
+      std::vector<uint64_t> rankIds(terms.size());
+      for (size_t i = 0; i < terms.size(); i++) {
+        if (!dictionary->lookup(terms[i], rankIds[i])) {
+          throw Exception("Term not found after bulk loading: " + terms[i]);
+        }
+      }
+      for (auto& id : finalIds) {
+        id = rankIds[id-1];
+      }
+    }
+
+    statistics.sortRuns = sortedTerms.numberOfRuns();
+
+    remap(tempFileName, tripleFileName, finalIds);
+  }
+  catch (...) {
+    std::remove(tempFileName.c_str());
+    throw;
+  }
+  std::remove(tempFileName.c_str());
+
+  return statistics;
+}
+
+void LoadPipeline::parse(std::istream& turtleStream, TermQueue& output, Semaphore& window, Statistics& statistics) {
+  TurtleParser parser(turtleStream);
+  std::vector<TermTriple> batch;
+  batch.reserve(batchSize);
+  uint64_t batchNumber = 0;
+
+  std::string subject, predicate, object, objectSubType;
+  Type::ID objectType;
+  while (true) {
+    try {
+      if (!parser.parse(subject, predicate, object, objectType, objectSubType)) {
+        break;
+      }
+    }
+    catch (const TurtleParser::Exception& e) {
+      std::cerr << e.message << std::endl;
+      statistics.parseErrors++;
+      // recover...
+      while (turtleStream.good() && turtleStream.get() != '\n') ;
+      if (!turtleStream.good()) {
+        break;
+      }
+      continue;
+    }
+
+    batch.push_back(TermTriple { subject, predicate, object });
+    if (batch.size() == batchSize) {
+      if (!window.acquire() || !output.push(make_pair(batchNumber++, std::move(batch)))) {
+        return;
+      }
+      batch = std::vector<TermTriple>();
+      batch.reserve(batchSize);
+    }
+  }
+
+  if (!batch.empty() && window.acquire()) {
+    output.push(make_pair(batchNumber++, std::move(batch)));
+  }
+  output.close();
+}
+
+void LoadPipeline::encode(TermQueue& input, IdQueue& output, ConcurrentEncoder& encoder, std::atomic<uint64_t>& cacheHits) {
+  RecentTermCache<4> subjects, predicates, objects;
+  uint64_t localCacheHits = 0;
+  TermBatch batch;
+
+  while (input.pop(batch)) {
+    std::vector<IdTriple> ids;
+    ids.reserve(batch.second.size());
+    for (const auto& triple : batch.second) {
+      ids.push_back(IdTriple {{
+        encodeCached(triple.subject, subjects, encoder, localCacheHits),
+        encodeCached(triple.predicate, predicates, encoder, localCacheHits),
+        encodeCached(triple.object, objects, encoder, localCacheHits)
+      }});
+    }
+
+    if (!output.push(make_pair(batch.first, std::move(ids)))) {
+      break;
+    }
+  }
+  cacheHits += localCacheHits;
+}
+
+void LoadPipeline::write(IdQueue& input, Semaphore& window, const std::string& fileName, Statistics& statistics) {
+  std::ofstream stream(fileName, std::ios::binary | std::ios::trunc);
+  if (!stream) {
+    throw Exception("Could not create triple file " + fileName);
+  }
+
+  // Batches that overtook an earlier one; at most one window
+  std::map<uint64_t, std::vector<IdTriple>> pending;
+  uint64_t nextBatch = 0;
+  IdBatch batch;
+  while (input.pop(batch)) {
+    pending.insert(std::move(batch));
+
+    // Write all batches that are next in input order
+    for (auto it = pending.begin(); it != pending.end() && it->first == nextBatch; it = pending.erase(it)) {
+      stream.write(reinterpret_cast<const char*>(it->second.data()), it->second.size() * sizeof(IdTriple));
+      statistics.triples += it->second.size();
+      nextBatch++;
+      window.release();
+    }
+  }
+
+  if (!stream) {
+    throw Exception("Could not write triple file " + fileName);
+  }
+}
+
+void LoadPipeline::remap(const std::string& inputFileName, const std::string& outputFileName, const std::vector<uint64_t>& finalIds) {
+  std::ifstream input(inputFileName, std::ios::binary);
+  std::ofstream output(outputFileName, std::ios::binary | std::ios::trunc);
+  if (!input || !output) {
+    throw Exception("Could not open triple files for remapping");
+  }
+
+  std::vector<IdTriple> block(batchSize);
+  while (input) {
+    input.read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(IdTriple));
+    size_t count = static_cast<size_t>(input.gcount()) / sizeof(IdTriple);
+    for (size_t i = 0; i < count; i++) {
+      for (auto& id : block[i]) {
+        id = finalIds[id];
+      }
+    }
+    output.write(reinterpret_cast<const char*>(block.data()), count * sizeof(IdTriple));
+  }
+
+  if (!output) {
+    throw Exception("Could not write triple file " + outputFileName);
+  }
+}
@@ -0,0 +1,97 @@
+#include "NodeArena.hpp"
+#include "Exception.hpp"
+#include <new>
+#include <sys/mman.h>
+
+NodeArena::NodeArena(bool huge) : hugePages(huge), slabPtr(nullptr), slabRemaining(0) {
+  freeLists.fill(nullptr);
+}
+
+NodeArena::NodeArena(NodeArena&& other) : hugePages(other.hugePages), slabs(std::move(other.slabs)), slabPtr(other.slabPtr), slabRemaining(other.slabRemaining), freeLists(other.freeLists) {
+  other.slabs.clear();
+  other.slabPtr = nullptr;
+  other.slabRemaining = 0;
+  other.freeLists.fill(nullptr);
+}
+
+NodeArena::~NodeArena() {
+  for (void* slab : slabs) {
+    munmap(slab, slabSize);
+  }
+}
+
+void NodeArena::newSlab() {
+  void* slab = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  if (hugePages) {
+    // Explicit huge pages need to be reserved by the administrator
+    slab = mmap(nullptr, slabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+
+  if (slab == MAP_FAILED) {
+    if (hugePages) {
+      // Transparent huge pages need 2 MB alignment; over-allocate and trim
+      char* area = static_cast<char*>(mmap(nullptr, 2 * slabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (area == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      uintptr_t offset = reinterpret_cast<uintptr_t>(area) % slabSize;
+      char* aligned = offset == 0 ? area : area + (slabSize - offset);
+      if (aligned != area) {
+        munmap(area, static_cast<size_t>(aligned - area));
+      }
+      munmap(aligned + slabSize, slabSize - static_cast<size_t>(aligned - area));
+      slab = aligned;
+#ifdef MADV_HUGEPAGE
+      madvise(slab, slabSize, MADV_HUGEPAGE);
+#endif
+    }
+    else {
+      slab = mmap(nullptr, slabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (slab == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+    }
+  }
+
+  slabs.push_back(slab);
+  slabPtr = static_cast<char*>(slab);
+  slabRemaining = slabSize;
+}
+
+void* NodeArena::allocate(size_t size) {
+  if (size > maxNodeSize) {
+    throw Exception("Node too large for arena: " + std::to_string(size));
+  }
+
+  size_t index = sizeClass(size);
+  FreeNode* freeNode = freeLists[index];
+  if (freeNode != nullptr) {
+    freeLists[index] = freeNode->next;
+    return freeNode;
+  }
+
+  size_t classSize = index * granularity;
+  if (classSize > slabRemaining) {
+    // The rest of the slab is wasted; at most maxNodeSize per slab
+    newSlab();
+  }
+
+  void* node = slabPtr;
+  slabPtr += classSize;
+  slabRemaining -= classSize;
+  return node;
+}
+
+void NodeArena::deallocate(void* node, size_t size) {
+  size_t index = sizeClass(size);
+  FreeNode* freeNode = static_cast<FreeNode*>(node);
+  freeNode->next = freeLists[index];
+  freeLists[index] = freeNode;
+}
+
+uint64_t NodeArena::reservedMemory() const {
+  return slabs.size() * slabSize;
+}
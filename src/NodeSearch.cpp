@@ -0,0 +1,150 @@
+#include "NodeSearch.hpp"
+#include <cstring>
+#include <emmintrin.h> // x86 SSE intrinsics
+#include <immintrin.h> // x86 AVX intrinsics
+
+namespace nodesearch {
+  namespace {
+    inline uint16_t countMask16(unsigned count) {
+      return static_cast<uint16_t>(0xFFFF >> (16 - count));
+    }
+
+    inline unsigned keyMask16(const uint8_t keys[16], unsigned count, __m128i (*compare)(__m128i, __m128i), uint8_t flippedKeyByte) {
+      __m128i cmp = compare(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), _mm_set1_epi8(static_cast<char>(flippedKeyByte)));
+      return static_cast<unsigned>(_mm_movemask_epi8(cmp)) & countMask16(count);
+    }
+
+    inline __m128i equal(__m128i a, __m128i b) {
+      return _mm_cmpeq_epi8(a, b);
+    }
+
+    inline __m128i greater(__m128i a, __m128i b) {
+      return _mm_cmpgt_epi8(a, b);
+    }
+
+    inline __m128i lower(__m128i a, __m128i b) {
+      return _mm_cmplt_epi8(a, b);
+    }
+
+    // Child index scans; blocks are aligned to the block width relative to
+    // the start of the child index, so no block crosses its end
+
+    inline uint64_t belowMask(unsigned bits) {
+      return bits >= 64 ? ~0ull : (1ull << bits) - 1;
+    }
+
+    unsigned nextScalar(const uint8_t childIndex[256], unsigned from, uint8_t emptyMarker) {
+      for (unsigned i = from; i < 256; i++) {
+        if (childIndex[i] != emptyMarker) {
+          return i;
+        }
+      }
+      return 256;
+    }
+
+    unsigned previousScalar(const uint8_t childIndex[256], unsigned to, uint8_t emptyMarker) {
+      for (unsigned i = to; i > 0; i--) {
+        if (childIndex[i-1] != emptyMarker) {
+          return i-1;
+        }
+      }
+      return 256;
+    }
+
+    inline uint64_t occupied16(const uint8_t* block, uint8_t emptyMarker) {
+      __m128i cmp = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), _mm_set1_epi8(static_cast<char>(emptyMarker)));
+      return ~static_cast<uint64_t>(_mm_movemask_epi8(cmp)) & 0xFFFF;
+    }
+
+    __attribute__((target("avx2")))
+    inline uint64_t occupied32(const uint8_t* block, uint8_t emptyMarker) {
+      __m256i cmp = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), _mm256_set1_epi8(static_cast<char>(emptyMarker)));
+      return ~static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(cmp))) & 0xFFFFFFFF;
+    }
+
+    __attribute__((target("avx512f,avx512bw")))
+    inline uint64_t occupied64(const uint8_t* block, uint8_t emptyMarker) {
+      return _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(block), _mm512_set1_epi8(static_cast<char>(emptyMarker)));
+    }
+
+#define NODESEARCH_SCAN_KERNELS(SUFFIX, TARGET, WIDTH) \
+    TARGET \
+    unsigned next##SUFFIX(const uint8_t childIndex[256], unsigned from, uint8_t emptyMarker) { \
+      for (unsigned base = from & ~(WIDTH-1u); base < 256; base += WIDTH) { \
+        uint64_t mask = occupied##WIDTH(childIndex + base, emptyMarker); \
+        if (base < from) { \
+          mask &= ~belowMask(from - base); \
+        } \
+        if (mask) { \
+          return base + static_cast<unsigned>(__builtin_ctzll(mask)); \
+        } \
+      } \
+      return 256; \
+    } \
+    TARGET \
+    unsigned previous##SUFFIX(const uint8_t childIndex[256], unsigned to, uint8_t emptyMarker) { \
+      for (unsigned end = (to + WIDTH-1u) & ~(WIDTH-1u); end > 0; end -= WIDTH) { \
+        unsigned base = end - WIDTH; \
+        uint64_t mask = occupied##WIDTH(childIndex + base, emptyMarker); \
+        if (to < end) { \
+          mask &= belowMask(to - base); \
+        } \
+        if (mask) { \
+          return base + 63 - static_cast<unsigned>(__builtin_clzll(mask)); \
+        } \
+      } \
+      return 256; \
+    }
+
+    NODESEARCH_SCAN_KERNELS(SSE2, , 16)
+    NODESEARCH_SCAN_KERNELS(AVX2, __attribute__((target("avx2"))), 32)
+    NODESEARCH_SCAN_KERNELS(AVX512, __attribute__((target("avx512f,avx512bw"))), 64)
+
+#undef NODESEARCH_SCAN_KERNELS
+
+    std::vector<OccupancyKernel> detectKernels() {
+      std::vector<OccupancyKernel> kernels;
+      kernels.push_back(OccupancyKernel { "scalar", nextScalar, previousScalar });
+      kernels.push_back(OccupancyKernel { "sse2", nextSSE2, previousSSE2 });
+
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(OccupancyKernel { "avx2", nextAVX2, previousAVX2 });
+      }
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        kernels.push_back(OccupancyKernel { "avx512", nextAVX512, previousAVX512 });
+      }
+      return kernels;
+    }
+  }
+
+  unsigned find4(const uint8_t keys[4], unsigned count, uint8_t keyByte) {
+    // Zero bytes of keys^keyByte are matches; the lowest flagged byte is always exact
+    uint32_t word;
+    memcpy(&word, keys, sizeof(word));
+    word ^= keyByte * 0x01010101u;
+    uint32_t mask = (word - 0x01010101u) & ~word & 0x80808080u;
+    mask &= count >= 4 ? ~0u : (1u << (8*count)) - 1;
+    return mask ? static_cast<unsigned>(__builtin_ctz(mask)) / 8 : count;
+  }
+
+  unsigned find16(const uint8_t keys[16], unsigned count, uint8_t flippedKeyByte) {
+    unsigned mask = keyMask16(keys, count, equal, flippedKeyByte);
+    return mask ? static_cast<unsigned>(__builtin_ctz(mask)) : count;
+  }
+
+  unsigned greater16(const uint8_t keys[16], unsigned count, uint8_t flippedKeyByte) {
+    unsigned mask = keyMask16(keys, count, greater, flippedKeyByte);
+    return mask ? static_cast<unsigned>(__builtin_ctz(mask)) : count;
+  }
+
+  unsigned lower16(const uint8_t keys[16], unsigned count, uint8_t flippedKeyByte) {
+    unsigned mask = keyMask16(keys, count, lower, flippedKeyByte);
+    return mask ? 31 - static_cast<unsigned>(__builtin_clz(mask)) : count;
+  }
+
+  const std::vector<OccupancyKernel>& supportedKernels() {
+    static const std::vector<OccupancyKernel> kernels = detectKernels();
+    return kernels;
+  }
+}
@@ -2,8 +2,8 @@
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
 PageIterator<TLeaf> OffsetStrategy<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(uint64_t leafValue) const {
-  TLeaf* leaf = reinterpret_cast<TLeaf*>(leafValue >> 16);
-  uint16_t offset = leafValue & 0xFFFF;
+  TLeaf* leaf = this->decodeLeafPointer(leafValue);
+  uint16_t offset = this->decodeAdditionalValue(leafValue);
 
   return leaf->getByOffset(offset);
 }
@@ -0,0 +1,260 @@
+#include "PerfectHash.hpp"
+#include "Exception.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <thread>
+
+namespace {
+  // Bits per remaining key on every level (BBHash's gamma); 1 gives the smallest function
+  const double gammaFactor = 1.0;
+  // Keys that still collide after the last level are stored explicitly
+  const unsigned maxLevels = 32;
+  // Number of bits covered by one rank entry
+  const uint64_t blockBits = 512;
+  // Smaller levels are built by the calling thread alone
+  const uint64_t minParallelKeys = 1 << 16;
+  const uint64_t unplaced = ~0ull;
+
+  inline uint64_t levelHash(uint64_t hash, unsigned level) {
+    // MurmurHash3 finalizer of the key hash, seeded with the level
+    hash ^= (level + 1) * 0x9e3779b97f4a7c15ull;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  inline uint64_t reduce(uint64_t hash, uint64_t size) {
+    // Maps the hash to [0, size) without a division
+    return static_cast<uint64_t>((static_cast<__uint128_t>(hash) * size) >> 64);
+  }
+
+  /**
+   * Runs body(from, to) on disjoint ranges covering [0, count), one per core.
+   */
+  void parallelFor(uint64_t count, const std::function<void(uint64_t, uint64_t)>& body) {
+    const uint64_t numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+    if (count < minParallelKeys || numberOfThreads == 1) {
+      body(0, count);
+      return;
+    }
+
+    std::vector<std::thread> threads;
+    const uint64_t chunkSize = (count + numberOfThreads - 1) / numberOfThreads;
+    for (uint64_t from = 0; from < count; from += chunkSize) {
+      threads.push_back(std::thread(body, from, std::min(count, from + chunkSize)));
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+}
+
+// Generic implementations
+
+template<class TKey>
+PerfectHash<TKey>::PerfectHash(LeafStore* store) : leafStore(store), frozen(false), leafValueBits(1) {
+}
+
+template<class TKey>
+std::string PerfectHash<TKey>::description() {
+  return "PerfectHash";
+}
+
+template<class TKey>
+void PerfectHash<TKey>::insert(TKey key, uint64_t value) {
+  if (frozen) {
+    throw Exception("Perfect hash index is read-only");
+  }
+  pendingHashes.push_back(FingerprintHash<TKey>::hashKey(key));
+  pendingValues.push_back(value);
+}
+
+template<class TKey>
+bool PerfectHash<TKey>::isFrozen() const {
+  return frozen;
+}
+
+template<class TKey>
+uint64_t PerfectHash<TKey>::frozenSize() const {
+  return (bits.size() + levelOffsets.size() + ranks.size() + leafValues.size()) * sizeof(uint64_t)
+    + fallback.size() * sizeof(std::pair<uint64_t, uint64_t>);
+}
+
+template<class TKey>
+void PerfectHash<TKey>::freeze() {
+  if (frozen) {
+    return;
+  }
+
+  const uint64_t numberOfKeys = pendingHashes.size();
+  std::vector<uint64_t> keys(numberOfKeys);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<uint64_t> positions(numberOfKeys);
+
+  for (unsigned level = 0; level < maxLevels && !keys.empty(); level++) {
+    const uint64_t levelWords = std::max<uint64_t>(1, (static_cast<uint64_t>(keys.size() * gammaFactor) + 63) / 64);
+    const uint64_t levelBits = levelWords * 64;
+    const uint64_t levelOffset = bits.size() * 64;
+    std::unique_ptr<std::atomic<uint64_t>[]> seen(new std::atomic<uint64_t>[levelWords]);
+    std::unique_ptr<std::atomic<uint64_t>[]> collisions(new std::atomic<uint64_t>[levelWords]);
+    for (uint64_t word = 0; word < levelWords; word++) {
+      seen[word].store(0, std::memory_order_relaxed);
+      collisions[word].store(0, std::memory_order_relaxed);
+    }
+
+    parallelFor(keys.size(), [&](uint64_t from, uint64_t to) {
+      for (uint64_t i = from; i < to; i++) {
+        const uint64_t position = reduce(levelHash(pendingHashes[keys[i]], level), levelBits);
+        const uint64_t mask = 1ull << (position % 64);
+        if (seen[position / 64].fetch_or(mask, std::memory_order_relaxed) & mask) {
+          collisions[position / 64].fetch_or(mask, std::memory_order_relaxed);
+        }
+        positions[keys[i]] = levelOffset + position;
+      }
+    });
+
+    // Positions hit by exactly one key are final; the other keys go to the next level
+    levelOffsets.push_back(levelOffset);
+    for (uint64_t word = 0; word < levelWords; word++) {
+      bits.push_back(seen[word].load(std::memory_order_relaxed) & ~collisions[word].load(std::memory_order_relaxed));
+    }
+    std::vector<uint64_t> remainingKeys;
+    for (uint64_t key : keys) {
+      if (!(bits[positions[key] / 64] & (1ull << (positions[key] % 64)))) {
+        remainingKeys.push_back(key);
+      }
+    }
+    keys.swap(remainingKeys);
+  }
+  levelOffsets.push_back(bits.size() * 64);
+
+  for (uint64_t key : keys) {
+    fallback.push_back(std::make_pair(pendingHashes[key], pendingValues[key]));
+    positions[key] = unplaced;
+  }
+  std::sort(fallback.begin(), fallback.end());
+
+  uint64_t setBits = 0;
+  for (uint64_t word = 0; word < bits.size(); word++) {
+    if (word % (blockBits / 64) == 0) {
+      ranks.push_back(setBits);
+    }
+    setBits += static_cast<uint64_t>(__builtin_popcountll(bits[word]));
+  }
+
+  // Order the values in parallel, then pack them; neighbouring values share words
+  std::vector<uint64_t> rankedValues(setBits);
+  parallelFor(numberOfKeys, [&](uint64_t from, uint64_t to) {
+    for (uint64_t key = from; key < to; key++) {
+      if (positions[key] != unplaced) {
+        rankedValues[rank(positions[key])] = pendingValues[key];
+      }
+    }
+  });
+
+  const uint64_t maxValue = rankedValues.empty() ? 0 : *std::max_element(rankedValues.begin(), rankedValues.end());
+  leafValueBits = maxValue == 0 ? 1 : 64 - static_cast<unsigned>(__builtin_clzll(maxValue));
+  leafValues.assign((setBits * leafValueBits + 63) / 64, 0);
+  for (uint64_t i = 0; i < setBits; i++) {
+    const uint64_t bit = i * leafValueBits;
+    leafValues[bit / 64] |= rankedValues[i] << (bit % 64);
+    if (bit % 64 + leafValueBits > 64) {
+      leafValues[bit / 64 + 1] |= rankedValues[i] >> (64 - bit % 64);
+    }
+  }
+
+  frozen = true;
+  std::vector<uint64_t>().swap(pendingHashes);
+  std::vector<uint64_t>().swap(pendingValues);
+}
+
+template<class TKey>
+uint64_t PerfectHash<TKey>::rank(uint64_t position) const {
+  // Number of set bits before the position
+  const uint64_t block = position / blockBits;
+  uint64_t result = ranks[block];
+  for (uint64_t word = block * (blockBits / 64); word < position / 64; word++) {
+    result += static_cast<uint64_t>(__builtin_popcountll(bits[word]));
+  }
+  return result + static_cast<uint64_t>(__builtin_popcountll(bits[position / 64] & ((1ull << (position % 64)) - 1)));
+}
+
+template<class TKey>
+uint64_t PerfectHash<TKey>::leafValueAt(uint64_t index) const {
+  const uint64_t bit = index * leafValueBits;
+  uint64_t value = leafValues[bit / 64] >> (bit % 64);
+  if (bit % 64 + leafValueBits > 64) {
+    value |= leafValues[bit / 64 + 1] << (64 - bit % 64);
+  }
+  return leafValueBits == 64 ? value : value & ((1ull << leafValueBits) - 1);
+}
+
+template<class TKey>
+bool PerfectHash<TKey>::lookup(TKey key, uint64_t& value) const {
+  const uint64_t hash = FingerprintHash<TKey>::hashKey(key);
+  if (!frozen) {
+    // Not meant for lookups yet, so a scan is enough
+    for (uint64_t i = 0; i < pendingHashes.size(); i++) {
+      if (pendingHashes[i] == hash && leafMatches(pendingValues[i], key)) {
+        value = pendingValues[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  for (unsigned level = 0; level + 1 < levelOffsets.size(); level++) {
+    const uint64_t levelBits = levelOffsets[level + 1] - levelOffsets[level];
+    const uint64_t position = levelOffsets[level] + reduce(levelHash(hash, level), levelBits);
+    if (bits[position / 64] & (1ull << (position % 64))) {
+      // The only key that can be stored here
+      const uint64_t leafValue = leafValueAt(rank(position));
+      if (!leafMatches(leafValue, key)) {
+        return false;
+      }
+      value = leafValue;
+      return true;
+    }
+  }
+
+  auto it = std::lower_bound(fallback.begin(), fallback.end(), std::make_pair(hash, uint64_t(0)));
+  for (; it != fallback.end() && it->first == hash; it++) {
+    if (leafMatches(it->second, key)) {
+      value = it->second;
+      return true;
+    }
+  }
+  return false;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+template<class TKey>
+std::pair<uint64_t, uint64_t> PerfectHash<TKey>::rangeLookup(TKey prefix) const {
+  throw Exception("PerfectHash does not support range lookups");
+}
+#pragma GCC diagnostic pop
+
+// uint64_t implementations
+
+template<>
+bool PerfectHash<uint64_t>::leafMatches(uint64_t leafValue, const uint64_t& key) const {
+  return leafStore->getId(leafValue) == key;
+}
+
+// std::string implementations
+
+template<>
+bool PerfectHash<std::string>::leafMatches(uint64_t leafValue, const std::string& key) const {
+  // Include the NULL terminator, so prefixes of the value do not match
+  const unsigned keyLength = static_cast<unsigned>(key.size() + 1);
+  return leafStore->valueMismatch(leafValue, reinterpret_cast<const uint8_t*>(key.c_str()), 0, keyLength) == keyLength;
+}
+
+template class PerfectHash<uint64_t>;
+template class PerfectHash<std::string>;
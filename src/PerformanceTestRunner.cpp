@@ -2,6 +2,7 @@
 #include <boost/algorithm/string.hpp>
 #include <cstdlib>
 #include <fstream>
+#include <random>
 #include <string>
 #include <ctime>
 #include <sys/wait.h>
@@ -12,6 +13,7 @@
 #include "rdf3x/TurtleParser.hpp"
 
 #include "StringDictionary.hpp"
+#include "NamespaceDictionary.hpp"
 #include "SimpleDictionary.hpp"
 #include "Indexes.hpp"
 #include "Pages.hpp"
@@ -41,6 +43,7 @@ template<bool check>
 inline void lookup(Dictionary*, vector<uint64_t>&);
 template<bool check>
 inline void lookup(Dictionary*, vector<string>&);
+inline void lookupMissing(Dictionary*, vector<string>&);
 inline void rangeLookup(Dictionary*, vector<string>&, vector<pair<uint64_t, string>>&, bool check);
 
 inline float diff(clock_t start);
@@ -56,7 +59,7 @@ class MicroTestLeafStore : public LeafStore {
 };
 
 std::string MicroTestLeafStore::getValue(uint64_t leafValue) const {
-  return values[leafValue-1];
+  return values[leafValue];
 }
 
 uint64_t MicroTestLeafStore::getId(uint64_t leafValue) const {
@@ -79,6 +82,7 @@ void runMicroStringTest(MicroTestLeafStore& leafStore, vector<string>& uniqueVal
     for (uint64_t i = 0; i < numberOfUniqueValues; i++) {
       reverseIndex.insert(uniqueValues[i], i);
     }
+    FreezeHelper<TIndex<string>>::freeze(reverseIndex);
     df = diff(start);
     cout << numberOfUniqueValues/df << "\t";
 
@@ -120,8 +124,9 @@ void runMicroIdTest(MicroTestLeafStore& leafStore, uint64_t numberOfUniqueValues
 
     start = clock();
     for (uint64_t i = 0; i < numberOfUniqueValues; i++) {
-      index.insert(i, i);
+      index.insert(i+1, i+1);
     }
+    FreezeHelper<TIndex<uint64_t>>::freeze(index);
     df = diff(start);
     cout << numberOfUniqueValues/df << "\t";
 
@@ -170,18 +175,24 @@ void MicroTestRunner::run(istream& tupleStream) {
   runMicroIdTest<BTree, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
   runMicroIdTest<BPlusTree, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
   runMicroIdTest<ART, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
+  runMicroIdTest<FingerprintART, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
   runMicroIdTest<RedBlack, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
   runMicroIdTest<Hash, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
+  runMicroIdTest<FingerprintHash, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
+  runMicroIdTest<PerfectHash, numberOfOperations>(leafStore, numberOfUniqueValues, lookupIDs);
 
   std::cout << "String:" << std::endl;
   std::cout << "name\tbulk_load\tmemory\tlookup" << std::endl;
   // String tests
   runMicroStringTest<ART, numberOfOperations>(leafStore, uniqueValues, lookupValues);
+  runMicroStringTest<FingerprintART, numberOfOperations>(leafStore, uniqueValues, lookupValues);
   runMicroStringTest<HAT, numberOfOperations>(leafStore, uniqueValues, lookupValues);
   runMicroStringTest<BTree, numberOfOperations>(leafStore, uniqueValues, lookupValues);
   runMicroStringTest<BPlusTree, numberOfOperations>(leafStore, uniqueValues, lookupValues);
   runMicroStringTest<RedBlack, numberOfOperations>(leafStore, uniqueValues, lookupValues);
   runMicroStringTest<Hash, numberOfOperations>(leafStore, uniqueValues, lookupValues);
+  runMicroStringTest<FingerprintHash, numberOfOperations>(leafStore, uniqueValues, lookupValues);
+  runMicroStringTest<PerfectHash, numberOfOperations>(leafStore, uniqueValues, lookupValues);
 }
 
 class ArtLeafStore : public LeafStore {
@@ -247,6 +258,7 @@ void ArtLeafRunner::run(istream& tupleStream) {
     ArtLeafStore artLeafStore;
     ART<uint64_t> index(&artLeafStore);
     HAT<std::string> reverseIndex;
+    PageArena<SingleUncompressedPage<1024*4>> pages;
 
     cout << "Independent" << "\t";
 
@@ -269,13 +281,13 @@ void ArtLeafRunner::run(istream& tupleStream) {
         leafValue = leafValue <<16;
         leafValue |= static_cast<uint64_t>(offset);
         index.insert(id, leafValue);
-        });
+        }, pages);
     SingleUncompressedPage<1024*4>::load(pairs, [&reverseIndex](SingleUncompressedPage<1024*4>* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
         uint64_t leafValue = reinterpret_cast<uint64_t>(page);
         leafValue = leafValue <<16;
         leafValue |= static_cast<uint64_t>(offset);
         reverseIndex.insert(value, leafValue);
-        });
+        }, pages);
 #pragma GCC diagnostic pop
 
     df = diff(start);
@@ -356,10 +368,13 @@ void PerformanceTestRunner::run(istream& tupleStream) {
 
   vector<uint64_t> valueLookupIDs = getRandomIDs(numberOfOperations, 1, numberOfUniqueValues);
   vector<string> lookupValues = getValues(valueLookupIDs, uniqueValues);
+  vector<uint64_t> missingValueLookupIDs = getRandomIDs(numberOfOperations, 1, numberOfUniqueValues);
+  vector<string> missingLookupValues = getNonExistingValues(missingValueLookupIDs, uniqueValues);
   valueLookupIDs.clear();
+  missingValueLookupIDs.clear();
   uniqueValues.clear();
 
-  std::cout << "name\tbulk_load\tmemory\tnumber_of_pages\tlookup_id\tlookup_string" << std::endl;
+  std::cout << "name\tbulk_load\tmemory\tnumber_of_pages\tlookup_id\tlookup_string\tlookup_missing_string" << std::endl;
 
   // Load data from into all dictionaries in succession
   for (char counter = 0; hasDictionary(counter); counter++) {
@@ -394,6 +409,11 @@ void PerformanceTestRunner::run(istream& tupleStream) {
       df = diff(start);
       cout << numberOfOperations/df << "\t";
 
+      start = clock();
+      lookupMissing(dict, missingLookupValues);
+      df = diff(start);
+      cout << numberOfOperations/df << "\t";
+
       cout << endl;
 
       delete dict;
@@ -407,7 +427,7 @@ void PerformanceTestRunner::run(istream& tupleStream) {
 }
 
 inline bool hasDictionary(char counter) {
-  return counter < 7;
+  return counter < 14;
 }
 
 inline Dictionary* getDictionary(char counter) {
@@ -426,6 +446,20 @@ inline Dictionary* getDictionary(char counter) {
       return new StringDictionary<ART, HAT, SingleUncompressedPage<(1024<<5)>>();
     case 6:
       return new StringDictionary<ART, HAT, SingleUncompressedPage<(1024<<6)>>();
+    case 7:
+      return new StringDictionary<DenseIndex, HAT, SingleUncompressedPage<(1024<<4)>>();
+    case 8:
+      return new StringDictionary<ART, HAT, SingleUncompressedPage<(1024<<4)>, OffsetStrategy, BloomFilter>();
+    case 9:
+      return new StringDictionary<ART, HAT, ImplicitIdPage<(1024<<4)>, IndirectStrategy>();
+    case 10:
+      return new StringDictionary<ART, HAT, ImplicitIdPage<(1024<<4), page::PackedLayout>, IndirectStrategy>();
+    case 11:
+      return new StringDictionary<ART, SART, PaxPage<(1024<<4)>, BottomUpStrategy>();
+    case 12:
+      return new StringDictionary<ART, HAT, RestartPage<(1024<<6), 16>, DeltaStrategy>();
+    case 13:
+      return new NamespaceDictionary<StringDictionary<ART, HAT, SingleUncompressedPage<(1024<<4)>>>();
   }
   throw;
 }
@@ -549,6 +583,15 @@ assert(id == pair.first);
 }
 #pragma GCC diagnostic pop
 
+inline void lookupMissing(Dictionary* dict, vector<string>& values) {
+  for (string& value : values) {
+    uint64_t id;
+    if (dict->lookup(value, id)) {
+      throw Exception("Entry with value " + value + " should not exist.");
+    }
+  }
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 inline void rangeLookup(Dictionary* dict, vector<string>& prefixes, vector<pair<uint64_t, string>>& lookedUpPairs, bool check) {
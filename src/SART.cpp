@@ -26,7 +26,7 @@ bool SART<std::string>::lookup(std::string key, uintptr_t& value) const {
 #ifdef DEBUG
   assert(key.size() < std::numeric_limits<unsigned>::max());
 #endif
-  Node* leaf = sartLookupValue(tree, reinterpret_cast<uint8_t*>(const_cast<char*>(key.c_str())), static_cast<unsigned>(key.size()+1), 0);
+  Node* leaf = sartLookupValue<ART>(*leafStore, tree, reinterpret_cast<uint8_t*>(const_cast<char*>(key.c_str())), static_cast<unsigned>(key.size()+1), 0);
   if (leaf == nullNode) {
     return false;
   }
@@ -37,4 +37,18 @@ bool SART<std::string>::lookup(std::string key, uintptr_t& value) const {
   return true;
 }
 
+template<>
+std::pair<uintptr_t, uintptr_t> SART<std::string>::rangeLookup(std::string prefix) const {
+#ifdef DEBUG
+  assert(prefix.size() <= std::numeric_limits<unsigned>::max());
+#endif
+
+  // Use only prefix.size() to exclude NULL terminator!
+  Node* prefixNode = sartLookupPrefix<ART>(*leafStore, tree, reinterpret_cast<uint8_t*>(const_cast<char*>((prefix.c_str()))), static_cast<unsigned>(prefix.size()), 0);
+
+  return std::make_pair(
+      getLeafValue(minimum(prefixNode)),
+      getLeafValue(maximum(prefixNode)));
+}
+
 template class SART<std::string>;
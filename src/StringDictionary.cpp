@@ -6,8 +6,8 @@
 #include <vector>
 #include "StringDictionary.hpp"
 
-template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy>
-void StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::bulkInsert(size_t size, std::string* values) {
+template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy, class TFilter>
+void StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>::bulkInsert(size_t size, std::string* values) {
 #ifdef DEBUG
   assert(nextId == 1);
 #endif
@@ -17,41 +17,74 @@ void StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::bul
 
   for (size_t i = 0; i <size; i++) {
     insertValues.push_back(make_pair(nextId++, values[i]));
+    filter.insert(values[i]);
   }
 
   typename PageLoader<TLeaf>::CallbackType callback;
   callback = std::bind(&TConstructionStrategy<TIdIndex<uint64_t>, TStringIndex<std::string>, TLeaf>::leafCallback, constructionStrategy, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4, std::placeholders::_5);
 
-  TLeaf::load(insertValues, callback);
+  TLeaf::load(insertValues, callback, arena);
+
+  FreezeHelper<TIdIndex<uint64_t>>::freeze(index);
+  FreezeHelper<TStringIndex<std::string>>::freeze(reverseIndex);
+  filter.freeze();
+}
+
+template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy, class TFilter>
+void StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>::bulkInsert(ExternalSorter& values, size_t chunkSize) {
+#ifdef DEBUG
+  assert(nextId == 1);
+  assert(chunkSize > 0);
+#endif
+
+  std::vector<std::pair<uint64_t, std::string>> insertValues;
+
+  typename PageLoader<TLeaf>::CallbackType callback = [&](TLeaf* leaf, uint16_t deltaNumber, uint16_t offset, uint64_t id, std::string value) {
+    constructionStrategy.leafCallback(leaf, deltaNumber, offset, id, value);
+  };
+
+  // One loader for all chunks, so pages continue across them
+  typename TLeaf::Loader loader(arena);
+
+  std::string value;
+  bool hasValues = values.next(value);
+  while (hasValues) {
+    insertValues.clear();
+    insertValues.reserve(chunkSize);
+    do {
+      insertValues.push_back(make_pair(nextId++, value));
+      filter.insert(value);
+      hasValues = values.next(value);
+    } while (hasValues && insertValues.size() < chunkSize);
+
+    loader.loadChunk(std::move(insertValues), callback, !hasValues);
+  }
+
+  FreezeHelper<TIdIndex<uint64_t>>::freeze(index);
+  FreezeHelper<TStringIndex<std::string>>::freeze(reverseIndex);
+  filter.freeze();
 }
 
-template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy>
-uint64_t StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::insert(std::string value) {
+template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy, class TFilter>
+uint64_t StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>::insert(std::string value) {
   //TODO: create Leaf
   //return reverseIndex.tryInsert(value, nextId);
   throw value;
 }
 
-template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy>
-bool StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::lookup(std::string value, uint64_t& id) const {
+template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy, class TFilter>
+bool StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>::lookup(std::string value, uint64_t& id) const {
+  if (!filter.mayContain(value)) {
+    return false;
+  }
+
   uint64_t leafValue;
-  if (reverseIndex.lookup(value, leafValue)) {
+  if (LookupHelper<TStringIndex<std::string>, std::string, StringDictionary>::lookup(reverseIndex, value, leafValue, *this)) {
     auto iterator = constructionStrategy.decodeLeaf(leafValue, value);
-
-#ifdef DEBUG
     if (!iterator) {
-      std::cout << "Iterator not found for " << value << "; debug." << std::endl;
-      debug();
-      std::cout << "Second lookup" << std::endl;
-      reverseIndex.lookup(value, leafValue);
-      std::cout << "---" << std::endl;
-      std::cout << "Leaf value: " << leafValue << std::endl;
-      std::cout << "---" << std::endl;
-      iterator.debug();
-      throw Exception("Iterator not found for "+value+"; debug.");
+      // Indexes like SART only locate the page that would contain the value
+      return false;
     }
-    //assert(iterator);
-#endif
 
 #ifdef DEBUG
     auto itValue = *iterator;
@@ -73,14 +106,13 @@ bool StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::loo
 
     return true;
   }
-  std::cout << "Reverse not found" << std::endl;
   return false;
 }
 
-template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy>
-bool StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::lookup(uint64_t id, std::string& value) const {
+template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy, class TFilter>
+bool StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>::lookup(uint64_t id, std::string& value) const {
   uint64_t leafValue;
-  if (index.lookup(id, leafValue)) {
+  if (LookupHelper<TIdIndex<uint64_t>, uint64_t, StringDictionary>::lookup(index, id, leafValue, *this)) {
     auto iterator = constructionStrategy.decodeLeaf(leafValue, id);
 
 #ifdef DEBUG
@@ -100,8 +132,8 @@ bool StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::loo
   return false;
 }
 
-template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy>
-void StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>::rangeLookup(std::string prefix, RangeLookupCallbackType callback) const {
+template<template<typename TId> class TIdIndex, template<typename TString> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy, class TFilter>
+void StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>::rangeLookup(std::string prefix, RangeLookupCallbackType callback) const {
   PageIterator<TLeaf> startIt, endIt;
   if (constructionStrategy.rangeLookup(prefix, startIt, endIt)) {
 
@@ -6,16 +6,43 @@
 
 template<class TKey>
 class ART : public ARTBase {
+  friend class ARTBase;
+
   protected:
-    void loadKey(uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength) const;
+    // Hooks of the ARTBase algorithms; static, so they are resolved at
+    // compile time for the tree and the store
+    template<class TStore> static void loadKey(const TStore& store, uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength);
+    template<class TStore> static unsigned keyMismatch(const TStore& store, uintptr_t leafValue, uint8_t key[], unsigned from, unsigned to);
+    static bool fingerprintMatches(uintptr_t leafValue, uint8_t key[], unsigned keyLength);
+
+    // Operations with the hooks of TTree, which may tag its leaf values
+    template<class TTree> void insertLeaf(TKey key, uintptr_t value);
+    template<class TTree, class TStore> bool lookupLeaf(TKey key, uintptr_t& value, const TStore& store) const;
+    template<class TTree> std::pair<uintptr_t, uintptr_t> rangeLookupLeaves(TKey prefix) const;
 
   public:
-    ART(LeafStore* leafStore);
+    ART(LeafStore* leafStore, bool hugePages = false);
+    ART(ART&& other) = default;
     virtual ~ART() { }
-    virtual void insert(TKey key, uintptr_t value);
-    virtual bool lookup(TKey key, uintptr_t& value) const;
+    void insert(TKey key, uintptr_t value);
+    bool lookup(TKey key, uintptr_t& value) const;
+
+    /**
+     * Looks up a key and verifies the leaf with store instead of the leaf
+     * store of the tree; both have to hold the same leaves. A store of a
+     * final type, e.g. a StringDictionary, is accessed without virtual calls.
+     */
+    template<class TStore> bool lookup(TKey key, uintptr_t& value, const TStore& store) const;
     std::pair<uintptr_t, uintptr_t> rangeLookup(TKey prefix) const;
+
+    /**
+     * Writes the tree in the layout of a FrozenART.
+     * @return Reference to the root node, frozen::emptyRoot if the tree is empty
+     */
+    uint32_t writeFrozen(std::vector<uint32_t>& nodes, std::vector<uint64_t>& leaves) const;
     static std::string description();
 };
 
+#include "../ARTSearch.cpp"
+
 #endif
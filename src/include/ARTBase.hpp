@@ -3,20 +3,28 @@
 
 #include <cstdint>
 #include "LeafStore.hpp"
+#include "NodeArena.hpp"
 #include <iostream>
+#include <vector>
 
 class ARTBase {
   protected:
     // The maximum prefix length for compressed paths stored in the
     // header, if the path is longer it is loaded from the database on
-    // demand
-    static const unsigned maxPrefixLength=9;
+    // demand; sized so that the header takes 12 bytes and a Node4 48
+    // instead of 64 (NodeArena rounds to 16 bytes, so 8 and 9 bytes cost
+    // the same). Point lookups skip prefixes and verify the leaf either way,
+    // but prefixMismatch loads the minimum leaf for paths longer than this,
+    // so range lookups, inserts and erases load more leaves than with 9.
+    // Narrowing prefixLength instead would cap the paths of long literals.
+    static const unsigned maxPrefixLength=5;
 
     static std::string ind(uint32_t indent) {
       return std::string(2*indent, ' ');
     }
   public:
-    // Shared header of all inner nodes
+    // Shared header of all inner nodes; nodes have no vtable,
+    // operations switch on the type instead
     struct Node {
       // length of the compressed path (prefix)
       uint32_t prefixLength;
@@ -28,9 +36,8 @@ class ARTBase {
       uint8_t prefix[maxPrefixLength];
 
       Node(int8_t nodeType) : prefixLength(0),count(0),type(nodeType) {}
-      virtual ~Node() {}
 
-      virtual void print(uint32_t indent);
+      void print(uint32_t indent);
 
       static inline void printChild(ARTBase::Node* child, uint32_t indent) {
         if (ARTBase::isLeaf(child)) {
@@ -50,6 +57,11 @@ class ARTBase {
     Node* tree;
     static Node* nullNode;
     LeafStore* leafStore;
+    // Owns all inner nodes; the tree is released with it
+    NodeArena arena;
+
+    template<class TNode> TNode* allocateNode();
+    template<class TNode> void freeNode(TNode* node);
 
     void insertNode4(Node4* node,Node** nodeRef,uint8_t keyByte,Node* child);
     void insertNode16(Node16* node,Node** nodeRef,uint8_t keyByte,Node* child);
@@ -59,6 +71,9 @@ class ARTBase {
     void eraseNode16(Node16* node,Node** nodeRef,Node** leafPlace);
     void eraseNode48(Node48* node,Node** nodeRef,uint8_t keyByte);
     void eraseNode256(Node256* node,Node** nodeRef,uint8_t keyByte);
+    Node* makeNode4();
+    void insertChild(Node* node,Node** nodeRef,uint8_t keyByte,Node* child);
+    void eraseChild(Node* node,Node** nodeRef,Node** leafPlace,uint8_t keyByte);
 
     void copyPrefix(Node* src,Node* dst) const;
 
@@ -67,25 +82,43 @@ class ARTBase {
     Node* minimum(Node* node) const;
     Node* maximum(Node* node) const;
     Node* lastChild(Node* node) const;
-    virtual Node* lookupPrefix(Node* node, uint8_t prefix[], unsigned prefixLength, unsigned depth) const;
-    ARTBase::Node* sartLookupPrefix(ARTBase::Node* node, uint8_t prefix[], unsigned prefixLength, unsigned depth) const;
-    bool leafMatches(Node* leaf, uint8_t key[], unsigned keyLength, unsigned depth) const;
-    virtual void loadKey(uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength) const = 0;
-    Node* lookupValue(Node* node, uint8_t key[], unsigned keyLength, unsigned depth) const;
-    Node* sartLookupValue(Node* node, uint8_t key[], unsigned keyLength, unsigned depth) const;
-    Node* lookupValuePessimistic(Node* node, uint8_t key[], unsigned keyLength, unsigned depth) const;
-    unsigned prefixMismatch(Node* node, uint8_t key[], unsigned depth, unsigned maxKeyLength) const;
-    void insertValue(Node* node,Node** nodeRef,uint8_t key[],unsigned depth,uintptr_t value, unsigned maxKeyLength);
     Node** findChild(Node* n,uint8_t keyByte) const;
     Node* secondChild(Node* n) const;
     Node** lowerThan(Node* n,uint8_t keyByte) const;
     Node** greaterThan(Node* n,uint8_t keyByte) const;
     Node* makeLeaf(uintptr_t tid) const;
-    void erase(Node* node,Node** nodeRef,uint8_t key[],unsigned keyLength,unsigned depth, unsigned maxKeyLength);
+
+    // Algorithms that compare keys with leaves. TTree provides the static
+    // hooks loadKey, keyMismatch and fingerprintMatches, so they are
+    // resolved at compile time;
+    // lookups access the leaves through store, inserts and erases through
+    // the leaf store of the tree.
+    template<class TTree, class TStore> Node* lookupPrefix(const TStore& store, Node* node, uint8_t prefix[], unsigned prefixLength, unsigned depth) const;
+    template<class TTree, class TStore> Node* sartLookupPrefix(const TStore& store, Node* node, uint8_t prefix[], unsigned prefixLength, unsigned depth) const;
+    template<class TTree, class TStore> bool leafMatches(const TStore& store, Node* leaf, uint8_t key[], unsigned keyLength, unsigned depth) const;
+    template<class TTree, class TStore> Node* lookupValue(const TStore& store, Node* node, uint8_t key[], unsigned keyLength, unsigned depth) const;
+    template<class TTree, class TStore> Node* sartLookupValue(const TStore& store, Node* node, uint8_t key[], unsigned keyLength, unsigned depth) const;
+    template<class TTree, class TStore> Node* lookupValuePessimistic(const TStore& store, Node* node, uint8_t key[], unsigned keyLength, unsigned depth) const;
+    template<class TTree, class TStore> unsigned prefixMismatch(const TStore& store, Node* node, uint8_t key[], unsigned depth) const;
+    template<class TTree> void insertValue(Node* node,Node** nodeRef,uint8_t key[],unsigned depth,uintptr_t value, unsigned maxKeyLength);
+    template<class TTree> void erase(Node* node,Node** nodeRef,uint8_t key[],unsigned keyLength,unsigned depth, unsigned maxKeyLength);
+
+    // Loads the key of a leaf, for the prefixes of a frozen tree
+    typedef void (*KeyLoader)(const LeafStore& store, uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength);
+
+    /**
+     * Writes the tree in the layout of a FrozenART.
+     * @return Reference to the root node, frozen::emptyRoot if the tree is empty
+     */
+    uint32_t writeFrozen(KeyLoader loadKey, std::vector<uint32_t>& nodes, std::vector<uint64_t>& leaves) const;
+    uint32_t writeFrozen(Node* node, unsigned depth, KeyLoader loadKey, std::vector<uint32_t>& nodes, std::vector<uint64_t>& leaves) const;
 
   protected:
-    ARTBase(LeafStore* leafStore);
+    ARTBase(LeafStore* leafStore, bool hugePages = false);
+    ARTBase(ARTBase&& other);
     virtual ~ARTBase();
 };
 
+#include "../ARTBaseSearch.cpp"
+
 #endif
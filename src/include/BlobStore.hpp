@@ -0,0 +1,72 @@
+#ifndef H_BlobStore
+#define H_BlobStore
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Append-only storage for values that are too long to be stored in a page.
+ *
+ * Each blob is stored as its size followed by its bytes. Blobs are packed
+ * into large chunks; blobs larger than a chunk get an allocation of their
+ * own. Blobs are never moved or freed, so pages refer to them by address.
+ */
+class BlobStore {
+  private:
+    static const size_t chunkSize = 2 << 20;
+
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* chunkPtr;
+    size_t chunkRemaining;
+
+    char* allocate(size_t size) {
+      // Keep the size fields aligned
+      size = (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+      if (size > chunkSize / 4) {
+        chunks.emplace_back(new char[size]);
+        return chunks.back().get();
+      }
+      if (size > chunkRemaining) {
+        chunks.emplace_back(new char[chunkSize]);
+        chunkPtr = chunks.back().get();
+        chunkRemaining = chunkSize;
+      }
+      char* blob = chunkPtr;
+      chunkPtr += size;
+      chunkRemaining -= size;
+      return blob;
+    }
+
+  public:
+    BlobStore() : chunkPtr(nullptr), chunkRemaining(0) {
+    }
+
+    BlobStore(const BlobStore&) = delete;
+    BlobStore& operator=(const BlobStore&) = delete;
+
+    /**
+     * Stores a copy of the bytes of a value.
+     * @return Reference to the blob, valid as long as the store
+     */
+    const char* store(const char* bytes, uint64_t size) {
+      char* blob = allocate(sizeof(uint64_t) + size);
+      memcpy(blob, &size, sizeof(uint64_t));
+      memcpy(blob + sizeof(uint64_t), bytes, size);
+      return blob;
+    }
+
+    static inline uint64_t size(const char* blob) {
+      uint64_t size;
+      memcpy(&size, blob, sizeof(uint64_t));
+      return size;
+    }
+
+    static inline const char* bytes(const char* blob) {
+      return blob + sizeof(uint64_t);
+    }
+};
+
+#endif
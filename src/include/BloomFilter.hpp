@@ -0,0 +1,77 @@
+#ifndef H_BloomFilter
+#define H_BloomFilter
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Split block Bloom filter for the values of a dictionary.
+ *
+ * Every value sets one bit in each of the eight 32-bit words of a single
+ * 256-bit block, so a check touches one cache line; blocks are allocated
+ * aligned to their size, so they never straddle two lines. Hashes are collected
+ * until freeze() is called, which sizes the filter for the number of values;
+ * until then, every value may be contained.
+ */
+class BloomFilter {
+  private:
+    static const unsigned wordsPerBlock = 8;
+    struct alignas(32) Block {
+      uint32_t words[wordsPerBlock];
+    };
+
+    // std::allocator doesn't guarantee alignments above that of max_align_t
+    struct FreeBlocks {
+      void operator()(Block* blocks) const {
+        std::free(blocks);
+      }
+    };
+
+    const double bitsPerValue;
+    std::vector<uint64_t> pendingHashes;
+    std::unique_ptr<Block[], FreeBlocks> blocks;
+    uint64_t numberOfBlocks;
+
+    uint64_t blockIndex(uint64_t hash) const;
+    static uint32_t mask(uint64_t hash, unsigned word);
+
+  public:
+    /**
+     * @param bitsPerValue Size of the filter; 10 bits give about 1% false positives
+     */
+    BloomFilter(double bitsPerValue = 10);
+
+    void insert(const std::string& value);
+    void freeze();
+    bool isFrozen() const;
+    bool mayContain(const std::string& value) const;
+
+    /**
+     * Returns the size of the filter in bytes.
+     */
+    uint64_t size() const;
+};
+
+/**
+ * Filter that lets every value pass, i.e. no filtering.
+ */
+class NoFilter {
+  public:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+    void insert(const std::string& value) {
+    }
+
+    bool mayContain(const std::string& value) const {
+      return true;
+    }
+#pragma GCC diagnostic pop
+
+    void freeze() {
+    }
+};
+
+#endif
@@ -38,12 +38,22 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
       return PageIterator<BottomUpPage<TSize>>(this).prefixEndIndexSearch(str);
     }
 
-  private:
+  public:
     class Loader : public page::Loader<BottomUpPage<TSize>> {
+      private:
+        PageArena<BottomUpPage<TSize>>& arena;
+
+        // Last value written and where its page starts, for "retro-inserts"
+        uintptr_t startOfFullString;
+        uintptr_t valuePtr;
+        std::pair<page::IdType, std::string> lastPair;
+
       public:
-        void load(std::vector<std::pair<page::IdType, std::string>> values, typename page::Loader<BottomUpPage<TSize>>::CallbackType callback) {
+        Loader(PageArena<BottomUpPage<TSize>>& arena) : arena(arena), startOfFullString(0), valuePtr(0) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename page::Loader<BottomUpPage<TSize>>::CallbackType callback) {
           BottomUpPage<TSize>* currentPage = nullptr;
-          BottomUpPage<TSize>* lastPage = nullptr;
           const char* endOfPage = nullptr;
           char* dataPtr = nullptr;
           page::IndexEntriesType deltaNumber = 0;
@@ -52,10 +62,21 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
           const uint64_t indexHeaderSize = sizeof(page::HeaderType) + sizeof(page::IndexEntriesType);
 
           const std::string* deltaRef = nullptr;
-          uintptr_t startOfFullString = 0;
-          uintptr_t valuePtr = 0;
           page::IndexEntriesType numberOfDeltas = 0;
-          std::pair<page::IdType, std::string> lastPair;
+
+          // End of the values that fit on a page starting at start
+          auto reach = [&](decltype(values.cbegin()) start) {
+            uint64_t pageSize = prefixHeaderSize + this->storedSize(start->second) + indexHeaderSize;
+            auto endIt = start + 1;
+            for (; endIt != values.cend(); ++endIt) {
+              uint64_t deltaSize = sizeof(page::OffsetType) + deltaHeaderSize + this->deltaLength(start->second, endIt->second);
+              if (pageSize + deltaSize > TSize - sizeof(uint8_t)) {
+                break;
+              }
+              pageSize += deltaSize;
+            }
+            return endIt;
+          };
 
           for (auto pairIt = values.cbegin(); pairIt != values.cend(); ++pairIt) {
             const auto& pair = *pairIt;
@@ -64,16 +85,22 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
               if (deltaNumber == numberOfDeltas+1) {
                 // Can't fit delta; "finish" page
                 this->endPage(dataPtr);
-                lastPage = currentPage;
+                this->lastPage = currentPage;
                 currentPage = nullptr;
               }
             }
 
             if (currentPage == nullptr) {
+              auto pageEnd = this->pageEnd(pairIt, values.cend(), reach);
+              if (pageEnd == pairIt) {
+                // Leave the values to the next chunk
+                return static_cast<size_t>(pairIt - values.cbegin());
+              }
+
               // Create new page
-              currentPage = new BottomUpPage<TSize>();
-              if (lastPage != nullptr) {
-                lastPage->nextPage = currentPage;
+              currentPage = new (arena) BottomUpPage<TSize>();
+              if (this->lastPage != nullptr) {
+                this->lastPage->nextPage = currentPage;
               }
               dataPtr = currentPage->data;
               endOfPage = currentPage->data + currentPage->size - sizeof(uint8_t);
@@ -81,26 +108,13 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
 
               deltaRef = &pair.second;
 
-              if (dataPtr + prefixHeaderSize+indexHeaderSize + pair.second.size() > endOfPage) {
+              if (dataPtr + prefixHeaderSize+indexHeaderSize + this->storedSize(pair.second) > endOfPage) {
                 // We can't fit one string on this page!?
-                throw;
+                throw Exception("Can't fit on page: " + pair.second);
               }
 
               // Count how many deltas will fit on this page
-              auto pageSize = dataPtr+prefixHeaderSize+pair.second.size()+indexHeaderSize;
-              auto deltaIt = pairIt;
-              ++deltaIt;
-              numberOfDeltas = 0;
-              if (deltaIt != values.cend()) {
-                auto deltaSize = this->deltaLength(*deltaRef, deltaIt->second);
-                pageSize += sizeof(page::OffsetType)+deltaHeaderSize+deltaSize;
-                while (pageSize <= endOfPage && ++deltaIt != values.cend()) {
-                  numberOfDeltas++;
-
-                  deltaSize = this->deltaLength(*deltaRef, deltaIt->second);
-                  pageSize += sizeof(page::OffsetType)+deltaHeaderSize+deltaSize;
-                }
-              }
+              numberOfDeltas = static_cast<page::IndexEntriesType>(pageEnd - pairIt - 1);
 
               this->startIndex(dataPtr);
 
@@ -109,7 +123,7 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
               // Reserve space for the index
               page::advance<page::OffsetType>(dataPtr, numberOfDeltas);
 
-              if (startOfFullString != 0 && valuePtr != 0 && lastPage != nullptr && pair.second[0] == lastPair.second[0]) {
+              if (startOfFullString != 0 && valuePtr != 0 && this->lastPage != nullptr && pair.second[0] == lastPair.second[0]) {
                 // "Retro-insert"
                 uint64_t diff = valuePtr - startOfFullString;
 #ifdef DEBUG
@@ -117,14 +131,16 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
 #endif
                 uint16_t offset = static_cast<uint16_t>(diff);
                 //
-                callback(lastPage, 0, offset, lastPair.first, lastPair.second);
+                callback(this->lastPage, 0, offset, lastPair.first, lastPair.second);
               }
+              // The last value of a page without deltas is its first one
+              valuePtr = 0;
 
               startOfFullString = this->startPrefix(dataPtr);
 
               // Write uncompressed value
               this->writeId(dataPtr, pair.first);
-              this->writeValue(dataPtr, pair.second);
+              this->writeValue(dataPtr, pair.second, arena.blobs);
 
               callback(currentPage, 1, /* offset*/ 0, pair.first, pair.second);
               lastPair = pair;
@@ -161,13 +177,14 @@ class BottomUpPage : public Page<TSize, BottomUpPage<TSize>> {
           }
 
           this->endPage(dataPtr);
-          lastPage = currentPage;
+          this->lastPage = currentPage;
+          return values.size();
         }
     };
 
   public:
-    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<BottomUpPage<TSize>>::CallbackType callback) {
-      Loader().load(values, callback);
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<BottomUpPage<TSize>>::CallbackType callback, PageArena<BottomUpPage<TSize>>& arena) {
+      Loader(arena).load(values, callback);
     }
 
     static std::string description() {
@@ -4,16 +4,16 @@
 #include "StrategyBase.hpp"
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
-class BottomUpStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf> {
+class BottomUpStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf, BottomUpStrategy<TIdIndex, TStringIndex, TLeaf>> {
   public:
-    BottomUpStrategy(TIdIndex& idIndex, TStringIndex& strIndex) : StrategyBase<TIdIndex, TStringIndex, TLeaf>(idIndex, strIndex) {
+    BottomUpStrategy(TIdIndex& idIndex, TStringIndex& strIndex, const typename page::ArenaOf<TLeaf>::type& arena) : StrategyBase<TIdIndex, TStringIndex, TLeaf, BottomUpStrategy>(idIndex, strIndex, arena) {
     }
 
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue) const;
     //PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, uint64_t lookupId) const;
     //TODO: why!??
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, uint64_t lookupId) const {
-      return StrategyBase<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(leafValue, lookupId);
+      return StrategyBase<TIdIndex, TStringIndex, TLeaf, BottomUpStrategy>::decodeLeaf(leafValue, lookupId);
     }
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, std::string lookupValue) const;
     bool rangeLookup(std::string prefix, PageIterator<TLeaf>& start, PageIterator<TLeaf>& end) const;
@@ -0,0 +1,79 @@
+#ifndef H_BoundedQueue
+#define H_BoundedQueue
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * Blocking FIFO queue with a maximum capacity, for passing work between pipeline stages.
+ *
+ * Producers block while the queue is full, consumers block while it is empty.
+ * Closing the queue wakes everyone up: pushing then fails, and popping
+ * fails once the remaining elements have been consumed.
+ */
+template<typename T>
+class BoundedQueue {
+  private:
+    const size_t capacity;
+    std::deque<T> elements;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+
+  public:
+    BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * Appends an element, waiting for free capacity if necessary.
+     *
+     * @param element Element to append
+     * @return True if the element was appended, false if the queue is closed
+     */
+    bool push(T element) {
+      std::unique_lock<std::mutex> lock(mutex);
+      notFull.wait(lock, [this] { return closed || elements.size() < capacity; });
+      if (closed) {
+        return false;
+      }
+      elements.push_back(std::move(element));
+      notEmpty.notify_one();
+      return true;
+    }
+
+    /**
+     * Removes the first element, waiting for one if necessary.
+     *
+     * @param [out] element Removed element
+     * @return True if an element was removed, false if the queue is closed and empty
+     */
+    bool pop(T& element) {
+      std::unique_lock<std::mutex> lock(mutex);
+      notEmpty.wait(lock, [this] { return closed || !elements.empty(); });
+      if (elements.empty()) {
+        return false;
+      }
+      element = std::move(elements.front());
+      elements.pop_front();
+      notFull.notify_one();
+      return true;
+    }
+
+    /**
+     * Closes the queue; no more elements can be pushed.
+     */
+    void close() {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+      notFull.notify_all();
+      notEmpty.notify_all();
+    }
+};
+
+#endif
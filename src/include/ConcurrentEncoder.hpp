@@ -0,0 +1,102 @@
+#ifndef H_ConcurrentEncoder
+#define H_ConcurrentEncoder
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ExternalSorter;
+
+/**
+ * Assigns temporary IDs to terms, safe for concurrent use by many threads.
+ *
+ * Terms are distributed over independently locked stripes, each being an
+ * open-addressing hash table whose string bytes live in an arena.
+ * IDs are unique and stable and are drawn from a shared atomic counter,
+ * so they roughly follow the order of first appearance.
+ *
+ * Dictionary IDs are only known after the sorted bulk load, so the
+ * temporary IDs are mapped to dictionary IDs when encoding is finished.
+ */
+class ConcurrentEncoder {
+  public:
+    /**
+     * Creates a new encoder.
+     *
+     * @param stripeBits Logarithm of the number of stripes
+     */
+    ConcurrentEncoder(uint8_t stripeBits = 6);
+
+    ConcurrentEncoder(const ConcurrentEncoder&) = delete;
+    ConcurrentEncoder& operator=(const ConcurrentEncoder&) = delete;
+
+    /**
+     * Returns the temporary ID of a term, assigning the next one if the term is new.
+     *
+     * @param term Term to encode
+     * @return Temporary ID of the term, starting at 0
+     */
+    uint64_t encode(const std::string& term);
+
+    /**
+     * Returns the number of distinct terms encoded so far.
+     * @return Number of distinct terms
+     */
+    uint64_t size() const;
+
+    /**
+     * Sorts all encoded terms and clears the encoder.
+     * Must not be called concurrently with encode().
+     *
+     * @param [out] sortedTerms All distinct terms in sorted order
+     * @param [out] finalIds Maps each temporary ID to the position of its term in sortedTerms, starting at 1
+     */
+    void finish(std::vector<std::string>& sortedTerms, std::vector<uint64_t>& finalIds);
+
+    /**
+     * Sorts all encoded terms into a sorter and clears the encoder, so the
+     * terms don't need to be held in memory twice.
+     * Must not be called concurrently with encode().
+     *
+     * @param [out] sortedTerms Sorter receiving all distinct terms in sorted order
+     * @param [out] finalIds Maps each temporary ID to the rank of its term, starting at 1
+     */
+    void finish(ExternalSorter& sortedTerms, std::vector<uint64_t>& finalIds);
+
+  private:
+    struct Entry {
+      uint64_t hash;
+      const char* value;
+      uint64_t length;
+      uint64_t id;
+    };
+
+    struct Stripe {
+      static const uint64_t blockSize = 1 << 20;
+      static const uint64_t initialCapacity = 1 << 8;
+
+      std::mutex mutex;
+      std::vector<Entry> slots;
+      uint64_t used = 0;
+
+      // String arena
+      std::vector<std::unique_ptr<char[]>> blocks;
+      char* blockPtr = nullptr;
+      uint64_t blockRemaining = 0;
+
+      const char* store(const std::string& value);
+      void grow();
+    };
+
+    const uint8_t stripeBits;
+    std::unique_ptr<Stripe[]> stripes;
+    std::atomic<uint64_t> nextId;
+
+    std::vector<const Entry*> sortedEntries(std::vector<uint64_t>& finalIds) const;
+    void clear();
+};
+
+#endif
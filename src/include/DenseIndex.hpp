@@ -0,0 +1,24 @@
+#ifndef H_DenseIndex
+#define H_DenseIndex
+
+#include <vector>
+#include <cstdint>
+#include <string>
+
+/**
+ * ID index for dense IDs, storing 32-bit leaf values in an array indexed by ID.
+ *
+ * Requires leaf values that fit into 32 bits, i.e. pages from a page arena.
+ * A leaf value of 0 marks a missing ID.
+ */
+template<typename TKey> class DenseIndex {
+  private:
+    std::vector<uint32_t> index;
+
+  public:
+    void insert(TKey key, uint64_t value);
+    bool lookup(TKey key, uint64_t& value) const;
+    static std::string description();
+};
+
+#endif
@@ -5,6 +5,8 @@
 #include <functional>
 #include "Exception.hpp"
 
+class ExternalSorter;
+
 /**
  * Base class for dictionary implementations.
  */
@@ -30,6 +32,15 @@ class Dictionary {
     //TODO: change to iterators
     virtual void bulkInsert(size_t size, std::string* values) = 0;
 
+    /**
+     * Inserts all values of a sorter into the dictionary, in sorted order.
+     * The default implementation collects all values in memory first.
+     *
+     * @param values Sorter providing sorted, unique string values
+     * @param chunkSize Maximum number of values held in memory at once
+     */
+    virtual void bulkInsert(ExternalSorter& values, size_t chunkSize);
+
     /**
      * Inserts a single string value into the dictionary.
      *
@@ -82,6 +93,12 @@ class Dictionary {
      */
     virtual std::string numberOfLeaves() const = 0;
 
+    /**
+     * Returns whether bulk loads number the values by their rank, starting at 1.
+     * @returns True if the IDs of bulk loaded values are their ranks
+     */
+    virtual bool numbersByRank() const { return true; }
+
     virtual void debug() const { }
 };
 
@@ -5,10 +5,9 @@
 
 template<uint32_t TPrefixSize = 1>
 class DynamicPage {
-  private:
+  public:
     class Loader;
 
-  public:
     static uint64_t counter;
     DynamicPage<TPrefixSize>* nextPage;
 
@@ -37,10 +36,10 @@ class DynamicPage {
       return PageIterator<DynamicPage<TPrefixSize>>(this).gotoOffset(offset);
     }
 
-  private:
+  public:
     class Loader : public page::Loader<DynamicPage<TPrefixSize>> {
       private:
-        inline size_t findBlock(const uint8_t searchChar, size_t prefixPos, size_t size, std::pair<page::IdType, std::string>* values, bool& endOfString) {
+        inline size_t findBlock(const uint8_t searchChar, size_t prefixPos, size_t size, const std::pair<page::IdType, std::string>* values, bool& endOfString) {
           size_t start = 0;
           size_t end = size-1;
 
@@ -71,7 +70,7 @@ class DynamicPage {
           return start;
         }
 
-        uint64_t getPageSize(uint64_t size, std::pair<page::IdType, std::string>* values) {
+        uint64_t getPageSize(uint64_t size, const std::pair<page::IdType, std::string>* values) {
           using namespace page;
 
           uint64_t pageSize = sizeof(uintptr_t); // next page pointer
@@ -88,7 +87,7 @@ class DynamicPage {
           return pageSize + sizeof(HeaderType); // End of page header
         }
 
-        DynamicPage<TPrefixSize>* createPage(uint64_t size, std::pair<page::IdType, std::string>* values, typename PageLoader<DynamicPage<TPrefixSize>>::CallbackType callback) {
+        DynamicPage<TPrefixSize>* createPage(uint64_t size, const std::pair<page::IdType, std::string>* values, typename PageLoader<DynamicPage<TPrefixSize>>::CallbackType callback) {
 #ifdef DEBUG
           assert(size > 0);
 #endif
@@ -127,13 +126,15 @@ class DynamicPage {
         }
 
       public:
-        void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<DynamicPage<TPrefixSize>>::CallbackType callback) {
+        Loader(page::NoArena&) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename PageLoader<DynamicPage<TPrefixSize>>::CallbackType callback) {
           const size_t size = values.size();
 
           size_t start = 0;
           size_t end;
           uint32_t searchPos;
-          DynamicPage<TPrefixSize>* lastPage = nullptr;
 
           do {
             bool endOfString = false;
@@ -145,23 +146,28 @@ class DynamicPage {
               }
               end = start+findBlock(searchChar, searchPos, end-start+1, &values[start], endOfString);
             }
+            if (this->moreValues && end == size-1) {
+              // The block might go on; leave it to the next chunk
+              return start;
+            }
 
             DynamicPage<TPrefixSize>* currentPage = createPage(end-start+1, &values[start], callback);
 
-            if (lastPage != nullptr) {
-              lastPage->nextPage = currentPage;
+            if (this->lastPage != nullptr) {
+              this->lastPage->nextPage = currentPage;
             }
-            lastPage = currentPage;
+            this->lastPage = currentPage;
 
             start = (start == end) ? start+1 : end+1;
           }
           while(end < size-1);
+          return values.size();
         }
     };
 
   public:
-    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<DynamicPage<TPrefixSize>>::CallbackType callback) {
-      Loader().load(values, callback);
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<DynamicPage<TPrefixSize>>::CallbackType callback, page::NoArena& arena) {
+      Loader(arena).load(values, callback);
     }
 
     static std::string description() {
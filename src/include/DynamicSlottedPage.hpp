@@ -5,10 +5,9 @@
 
 template<uint32_t TPrefixSize = 1>
 class DynamicSlottedPage {
-  private:
+  public:
     class Loader;
 
-  public:
     static uint64_t counter;
     DynamicSlottedPage<TPrefixSize>* nextPage;
 
@@ -25,10 +24,10 @@ class DynamicSlottedPage {
       return PageIterator<DynamicSlottedPage<TPrefixSize>>(this).getIndexEntry(indexEntry);
     }
 
-  private:
+  public:
     class Loader : public page::Loader<DynamicSlottedPage<TPrefixSize>> {
       private:
-        inline size_t findBlock(const uint8_t searchChar, size_t prefixPos, size_t size, std::pair<page::IdType, std::string>* values, bool& endOfString) {
+        inline size_t findBlock(const uint8_t searchChar, size_t prefixPos, size_t size, const std::pair<page::IdType, std::string>* values, bool& endOfString) {
           size_t start = 0;
           size_t end = size-1;
 
@@ -59,7 +58,7 @@ class DynamicSlottedPage {
           return start;
         }
 
-        uint64_t getPageSize(uint64_t size, std::pair<page::IdType, std::string>* values) {
+        uint64_t getPageSize(uint64_t size, const std::pair<page::IdType, std::string>* values) {
           using namespace page;
 
           uint64_t pageSize = sizeof(uintptr_t); // next page pointer
@@ -81,7 +80,7 @@ class DynamicSlottedPage {
           return pageSize + sizeof(HeaderType); // End of page header
         }
 
-        DynamicSlottedPage<TPrefixSize>* createPage(uint64_t size, std::pair<page::IdType, std::string>* values, typename PageLoader<DynamicSlottedPage<TPrefixSize>>::CallbackType callback) {
+        DynamicSlottedPage<TPrefixSize>* createPage(uint64_t size, const std::pair<page::IdType, std::string>* values, typename PageLoader<DynamicSlottedPage<TPrefixSize>>::CallbackType callback) {
 #ifdef DEBUG
           assert(size > 0);
 #endif
@@ -134,13 +133,15 @@ class DynamicSlottedPage {
         }
 
       public:
-        void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<DynamicSlottedPage<TPrefixSize>>::CallbackType callback) {
+        Loader(page::NoArena&) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename PageLoader<DynamicSlottedPage<TPrefixSize>>::CallbackType callback) {
           const size_t size = values.size();
 
           size_t start = 0;
           size_t end;
           uint32_t searchPos;
-          DynamicSlottedPage<TPrefixSize>* lastPage = nullptr;
 
           do {
             bool endOfString = false;
@@ -152,23 +153,28 @@ class DynamicSlottedPage {
               }
               end = start+findBlock(searchChar, searchPos, end-start+1, &values[start], endOfString);
             }
+            if (this->moreValues && end == size-1) {
+              // The block might go on; leave it to the next chunk
+              return start;
+            }
 
             DynamicSlottedPage<TPrefixSize>* currentPage = createPage(end-start+1, &values[start], callback);
 
-            if (lastPage != nullptr) {
-              lastPage->nextPage = currentPage;
+            if (this->lastPage != nullptr) {
+              this->lastPage->nextPage = currentPage;
             }
-            lastPage = currentPage;
+            this->lastPage = currentPage;
 
             start = (start == end) ? start+1 : end+1;
           }
           while(end < size-1);
+          return values.size();
         }
     };
 
   public:
-    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<DynamicSlottedPage<TPrefixSize>>::CallbackType callback) {
-      Loader().load(values, callback);
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<DynamicSlottedPage<TPrefixSize>>::CallbackType callback, page::NoArena& arena) {
+      Loader(arena).load(values, callback);
     }
 
     static std::string description() {
@@ -0,0 +1,97 @@
+#ifndef H_ExternalSorter
+#define H_ExternalSorter
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Sorts and deduplicates string values that do not necessarily fit into main memory.
+ *
+ * Values are collected in memory until the memory budget is exhausted.
+ * The sorted, deduplicated run is then spilled to a temporary file.
+ * After all values are added, the runs are merged into one sorted stream
+ * without duplicates, so bulk loading never needs all values in memory.
+ */
+class ExternalSorter {
+  public:
+    /**
+     * Approximate memory used per buffered value in addition to its characters.
+     */
+    static const uint64_t entryOverhead = 64;
+
+    /**
+     * Creates a new sorter.
+     *
+     * @param memoryBudget Maximum number of bytes used for buffering values in memory
+     * @param directory Directory for temporary run files; uses TMPDIR or /tmp if empty
+     */
+    ExternalSorter(uint64_t memoryBudget, std::string directory = "");
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    /**
+     * Adds a value to the sorter. Must not be called after finish().
+     *
+     * @param value String value to add
+     */
+    void add(const std::string& value);
+
+    /**
+     * Finishes adding values and prepares merging the runs.
+     */
+    void finish();
+
+    /**
+     * Gets the next value in sorted order, skipping duplicates.
+     * Calls finish() if necessary.
+     *
+     * @param [out] value Next value
+     * @return True if there was a next value, false if all values were read
+     */
+    bool next(std::string& value);
+
+    /**
+     * Returns the number of runs spilled to disk so far.
+     * @return Number of spilled runs
+     */
+    uint64_t numberOfRuns() const;
+
+  private:
+    /**
+     * Sequential reader for a single spilled run.
+     */
+    struct Run {
+      std::ifstream stream;
+      std::string value;
+
+      Run(const std::string& fileName);
+      bool read();
+    };
+
+    typedef std::pair<std::string, size_t> MergeEntry;
+
+    const uint64_t memoryBudget;
+    std::string directory;
+    uint64_t memoryUsage;
+    bool finished;
+    bool hasLastValue;
+    std::string lastValue;
+
+    std::set<std::string> values;
+    std::set<std::string>::const_iterator valuesIt;
+    std::vector<std::string> runFiles;
+    std::vector<std::unique_ptr<Run>> runs;
+    std::priority_queue<MergeEntry, std::vector<MergeEntry>, std::greater<MergeEntry>> mergeQueue;
+
+    void spill();
+    bool nextMerged(std::string& value);
+};
+
+#endif
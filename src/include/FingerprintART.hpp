@@ -0,0 +1,75 @@
+#ifndef H_FingerprintART
+#define H_FingerprintART
+
+#include "ART.hpp"
+#include <tuple>
+
+/**
+ * ART whose leaves carry a 16-bit hash fingerprint of their complete key.
+ *
+ * The optimistic lookup skips long prefixes and has to verify the final
+ * leaf against the leaf store. The fingerprint is compared first, so most
+ * mismatching lookups are rejected without accessing the page.
+ *
+ * The fingerprint is stored in the upper bits of the leaf value, so leaf
+ * values have to fit into 47 bits. Leaves on pages from a page arena are
+ * referenced by page number and fit; DynamicPage and DynamicSlottedPage
+ * leaves are referenced by pointer and don't, so inserting them throws.
+ */
+template<class TKey>
+class FingerprintART : public ART<TKey> {
+  friend class ARTBase;
+
+  private:
+    static const unsigned valueBits = 47;
+
+    static uintptr_t tag(uintptr_t value, uint16_t fingerprint);
+    static uintptr_t untag(uintptr_t leafValue);
+
+  protected:
+    // Hooks of the ARTBase algorithms, which untag the leaf values or
+    // compare their fingerprint
+    template<class TStore>
+    static void loadKey(const TStore& store, uintptr_t leafValue, uint8_t* key, unsigned maxKeyLength) {
+      ART<TKey>::loadKey(store, untag(leafValue), key, maxKeyLength);
+    }
+
+    template<class TStore>
+    static unsigned keyMismatch(const TStore& store, uintptr_t leafValue, uint8_t key[], unsigned from, unsigned to) {
+      return ART<TKey>::keyMismatch(store, untag(leafValue), key, from, to);
+    }
+
+    static bool fingerprintMatches(uintptr_t leafValue, uint8_t key[], unsigned keyLength) {
+      return (leafValue >> valueBits) == fingerprint(key, keyLength);
+    }
+
+  public:
+    FingerprintART(LeafStore* leafStore, bool hugePages = false);
+    FingerprintART(FingerprintART&& other) = default;
+
+    /**
+     * Computes the fingerprint of a key, as it is passed to the tree.
+     */
+    static uint16_t fingerprint(const uint8_t* key, unsigned keyLength);
+
+    void insert(TKey key, uintptr_t value);
+    bool lookup(TKey key, uintptr_t& value) const;
+
+    /**
+     * Looks up a key and verifies the leaf with store, like ART.
+     */
+    template<class TStore>
+    bool lookup(TKey key, uintptr_t& value, const TStore& store) const {
+      if (!this->template lookupLeaf<FingerprintART>(key, value, store)) {
+        return false;
+      }
+      value = untag(value);
+      return true;
+    }
+
+    std::pair<uintptr_t, uintptr_t> rangeLookup(TKey prefix) const;
+    static std::string description();
+    void debug() { }
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef H_FingerprintHash
+#define H_FingerprintHash
+
+#include "LeafStore.hpp"
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Open-addressing hash index that does not store keys.
+ *
+ * Every slot holds a control byte and a 32-bit leaf value, so an entry takes
+ * 6 to 11 bytes depending on the load factor. Leaf values of pages from a
+ * page arena fit; larger leaf values are rejected. The control byte is either
+ * empty or a 7-bit fingerprint of the key's hash. Slots are probed in groups of
+ * 16 control bytes, which are compared with SSE2; only slots with a matching
+ * fingerprint are verified against the leaf store, like ART verifies leaves.
+ *
+ * Since keys are not stored, growing the table re-hashes the values from the
+ * leaf store. Keys are expected to be unique. Range lookups are not supported.
+ */
+template<class TKey>
+class FingerprintHash {
+  private:
+    LeafStore* leafStore;
+    std::vector<uint8_t> control;
+    std::vector<uint32_t> leafValues;
+    uint64_t groupMask;
+    uint64_t size;
+
+    uint64_t hashLeaf(uint64_t leafValue) const;
+    bool leafMatches(uint64_t leafValue, const TKey& key) const;
+    void insertHashed(uint64_t hash, uint32_t value);
+    void grow();
+
+  public:
+    FingerprintHash(LeafStore* leafStore);
+
+    /**
+     * Hash function for keys.
+     */
+    static uint64_t hashKey(const TKey& key);
+
+    void insert(TKey key, uint64_t value);
+    bool lookup(TKey key, uint64_t& value) const;
+    std::pair<uint64_t, uint64_t> rangeLookup(TKey prefix) const;
+
+    /**
+     * Returns the size of the table in bytes.
+     */
+    uint64_t tableSize() const;
+
+    static std::string description();
+    void debug() { }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef H_FrozenART
+#define H_FrozenART
+
+#include "ART.hpp"
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <tuple>
+#include <vector>
+
+/**
+ * Layout of a frozen ART.
+ *
+ * Nodes are stored contiguously in depth-first order as 32-bit words:
+ * - word 0: node type | number of children << 8
+ * - word 1: prefix length
+ * - the complete prefix, padded to whole words
+ * - sparse nodes: sorted key bytes padded to whole words, then one child reference per key
+ * - dense nodes: one child reference per possible key byte, 0 if there is no child
+ *
+ * A child reference is either a word offset of a node, or leafFlag | index into the leaf values.
+ */
+namespace frozen {
+  static const uint8_t sparseNode = 0;
+  static const uint8_t denseNode = 1;
+  // Nodes with more children are stored densely
+  static const unsigned maxSparseChildren = 48;
+  static const uint32_t leafFlag = 1u << 31;
+  static const uint32_t emptyRoot = ~0u;
+
+  inline unsigned words(unsigned bytes) {
+    return (bytes + 3) / 4;
+  }
+}
+
+/**
+ * Immutable, pointer-free adaptive radix tree.
+ *
+ * Values are inserted into a regular ART until freeze() is called. The tree
+ * is then rewritten into the frozen layout and the ART is released; only
+ * lookups are possible afterwards. Since prefixes are stored completely,
+ * only the final leaf has to be checked against the leaf store.
+ *
+ * The frozen layout is position-independent, so it can be saved as-is and
+ * attached directly from mapped memory.
+ */
+template<class TKey>
+class FrozenART {
+  private:
+    LeafStore* leafStore;
+    std::unique_ptr<ART<TKey>> art;
+
+    std::vector<uint32_t> nodeStorage;
+    std::vector<uint64_t> leafStorage;
+    const uint32_t* nodes;
+    const uint64_t* leaves;
+    uint32_t root;
+
+    uint32_t findChild(const uint32_t* node, uint8_t keyByte) const;
+    uint32_t minimum(uint32_t ref) const;
+    uint32_t maximum(uint32_t ref) const;
+    bool leafMatches(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const;
+    bool lookupFrozen(const uint8_t* key, unsigned keyLength, uintptr_t& value) const;
+
+  public:
+    FrozenART(LeafStore* leafStore);
+    FrozenART(FrozenART&& other) = default;
+
+    /**
+     * Inserts a value; only possible before the index is frozen.
+     */
+    void insert(TKey key, uintptr_t value);
+    bool lookup(TKey key, uintptr_t& value) const;
+    std::pair<uintptr_t, uintptr_t> rangeLookup(TKey prefix) const;
+
+    /**
+     * Rewrites the tree into the frozen layout.
+     */
+    void freeze();
+    bool isFrozen() const;
+
+    /**
+     * Returns the size of the frozen tree in bytes.
+     */
+    uint64_t frozenSize() const;
+
+    /**
+     * Writes the frozen tree to a stream.
+     */
+    void save(std::ostream& stream) const;
+
+    /**
+     * Reads a frozen tree written by save().
+     */
+    void load(std::istream& stream);
+
+    /**
+     * Uses a frozen tree written by save() in place, e.g. from mapped memory.
+     * The memory must be 8-byte aligned and outlive the index.
+     */
+    void attach(const void* data, uint64_t size);
+
+    static std::string description();
+    void debug() { }
+};
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef H_ImplicitIdPage
+#define H_ImplicitIdPage
+
+#include "Page.hpp"
+
+/**
+ * Fixed-size slotted page whose values carry no IDs.
+ *
+ * IDs are derived from the position of a value in its page: the page starts
+ * with a list of runs, each giving the position and ID of the first value of
+ * a run of consecutive IDs. A bulk-loaded page has a single run; merged
+ * input with gaps between the IDs needs one more run per gap.
+ *
+ * The values behind the run list use the slotted layout of SlottedPage,
+ * without the ID fields. TLayout selects the layout of the entry headers.
+ */
+template<uint64_t TSize, class TLayout = page::FixedLayout>
+class ImplicitIdPage : public Page<TSize, ImplicitIdPage<TSize, TLayout>> {
+  private:
+    typedef uint16_t RunCountType;
+    static const uint64_t runSize = sizeof(page::IndexEntriesType) + sizeof(page::IdType);
+
+  public:
+    typedef TLayout Layout;
+    static uint64_t counter;
+
+    ImplicitIdPage() : Page<TSize, ImplicitIdPage<TSize, TLayout>>() {
+      counter++;
+    }
+
+    ImplicitIdPage(const ImplicitIdPage&) = delete;
+    ImplicitIdPage& operator=(const ImplicitIdPage&) = delete;
+
+    /**
+     * Returns the start of the values, behind the run list.
+     */
+    inline char* getData() {
+      char* readPtr = this->data;
+      RunCountType runs = page::read<RunCountType>(readPtr);
+      return readPtr + runs * runSize;
+    }
+
+    /**
+     * Returns the ID of the value at the given position (0 = uncompressed value).
+     */
+    page::IdType idOf(page::IndexEntriesType entry) {
+      char* readPtr = this->data;
+      RunCountType runs = page::read<RunCountType>(readPtr);
+
+      // Find the last run starting at or before the entry; the first run starts at 0
+      RunCountType start = 0;
+      RunCountType end = runs;
+      while (end - start > 1) {
+        RunCountType middle = start+(end-start)/2;
+        char* runPtr = readPtr + middle * runSize;
+        if (page::read<page::IndexEntriesType>(runPtr) <= entry) {
+          start = middle;
+        }
+        else {
+          end = middle;
+        }
+      }
+
+      char* runPtr = readPtr + start * runSize;
+      page::IndexEntriesType runStart = page::read<page::IndexEntriesType>(runPtr);
+      return page::read<page::IdType>(runPtr) + (entry - runStart);
+    }
+
+    /**
+     * Returns the number of runs of consecutive IDs in this page.
+     */
+    RunCountType numberOfRuns() const {
+      return *reinterpret_cast<const RunCountType*>(this->data);
+    }
+
+    PageIterator<ImplicitIdPage<TSize, TLayout>> getIndexEntry(page::IndexEntriesType indexEntry) {
+      return PageIterator<ImplicitIdPage<TSize, TLayout>>(this).getIndexEntry(indexEntry);
+    }
+
+  public:
+    class Loader : public page::Loader<ImplicitIdPage<TSize, TLayout>> {
+      private:
+        PageArena<ImplicitIdPage<TSize, TLayout>>& arena;
+
+      public:
+        Loader(PageArena<ImplicitIdPage<TSize, TLayout>>& arena) : arena(arena) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename page::Loader<ImplicitIdPage<TSize, TLayout>>::CallbackType callback) {
+          ImplicitIdPage<TSize, TLayout>* currentPage = nullptr;
+          const uint64_t indexHeaderSize = sizeof(page::HeaderType) + sizeof(page::IndexEntriesType);
+          // Leave room for the end of page marker
+          const uint64_t capacity = TSize - sizeof(page::HeaderType);
+
+          std::vector<std::pair<page::IndexEntriesType, page::IdType>> runs;
+
+          // End of the values that fit on a page starting at start, including
+          // the runs they need
+          auto reach = [&](decltype(values.cbegin()) start) {
+            uint64_t pageSize = sizeof(RunCountType) + runSize + indexHeaderSize + this->valueEntrySize(start->second);
+            auto endIt = start + 1;
+            for (page::IndexEntriesType numberOfDeltas = 0; endIt != values.cend() && numberOfDeltas < std::numeric_limits<page::IndexEntriesType>::max(); ++endIt, numberOfDeltas++) {
+              bool startsRun = endIt->first != (endIt-1)->first + 1;
+              uint64_t entrySize = sizeof(page::OffsetType) + this->deltaEntrySize(start->second, endIt->second) + (startsRun ? runSize : 0);
+              if (pageSize + entrySize > capacity) {
+                break;
+              }
+              pageSize += entrySize;
+            }
+            return endIt;
+          };
+
+          auto pairIt = values.cbegin();
+          while (pairIt != values.cend()) {
+            const std::string& deltaRef = pairIt->second;
+
+            if (sizeof(RunCountType) + runSize + indexHeaderSize + this->valueEntrySize(deltaRef) > capacity) {
+              // We can't fit one string on this page!?
+              throw Exception("Can't fit on page: " + deltaRef);
+            }
+
+            // Count how many deltas will fit on this page, and where new runs start
+            auto pageEnd = this->pageEnd(pairIt, values.cend(), reach);
+            if (pageEnd == pairIt) {
+              // Leave the values to the next chunk
+              return static_cast<size_t>(pairIt - values.cbegin());
+            }
+            page::IndexEntriesType numberOfDeltas = static_cast<page::IndexEntriesType>(pageEnd - pairIt - 1);
+            runs.clear();
+            runs.push_back(std::make_pair(0, pairIt->first));
+            for (auto deltaIt = pairIt + 1; deltaIt != pageEnd; ++deltaIt) {
+              if (deltaIt->first != (deltaIt-1)->first + 1) {
+                runs.push_back(std::make_pair(static_cast<page::IndexEntriesType>(deltaIt - pairIt), deltaIt->first));
+              }
+            }
+
+            // Create new page
+            currentPage = new (arena) ImplicitIdPage<TSize, TLayout>();
+            if (this->lastPage != nullptr) {
+              this->lastPage->nextPage = currentPage;
+            }
+
+            char* dataPtr = currentPage->data;
+            page::write<RunCountType>(dataPtr, static_cast<RunCountType>(runs.size()));
+            for (const auto& run : runs) {
+              page::write<page::IndexEntriesType>(dataPtr, run.first);
+              page::write<page::IdType>(dataPtr, run.second);
+            }
+
+            this->startIndex(dataPtr);
+            page::write<page::IndexEntriesType>(dataPtr, numberOfDeltas);
+            page::OffsetType* indexAddress = reinterpret_cast<page::OffsetType*>(dataPtr);
+            // Reserve space for the index
+            page::advance<page::OffsetType>(dataPtr, numberOfDeltas);
+
+            // Write uncompressed value
+            uintptr_t startOfFullString = this->startPrefix(dataPtr);
+            this->writeValue(dataPtr, deltaRef, arena.blobs);
+            callback(currentPage, 0, 0, pairIt->first, pairIt->second);
+
+            for (page::IndexEntriesType deltaNumber = 1; deltaNumber <= numberOfDeltas; deltaNumber++) {
+              ++pairIt;
+
+              // Write delta
+              page::PrefixSizeType prefixSize;
+              std::string deltaValue = this->delta(deltaRef, pairIt->second, prefixSize);
+              uintptr_t valuePtr = this->startDelta(dataPtr);
+              this->writeDelta(dataPtr, deltaValue, prefixSize);
+
+#ifdef DEBUG
+              assert((valuePtr-startOfFullString) <= std::numeric_limits<page::OffsetType>::max());
+#endif
+              // Write offset relative to start of full values to index
+              indexAddress[deltaNumber-1] = static_cast<page::OffsetType>(valuePtr - startOfFullString);
+
+              callback(currentPage, deltaNumber, 0, pairIt->first, pairIt->second);
+            }
+            ++pairIt;
+
+            this->endPage(dataPtr);
+            this->lastPage = currentPage;
+          }
+          return values.size();
+        }
+    };
+
+  public:
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<ImplicitIdPage<TSize, TLayout>>::CallbackType callback, PageArena<ImplicitIdPage<TSize, TLayout>>& arena) {
+      Loader(arena).load(values, callback);
+    }
+
+    static std::string description() {
+      return std::to_string(TSize);
+    }
+};
+
+template<uint64_t TSize, class TLayout>
+const uint64_t ImplicitIdPage<TSize, TLayout>::runSize;
+
+template<uint64_t TSize, class TLayout>
+uint64_t ImplicitIdPage<TSize, TLayout>::counter = 0;
+
+#endif
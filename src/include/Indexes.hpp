@@ -6,10 +6,15 @@
 
 #include "ART.hpp"
 #include "SART.hpp"
+#include "FrozenART.hpp"
+#include "FingerprintART.hpp"
 #include "HAT.hpp"
 #include "Hash.hpp"
+#include "FingerprintHash.hpp"
+#include "PerfectHash.hpp"
 #include "BTree.hpp"
 #include "B+Tree.hpp"
 #include "RedBlack.hpp"
+#include "DenseIndex.hpp"
 
 #endif
@@ -4,9 +4,9 @@
 #include "StrategyBase.hpp"
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
-class IndirectStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf> {
+class IndirectStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf, IndirectStrategy<TIdIndex, TStringIndex, TLeaf>> {
   public:
-    IndirectStrategy(TIdIndex& idIndex, TStringIndex& strIndex) : StrategyBase<TIdIndex, TStringIndex, TLeaf>(idIndex, strIndex) {
+    IndirectStrategy(TIdIndex& idIndex, TStringIndex& strIndex, const typename page::ArenaOf<TLeaf>::type& arena) : StrategyBase<TIdIndex, TStringIndex, TLeaf, IndirectStrategy>(idIndex, strIndex, arena) {
     }
 
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue) const;
@@ -14,11 +14,11 @@ class IndirectStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf> {
 
     //TODO: why!??
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, uint64_t lookupId) const {
-      return StrategyBase<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(leafValue, lookupId);
+      return StrategyBase<TIdIndex, TStringIndex, TLeaf, IndirectStrategy>::decodeLeaf(leafValue, lookupId);
     }
 
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, std::string lookupValue) const {
-      return StrategyBase<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(leafValue, lookupValue);
+      return StrategyBase<TIdIndex, TStringIndex, TLeaf, IndirectStrategy>::decodeLeaf(leafValue, lookupValue);
     }
 };
 
@@ -0,0 +1,254 @@
+#ifndef H_InlineIdDictionary
+#define H_InlineIdDictionary
+
+#include "Dictionary.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/**
+ * Dictionary layer encoding small values directly in their IDs.
+ *
+ * IDs with the highest bit set are inline: the next seven bits give the kind
+ * of the value and the low 56 bits its payload. Inline are
+ *  - ASCII strings of up to eight characters (e.g. "true", "1.5"),
+ *  - decimal integers in canonical form up to 2^56-1 in magnitude,
+ *  - dates in the form YYYY-MM-DD.
+ * Such values are never stored in the wrapped dictionary; looking them up
+ * in either direction is arithmetic, and they are known to the dictionary
+ * without being inserted. Every value has exactly one encoding, so lookups of
+ * IDs only accept that encoding.
+ *
+ * Range lookups return the inline values that were bulk loaded or inserted,
+ * too, so their IDs are kept in the order of their values; other inline
+ * values are not part of any range. size() only counts the stored values.
+ */
+template<class TDictionary>
+class InlineIdDictionary final : public Dictionary {
+  private:
+    static const uint64_t inlineFlag = 1ull << 63;
+    static const unsigned kindShift = 56;
+    static const uint64_t payloadMask = (1ull << kindShift) - 1;
+
+    // Kinds up to maxStringSize are the lengths of inline strings
+    static const uint64_t maxStringSize = 8;
+    static const uint64_t positiveIntegerKind = maxStringSize + 1;
+    static const uint64_t negativeIntegerKind = maxStringSize + 2;
+    static const uint64_t dateKind = maxStringSize + 3;
+
+    TDictionary dictionary;
+    // IDs of the inline values that were loaded or inserted, by value
+    std::vector<uint64_t> inlineIds;
+
+    static inline bool precedes(uint64_t id, const std::string& value) {
+      return decode(id) < value;
+    }
+
+    static inline uint64_t makeId(uint64_t kind, uint64_t payload) {
+      return inlineFlag | (kind << kindShift) | payload;
+    }
+
+    static bool parseNumber(const std::string& value, size_t start, size_t end, uint64_t& number) {
+      if (start == end || (value[start] == '0' && end - start > 1)) {
+        return false;
+      }
+      number = 0;
+      for (size_t i = start; i < end; i++) {
+        if (value[i] < '0' || value[i] > '9' || number > (payloadMask - (value[i] - '0')) / 10) {
+          return false;
+        }
+        number = number * 10 + static_cast<uint64_t>(value[i] - '0');
+      }
+      return true;
+    }
+
+    static bool encodeDate(const std::string& value, uint64_t& id) {
+      if (value.size() != 10 || value[4] != '-' || value[7] != '-') {
+        return false;
+      }
+      for (size_t i : { 0, 1, 2, 3, 5, 6, 8, 9 }) {
+        if (value[i] < '0' || value[i] > '9') {
+          return false;
+        }
+      }
+      uint64_t year = std::stoull(value.substr(0, 4));
+      uint64_t month = std::stoull(value.substr(5, 2));
+      uint64_t day = std::stoull(value.substr(8, 2));
+      if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+      }
+      id = makeId(dateKind, (year * 100 + month) * 100 + day);
+      return true;
+    }
+
+    /**
+     * Gives the inline ID of a value.
+     * @return True if the value is encoded inline, false otherwise
+     */
+    static bool encode(const std::string& value, uint64_t& id) {
+      uint64_t number;
+      if (parseNumber(value, 0, value.size(), number)) {
+        id = makeId(positiveIntegerKind, number);
+        return true;
+      }
+      if (!value.empty() && value[0] == '-' && parseNumber(value, 1, value.size(), number) && number != 0) {
+        id = makeId(negativeIntegerKind, number);
+        return true;
+      }
+      if (encodeDate(value, id)) {
+        return true;
+      }
+      if (value.size() > maxStringSize) {
+        return false;
+      }
+      uint64_t payload = 0;
+      for (size_t i = 0; i < value.size(); i++) {
+        uint8_t c = static_cast<uint8_t>(value[i]);
+        if (c >= 128) {
+          return false;
+        }
+        payload |= static_cast<uint64_t>(c) << (7 * i);
+      }
+      id = makeId(value.size(), payload);
+      return true;
+    }
+
+    static std::string decode(uint64_t id) {
+      uint64_t kind = (id & ~inlineFlag) >> kindShift;
+      uint64_t payload = id & payloadMask;
+      if (kind == positiveIntegerKind) {
+        return std::to_string(payload);
+      }
+      if (kind == negativeIntegerKind) {
+        return "-" + std::to_string(payload);
+      }
+      if (kind == dateKind) {
+        std::string date = std::to_string(payload);
+        date.insert(0, date.size() < 8 ? 8 - date.size() : 0, '0');
+        return date.substr(0, 4) + "-" + date.substr(4, 2) + "-" + date.substr(6, 2);
+      }
+      std::string value;
+      for (uint64_t i = 0; i < kind && i < maxStringSize; i++) {
+        value.push_back(static_cast<char>((payload >> (7 * i)) & 0x7F));
+      }
+      return value;
+    }
+
+  public:
+    ~InlineIdDictionary() noexcept {
+    }
+
+    /**
+     * Checks whether an ID encodes its value inline.
+     */
+    static inline bool isInline(uint64_t id) {
+      return (id & inlineFlag) != 0;
+    }
+
+    void bulkInsert(size_t size, std::string* values) {
+      std::vector<std::string> storedValues;
+      for (size_t i = 0; i < size; i++) {
+        uint64_t id;
+        if (encode(values[i], id)) {
+          inlineIds.push_back(id);
+        }
+        else {
+          storedValues.push_back(values[i]);
+        }
+      }
+      auto byValue = [](uint64_t a, uint64_t b) {
+        return decode(a) < decode(b);
+      };
+      if (!std::is_sorted(inlineIds.begin(), inlineIds.end(), byValue)) {
+        std::sort(inlineIds.begin(), inlineIds.end(), byValue);
+      }
+
+      dictionary.bulkInsert(storedValues.size(), storedValues.data());
+      nextId += storedValues.size();
+    }
+
+    uint64_t insert(std::string value) {
+      uint64_t id;
+      if (encode(value, id)) {
+        auto it = std::lower_bound(inlineIds.begin(), inlineIds.end(), value, precedes);
+        if (it == inlineIds.end() || *it != id) {
+          inlineIds.insert(it, id);
+        }
+        return id;
+      }
+      id = dictionary.insert(value);
+      nextId++;
+      return id;
+    }
+
+    bool lookup(std::string value, uint64_t& id) const {
+      if (encode(value, id)) {
+        return true;
+      }
+      return dictionary.lookup(value, id);
+    }
+
+    bool lookup(uint64_t id, std::string& value) const {
+      if (!isInline(id)) {
+        return dictionary.lookup(id, value);
+      }
+      std::string decoded = decode(id);
+      uint64_t encoded;
+      if (!encode(decoded, encoded) || encoded != id) {
+        return false;
+      }
+      value = decoded;
+      return true;
+    }
+
+    void rangeLookup(std::string prefix, RangeLookupCallbackType callback) const {
+      dictionary.rangeLookup(prefix, callback);
+
+      for (auto it = std::lower_bound(inlineIds.cbegin(), inlineIds.cend(), prefix, precedes); it != inlineIds.cend(); ++it) {
+        std::string value = decode(*it);
+        if (value.compare(0, prefix.size(), prefix) != 0) {
+          break;
+        }
+        callback(*it, value);
+      }
+    }
+
+    std::string description() const {
+      return "Inline/" + dictionary.description();
+    }
+
+    std::string numberOfLeaves() const {
+      return dictionary.numberOfLeaves();
+    }
+
+    bool numbersByRank() const {
+      return false;
+    }
+
+    void debug() const {
+      dictionary.debug();
+    }
+};
+
+template<class TDictionary>
+const uint64_t InlineIdDictionary<TDictionary>::inlineFlag;
+
+template<class TDictionary>
+const unsigned InlineIdDictionary<TDictionary>::kindShift;
+
+template<class TDictionary>
+const uint64_t InlineIdDictionary<TDictionary>::payloadMask;
+
+template<class TDictionary>
+const uint64_t InlineIdDictionary<TDictionary>::maxStringSize;
+
+template<class TDictionary>
+const uint64_t InlineIdDictionary<TDictionary>::positiveIntegerKind;
+
+template<class TDictionary>
+const uint64_t InlineIdDictionary<TDictionary>::negativeIntegerKind;
+
+template<class TDictionary>
+const uint64_t InlineIdDictionary<TDictionary>::dateKind;
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef H_LeafStore
 #define H_LeafStore
 
+#include <cstdint>
 #include <string>
 #include <tuple>
 
@@ -12,6 +13,17 @@ class LeafStore {
     virtual ~LeafStore();
     virtual std::string getValue(uint64_t leafValue) const = 0;
     virtual uint64_t getId(uint64_t leafValue) const = 0;
+
+    /**
+     * Compares bytes [from, to) of a value with the same bytes of a key,
+     * without materializing the value. Bytes behind the end of the value
+     * compare as 0, i.e. like the terminator of the key.
+     *
+     * The default implementation materializes the value via getValue.
+     *
+     * @return Position of the first mismatching byte, or to if all bytes match
+     */
+    virtual unsigned valueMismatch(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const;
 };
 
 #endif
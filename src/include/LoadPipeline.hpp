@@ -0,0 +1,88 @@
+#ifndef H_LoadPipeline
+#define H_LoadPipeline
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "BoundedQueue.hpp"
+#include "Dictionary.hpp"
+#include "ConcurrentEncoder.hpp"
+#include "Semaphore.hpp"
+
+/**
+ * Loads Turtle data into a dictionary and encodes the triples as ID triples.
+ *
+ * Parsing, term encoding and writing run as separate stages connected by
+ * bounded queues. Several threads encode batches concurrently; the writer
+ * restores the input order. The parser starts a batch only after the batch
+ * queueCapacity + numberOfEncoders batches before it has been written, so
+ * the batches held back for reordering take bounded memory. Terms get temporary IDs on their first appearance.
+ * After the input is consumed, the terms are sorted through an ExternalSorter
+ * and bulk loaded into the dictionary in chunks, and the triple file is
+ * rewritten with dictionary IDs.
+ *
+ * The triple file holds three uint64_t IDs (subject, predicate, object) per triple.
+ */
+class LoadPipeline {
+  public:
+    struct Statistics {
+      uint64_t triples = 0;
+      uint64_t terms = 0;
+      uint64_t cacheHits = 0;
+      uint64_t parseErrors = 0;
+      uint64_t sortRuns = 0;
+    };
+
+    /**
+     * Creates a new pipeline.
+     *
+     * @param dictionary Empty dictionary to load the terms into
+     * @param numberOfEncoders Number of threads encoding terms
+     * @param batchSize Number of triples passed between stages at once
+     * @param queueCapacity Maximum number of batches waiting between two stages;
+     *   at most queueCapacity + numberOfEncoders batches are in flight
+     * @param sortMemoryBudget Maximum number of bytes the sorted terms take in memory;
+     *   only holds for dictionaries that number the terms by their rank, the
+     *   others are bulk loaded with all terms in memory
+     */
+    LoadPipeline(Dictionary* dictionary, size_t numberOfEncoders = 1, size_t batchSize = 1024, size_t queueCapacity = 16, uint64_t sortMemoryBudget = 1ull << 30);
+
+    /**
+     * Loads all triples from a Turtle stream.
+     *
+     * @param turtleStream Turtle input
+     * @param tripleFileName File to write the ID triples to
+     * @return Statistics about the load
+     */
+    Statistics run(std::istream& turtleStream, const std::string& tripleFileName);
+
+  private:
+    struct TermTriple {
+      std::string subject, predicate, object;
+    };
+    typedef std::array<uint64_t, 3> IdTriple;
+    // Batches are numbered to restore the input order after concurrent encoding
+    typedef std::pair<uint64_t, std::vector<TermTriple>> TermBatch;
+    typedef std::pair<uint64_t, std::vector<IdTriple>> IdBatch;
+    typedef BoundedQueue<TermBatch> TermQueue;
+    typedef BoundedQueue<IdBatch> IdQueue;
+
+    // Number of terms bulk loaded at once
+    static const size_t chunkSize = 1 << 16;
+
+    Dictionary* dictionary;
+    const size_t numberOfEncoders;
+    const size_t batchSize;
+    const size_t queueCapacity;
+    const uint64_t sortMemoryBudget;
+
+    void parse(std::istream& turtleStream, TermQueue& output, Semaphore& window, Statistics& statistics);
+    void encode(TermQueue& input, IdQueue& output, ConcurrentEncoder& encoder, std::atomic<uint64_t>& cacheHits);
+    void write(IdQueue& input, Semaphore& window, const std::string& fileName, Statistics& statistics);
+    void remap(const std::string& inputFileName, const std::string& outputFileName, const std::vector<uint64_t>& finalIds);
+};
+
+#endif
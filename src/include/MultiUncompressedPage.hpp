@@ -65,9 +65,15 @@ class MultiUncompressedPage : public Page<TSize, MultiUncompressedPage<TSize, TF
       return PageIterator<MultiUncompressedPage<TSize, TFrequency>>(this).gotoOffsetWithDelta(offset, delta);
     }
 
-  private:
+  public:
     class Loader : public page::Loader<MultiUncompressedPage<TSize, TFrequency>> {
+      public:
+        Loader(PageArena<MultiUncompressedPage<TSize, TFrequency>>& arena) : arena(arena) {
+        }
+
       private:
+        PageArena<MultiUncompressedPage<TSize, TFrequency>>& arena;
+
         inline static void call(typename page::Loader<MultiUncompressedPage<TSize, TFrequency>>::CallbackType callback, MultiUncompressedPage<TSize, TFrequency>* page, uint16_t absoluteDeltaNumber, uint16_t relativeDeltaNumber, uint64_t valueAddress, page::IdType id, std::string value) {
           uint64_t pageAddress = reinterpret_cast<uint64_t>(page->getData());
 #ifdef DEBUG
@@ -78,10 +84,8 @@ class MultiUncompressedPage : public Page<TSize, MultiUncompressedPage<TSize, TF
           callback(page, absoluteDeltaNumber, encodeDeltaAndOffset(relativeDeltaNumber, offset), id, value);
         }
       public:
-        void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<MultiUncompressedPage<TSize, TFrequency>>::CallbackType callback) {
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename PageLoader<MultiUncompressedPage<TSize, TFrequency>>::CallbackType callback) {
           MultiUncompressedPage<TSize, TFrequency>* currentPage = nullptr;
-          MultiUncompressedPage<TSize, TFrequency>* lastPage = nullptr;
-          const char* endOfPage = nullptr;
           char* dataPtr = nullptr;
           uint16_t absoluteDeltaNumber = 0;
           uint16_t relativeDeltaNumber = 0;
@@ -90,43 +94,56 @@ class MultiUncompressedPage : public Page<TSize, MultiUncompressedPage<TSize, TF
 
           const std::string* deltaRef = nullptr;
           uintptr_t valuePtr = 0;
-
-          for (const auto& pair : values) {
-            if (absoluteDeltaNumber%TFrequency == 0) {
-              // Will insert full string
-              if (dataPtr != nullptr && dataPtr + prefixHeaderSize + pair.second.size() > endOfPage) {
-                // "Finish" page
-                this->endPage(dataPtr);
-                lastPage = currentPage;
-                currentPage = nullptr;
+          auto pageEnd = values.cend();
+
+          // End of the values that fit on a page starting at start; every
+          // TFrequency-th value is stored uncompressed
+          auto reach = [&](decltype(values.cbegin()) start) {
+            uint64_t pageSize = 0;
+            const std::string* ref = nullptr;
+            auto endIt = start;
+            for (uint64_t count = 0; endIt != values.cend(); ++endIt, ++count) {
+              uint64_t size = count%TFrequency == 0 ? prefixHeaderSize + this->storedSize(endIt->second) : deltaHeaderSize + this->deltaLength(*ref, endIt->second);
+              if (count > 0 && pageSize + size > TSize - sizeof(uint8_t)) {
+                break;
               }
-            }
-            else {
-              // Will insert delta
-              auto deltaSize = this->deltaLength(*deltaRef, pair.second);
-              if (dataPtr != nullptr && dataPtr + deltaHeaderSize + deltaSize > endOfPage) {
-                // "Finish" page
-                this->endPage(dataPtr);
-                lastPage = currentPage;
-                currentPage = nullptr;
+              pageSize += size;
+              if (count%TFrequency == 0) {
+                ref = &endIt->second;
               }
             }
+            return endIt;
+          };
+
+          for (auto pairIt = values.cbegin(); pairIt != values.cend(); ++pairIt) {
+            const auto& pair = *pairIt;
+            if (dataPtr != nullptr && pairIt == pageEnd) {
+              // "Finish" page
+              this->endPage(dataPtr);
+              this->lastPage = currentPage;
+              currentPage = nullptr;
+            }
 
             if (currentPage == nullptr) {
+              pageEnd = this->pageEnd(pairIt, values.cend(), reach);
+              if (pageEnd == pairIt) {
+                // Leave the values to the next chunk
+                return static_cast<size_t>(pairIt - values.cbegin());
+              }
+
               // Create new page
-              currentPage = new MultiUncompressedPage<TSize, TFrequency>();
-              if (lastPage != nullptr) {
-                lastPage->nextPage = currentPage;
+              currentPage = new (arena) MultiUncompressedPage<TSize, TFrequency>();
+              if (this->lastPage != nullptr) {
+                this->lastPage->nextPage = currentPage;
               }
               dataPtr = currentPage->data;
-              endOfPage = currentPage->data + currentPage->size - sizeof(uint8_t);
               absoluteDeltaNumber = 0;
             }
 
             if (absoluteDeltaNumber%TFrequency==0) {
               valuePtr = this->startPrefix(dataPtr);
               this->writeId(dataPtr, pair.first);
-              this->writeValue(dataPtr, pair.second);
+              this->writeValue(dataPtr, pair.second, arena.blobs);
               deltaRef = &pair.second;
               relativeDeltaNumber = 0;
             }
@@ -150,13 +167,14 @@ class MultiUncompressedPage : public Page<TSize, MultiUncompressedPage<TSize, TF
             call(callback, currentPage, absoluteDeltaNumber++, relativeDeltaNumber++, valuePtr, pair.first, pair.second);
           }
           this->endPage(dataPtr);
-          lastPage = currentPage;
+          this->lastPage = currentPage;
+          return values.size();
         }
     };
 
   public:
-    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<MultiUncompressedPage<TSize, TFrequency>>::CallbackType callback) {
-      Loader().load(values, callback);
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<MultiUncompressedPage<TSize, TFrequency>>::CallbackType callback, PageArena<MultiUncompressedPage<TSize, TFrequency>>& arena) {
+      Loader(arena).load(values, callback);
     }
 
     static std::string description() {
@@ -0,0 +1,225 @@
+#ifndef H_NamespaceDictionary
+#define H_NamespaceDictionary
+
+#include "Dictionary.hpp"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Dictionary layer factoring out the namespaces of IRIs.
+ *
+ * Values are split after their last '/' or '#'. Namespaces used by several
+ * values get an ID, and the wrapped dictionary stores the encoded ID followed
+ * by the local name instead of the value, so neither its pages nor its string
+ * index repeat the namespace. The most frequent namespaces get one byte IDs,
+ * the others two bytes; values without a namespace in the table are stored
+ * behind the code of namespace 0, which is empty.
+ *
+ * The namespace table is built during the first bulk load and frozen
+ * afterwards; later bulk loads and single inserts only use the namespaces
+ * already in the table, so every value keeps one encoding.
+ */
+template<class TDictionary>
+class NamespaceDictionary final : public Dictionary {
+  private:
+    // Namespace IDs below oneByteIds are encoded in one byte, the others in
+    // two; no byte of a code is zero
+    static const uint64_t oneByteIds = 127;
+    static const uint64_t maxNamespaces = oneByteIds + 128 * 255;
+    // Namespaces need to be shared by this many values to get an ID
+    static const uint64_t minimumUses = 2;
+
+    TDictionary dictionary;
+    std::vector<std::string> namespaces;
+    std::map<std::string, uint64_t> namespaceIds;
+    bool frozen;
+
+    static inline size_t localNameStart(const std::string& value) {
+      size_t separator = value.find_last_of("/#");
+      return separator == std::string::npos ? 0 : separator + 1;
+    }
+
+    static inline void encodeId(std::string& code, uint64_t namespaceId) {
+      if (namespaceId < oneByteIds) {
+        code.push_back(static_cast<char>(namespaceId + 1));
+      }
+      else {
+        namespaceId -= oneByteIds;
+        code.push_back(static_cast<char>(128 + namespaceId / 255));
+        code.push_back(static_cast<char>(1 + namespaceId % 255));
+      }
+    }
+
+    static inline uint64_t decodeId(const std::string& code, size_t& codeSize) {
+      uint8_t first = static_cast<uint8_t>(code[0]);
+      if (first < 128) {
+        codeSize = 1;
+        return first - 1;
+      }
+      codeSize = 2;
+      return oneByteIds + (first - 128) * 255 + static_cast<uint8_t>(code[1]) - 1;
+    }
+
+    std::string encode(const std::string& value) const {
+      std::string code;
+      size_t start = localNameStart(value);
+      auto it = start == 0 ? namespaceIds.cend() : namespaceIds.find(value.substr(0, start));
+      if (it == namespaceIds.cend()) {
+        encodeId(code, 0);
+        code.append(value);
+      }
+      else {
+        encodeId(code, it->second);
+        code.append(value, start, std::string::npos);
+      }
+      return code;
+    }
+
+    std::string decode(const std::string& code) const {
+      size_t codeSize;
+      uint64_t namespaceId = decodeId(code, codeSize);
+      return namespaces[namespaceId] + code.substr(codeSize);
+    }
+
+    void rangeLookup(uint64_t namespaceId, const std::string& localPrefix, RangeLookupCallbackType callback) const {
+      std::string code;
+      encodeId(code, namespaceId);
+      code.append(localPrefix);
+      dictionary.rangeLookup(code, [&](uint64_t id, std::string value) {
+        callback(id, decode(value));
+      });
+    }
+
+    /**
+     * Numbers the namespaces of the values by how often they are used.
+     */
+    void numberNamespaces(size_t size, std::string* values) {
+      std::unordered_map<std::string, uint64_t> uses;
+      for (size_t i = 0; i < size; i++) {
+        size_t start = localNameStart(values[i]);
+        if (start > 0) {
+          uses[values[i].substr(0, start)]++;
+        }
+      }
+
+      std::vector<std::pair<uint64_t, std::string>> frequentNamespaces;
+      for (auto& pair : uses) {
+        if (pair.second >= minimumUses) {
+          frequentNamespaces.push_back(std::make_pair(pair.second, pair.first));
+        }
+      }
+      std::sort(frequentNamespaces.begin(), frequentNamespaces.end(), [](const std::pair<uint64_t, std::string>& a, const std::pair<uint64_t, std::string>& b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+      });
+
+      for (auto& pair : frequentNamespaces) {
+        if (namespaces.size() == maxNamespaces) {
+          break;
+        }
+        namespaceIds[pair.second] = namespaces.size();
+        namespaces.push_back(std::move(pair.second));
+      }
+    }
+
+  public:
+    NamespaceDictionary() : namespaces(1), frozen(false) {
+    }
+
+    ~NamespaceDictionary() noexcept {
+    }
+
+    void bulkInsert(size_t size, std::string* values) {
+      if (!frozen) {
+        numberNamespaces(size, values);
+        frozen = true;
+      }
+
+      std::vector<std::string> codes;
+      codes.reserve(size);
+      for (size_t i = 0; i < size; i++) {
+        codes.push_back(encode(values[i]));
+      }
+      std::sort(codes.begin(), codes.end());
+
+      dictionary.bulkInsert(codes.size(), codes.data());
+      nextId += size;
+    }
+
+    uint64_t insert(std::string value) {
+      frozen = true;
+      uint64_t id = dictionary.insert(encode(value));
+      nextId++;
+      return id;
+    }
+
+    bool lookup(std::string value, uint64_t& id) const {
+      return dictionary.lookup(encode(value), id);
+    }
+
+    bool lookup(uint64_t id, std::string& value) const {
+      std::string code;
+      if (!dictionary.lookup(id, code)) {
+        return false;
+      }
+      value = decode(code);
+      return true;
+    }
+
+    void rangeLookup(std::string prefix, RangeLookupCallbackType callback) const {
+      // Values without a namespace in the table
+      rangeLookup(0, prefix, callback);
+
+      // Namespaces the prefix is a part of
+      for (auto it = namespaceIds.lower_bound(prefix); it != namespaceIds.cend() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        rangeLookup(it->second, "", callback);
+      }
+
+      // The namespace of the prefix, if it ends in a local name; shorter
+      // namespaces can't match, as local names have no separators
+      size_t start = localNameStart(prefix);
+      if (start > 0 && start < prefix.size()) {
+        auto it = namespaceIds.find(prefix.substr(0, start));
+        if (it != namespaceIds.cend()) {
+          rangeLookup(it->second, prefix.substr(start), callback);
+        }
+      }
+    }
+
+    std::string description() const {
+      return "Namespaces/" + dictionary.description();
+    }
+
+    std::string numberOfLeaves() const {
+      return dictionary.numberOfLeaves();
+    }
+
+    bool numbersByRank() const {
+      // The wrapped dictionary ranks the encoded values
+      return false;
+    }
+
+    void debug() const {
+      dictionary.debug();
+    }
+
+    /**
+     * Returns the number of namespaces with an ID, including the empty one.
+     */
+    uint64_t numberOfNamespaces() const {
+      return namespaces.size();
+    }
+};
+
+template<class TDictionary>
+const uint64_t NamespaceDictionary<TDictionary>::oneByteIds;
+
+template<class TDictionary>
+const uint64_t NamespaceDictionary<TDictionary>::maxNamespaces;
+
+template<class TDictionary>
+const uint64_t NamespaceDictionary<TDictionary>::minimumUses;
+
+#endif
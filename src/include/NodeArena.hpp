@@ -0,0 +1,75 @@
+#ifndef H_NodeArena
+#define H_NodeArena
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Size-class arena allocator for tree nodes.
+ *
+ * Nodes are carved out of 2 MB slabs, which can be backed by huge pages.
+ * Freed nodes go to a free list for their size class and are reused by
+ * later allocations of the same size. All slabs are released at once when
+ * the arena is destroyed, so a tree never has to be traversed for teardown.
+ */
+class NodeArena {
+  public:
+    static const size_t slabSize = 2 << 20;
+    static const size_t granularity = 16;
+    static const size_t maxNodeSize = 4096;
+
+    /**
+     * Creates a new arena.
+     *
+     * @param hugePages Back slabs by huge pages, if the system allows it
+     */
+    NodeArena(bool hugePages = false);
+    NodeArena(NodeArena&& other);
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    /**
+     * Allocates uninitialized memory for a node.
+     *
+     * @param size Size of the node in bytes, at most maxNodeSize
+     * @return Pointer to the memory, aligned to granularity
+     */
+    void* allocate(size_t size);
+
+    /**
+     * Returns memory of a node to the arena for reuse.
+     *
+     * @param node Pointer returned by allocate()
+     * @param size Size passed to allocate()
+     */
+    void deallocate(void* node, size_t size);
+
+    /**
+     * Returns the number of bytes reserved for slabs.
+     * @return Reserved bytes
+     */
+    uint64_t reservedMemory() const;
+
+  private:
+    struct FreeNode {
+      FreeNode* next;
+    };
+
+    bool hugePages;
+    std::vector<void*> slabs;
+    char* slabPtr;
+    size_t slabRemaining;
+    std::array<FreeNode*, maxNodeSize / granularity + 1> freeLists;
+
+    static size_t sizeClass(size_t size) {
+      return (size + granularity - 1) / granularity;
+    }
+
+    void newSlab();
+};
+
+#endif
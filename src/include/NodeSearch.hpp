@@ -0,0 +1,77 @@
+#ifndef H_NodeSearch
+#define H_NodeSearch
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Search kernels for the key arrays of ART inner nodes.
+ *
+ * Node4 and Node16 keys are searched with SSE2/SWAR, which every x86-64
+ * CPU supports. The 256-byte child index of a Node48 is scanned with the
+ * widest kernel available (SSE2, AVX2 or AVX-512BW), chosen once at startup.
+ */
+namespace nodesearch {
+  /**
+   * Finds a key byte in the (unsorted) keys of a Node4.
+   * @return Position of the key byte, or count if not found
+   */
+  unsigned find4(const uint8_t keys[4], unsigned count, uint8_t keyByte);
+
+  /**
+   * Finds a key byte in the sign-flipped keys of a Node16.
+   * @return Position of the key byte, or count if not found
+   */
+  unsigned find16(const uint8_t keys[16], unsigned count, uint8_t flippedKeyByte);
+
+  /**
+   * Finds the first sign-flipped, sorted Node16 key greater than the given key byte.
+   * @return Position of the key, or count if there is none
+   */
+  unsigned greater16(const uint8_t keys[16], unsigned count, uint8_t flippedKeyByte);
+
+  /**
+   * Finds the last sign-flipped, sorted Node16 key lower than the given key byte.
+   * @return Position of the key, or count if there is none
+   */
+  unsigned lower16(const uint8_t keys[16], unsigned count, uint8_t flippedKeyByte);
+
+  /**
+   * Scan functions for the child index of a Node48.
+   */
+  struct OccupancyKernel {
+    const char* name;
+    /**
+     * @return First position >= from whose entry is not emptyMarker, or 256 if there is none
+     */
+    unsigned (*next)(const uint8_t childIndex[256], unsigned from, uint8_t emptyMarker);
+    /**
+     * @return Last position < to whose entry is not emptyMarker, or 256 if there is none
+     */
+    unsigned (*previous)(const uint8_t childIndex[256], unsigned to, uint8_t emptyMarker);
+  };
+
+  /**
+   * Returns all Node48 scan kernels the CPU supports, widest last.
+   */
+  const std::vector<OccupancyKernel>& supportedKernels();
+
+  /**
+   * Kernel used by nextOccupied/previousOccupied. Chosen on first use, so
+   * that static initializers of other translation units can search nodes.
+   */
+  inline const OccupancyKernel& kernel() {
+    static const OccupancyKernel& widest = supportedKernels().back();
+    return widest;
+  }
+
+  inline unsigned nextOccupied(const uint8_t childIndex[256], unsigned from, uint8_t emptyMarker) {
+    return kernel().next(childIndex, from, emptyMarker);
+  }
+
+  inline unsigned previousOccupied(const uint8_t childIndex[256], unsigned to, uint8_t emptyMarker) {
+    return kernel().previous(childIndex, to, emptyMarker);
+  }
+}
+
+#endif
@@ -4,20 +4,20 @@
 #include "StrategyBase.hpp"
 
 template<class TIdIndex, class TStringIndex, class TLeaf>
-class OffsetStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf> {
+class OffsetStrategy : public StrategyBase<TIdIndex, TStringIndex, TLeaf, OffsetStrategy<TIdIndex, TStringIndex, TLeaf>> {
   public:
-    OffsetStrategy(TIdIndex& idIndex, TStringIndex& strIndex) : StrategyBase<TIdIndex, TStringIndex, TLeaf>(idIndex, strIndex) {
+    OffsetStrategy(TIdIndex& idIndex, TStringIndex& strIndex, const typename page::ArenaOf<TLeaf>::type& arena) : StrategyBase<TIdIndex, TStringIndex, TLeaf, OffsetStrategy>(idIndex, strIndex, arena) {
     }
 
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue) const;
     void leafCallback(TLeaf* leaf, uint16_t deltaNumber, uint16_t offset, uint64_t id, std::string value);
     //TODO: why!??
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, uint64_t lookupId) const {
-      return StrategyBase<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(leafValue, lookupId);
+      return StrategyBase<TIdIndex, TStringIndex, TLeaf, OffsetStrategy>::decodeLeaf(leafValue, lookupId);
     }
 
     PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, std::string lookupValue) const {
-      return StrategyBase<TIdIndex, TStringIndex, TLeaf>::decodeLeaf(leafValue, lookupValue);
+      return StrategyBase<TIdIndex, TStringIndex, TLeaf, OffsetStrategy>::decodeLeaf(leafValue, lookupValue);
     }
 };
 
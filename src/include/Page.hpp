@@ -1,15 +1,19 @@
 #ifndef H_Page
 #define H_Page
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <limits>
 #include <string>
+#include <type_traits>
 #include <vector>
 #undef NDEBUG
 #include <cassert>
+#include "BlobStore.hpp"
 #include "Exception.hpp"
+#include "PageArena.hpp"
 #include <iostream>
 
 namespace page {
@@ -22,6 +26,10 @@ namespace page {
   typedef uint16_t PrefixSizeType;
   typedef std::pair<IdType, std::string> Leaf;
 
+  // Size of uncompressed values that are stored in the blob store of the
+  // arena; the entry holds a reference to the blob instead of the bytes
+  static const StringSizeType overflowMarker = std::numeric_limits<StringSizeType>::max();
+
   enum Header : HeaderType {
     StartOfUncompressedValue = 0,
     StartOfDelta = 1,
@@ -61,16 +69,6 @@ namespace page {
     return static_cast<Header>(read<HeaderType>(dataPtr));
   }
 
-  static inline void skipIndex(char*& dataPtr) {
-    assert(page::readHeader(dataPtr) == page::Header::StartOfIndex);
-    page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(dataPtr);
-    page::advance<OffsetType>(dataPtr, indexEntries);
-#ifdef DEBUG
-    char* readPtr = dataPtr;
-    assert(page::readHeader(readPtr) == page::Header::StartOfUncompressedValue);
-#endif
-  }
-
   // Write
 
   template<class T> static inline void write(char*& dataPtr, T value) {
@@ -87,16 +85,12 @@ namespace page {
     write<HeaderType>(dataPtr, flag);
   }
 
-  inline PrefixSizeType prefixLength(const char* ref, size_t refSize, const std::string& value) {
+  inline uint64_t prefixLength(const char* ref, uint64_t refSize, const std::string& value) {
     uint64_t pos = 0;
     while (pos < refSize && pos < value.size() && ref[pos] == value[pos]) {
       pos++;
     }
-#ifdef DEBUG
-    assert(pos <= std::numeric_limits<PrefixSizeType>::max());
-    assert(value.size()-pos <= std::numeric_limits<StringSizeType>::max());
-#endif
-    return static_cast<PrefixSizeType>(pos);
+    return pos;
   }
 
   template<typename T>
@@ -118,13 +112,215 @@ namespace page {
     return delta;
   }
 
+  /**
+   * Layout of the entry headers: one header byte, followed by fixed-size
+   * prefix and string lengths.
+   */
+  class FixedLayout {
+    public:
+      static inline HeaderType tag(Header header) {
+        return header;
+      }
+
+      static inline Header header(HeaderType tag) {
+        return static_cast<Header>(tag);
+      }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+      static inline PrefixSizeType readPrefixSize(HeaderType tag, char*& dataPtr) {
+        return read<PrefixSizeType>(dataPtr);
+      }
+
+      static inline StringSizeType readStringSize(HeaderType tag, char*& dataPtr) {
+        return read<StringSizeType>(dataPtr);
+      }
+
+      static inline void writePrefixSize(char* tagPtr, char*& dataPtr, PrefixSizeType prefixSize) {
+        write<PrefixSizeType>(dataPtr, prefixSize);
+      }
+
+      static inline void writeStringSize(char* tagPtr, char*& dataPtr, StringSizeType size) {
+        write<StringSizeType>(dataPtr, size);
+      }
+
+      /**
+       * Returns the size of the header and lengths of an entry, without the ID.
+       */
+      static inline uint64_t headerSize(bool delta, PrefixSizeType prefixSize, StringSizeType size) {
+        return sizeof(HeaderType) + (delta ? sizeof(PrefixSizeType) : 0) + sizeof(StringSizeType);
+      }
+#pragma GCC diagnostic pop
+  };
+
+  /**
+   * Layout of the entry headers with packed lengths: the header flag takes
+   * the upper two bits of the header byte, string lengths below 63 the
+   * lower six. Prefix lengths and longer string lengths are stored as
+   * varints (7 bits per byte), so most deltas need two header bytes.
+   */
+  class PackedLayout {
+    private:
+      static const HeaderType lengthMask = 0x3F;
+
+      static inline uint16_t readVarint(char*& dataPtr) {
+        uint16_t value = 0;
+        unsigned shift = 0;
+        uint8_t byte;
+        do {
+          byte = read<uint8_t>(dataPtr);
+          value |= static_cast<uint16_t>((byte & 0x7F) << shift);
+          shift += 7;
+        } while (byte & 0x80);
+        return value;
+      }
+
+      static inline void writeVarint(char*& dataPtr, uint16_t value) {
+        while (value >= 0x80) {
+          write<uint8_t>(dataPtr, static_cast<uint8_t>(value | 0x80));
+          value >>= 7;
+        }
+        write<uint8_t>(dataPtr, static_cast<uint8_t>(value));
+      }
+
+      static inline uint64_t varintSize(uint16_t value) {
+        return value < (1 << 7) ? 1 : value < (1 << 14) ? 2 : 3;
+      }
+
+    public:
+      static inline HeaderType tag(Header header) {
+        return static_cast<HeaderType>(header << 6);
+      }
+
+      static inline Header header(HeaderType tag) {
+        return static_cast<Header>(tag >> 6);
+      }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+      static inline PrefixSizeType readPrefixSize(HeaderType tag, char*& dataPtr) {
+        return readVarint(dataPtr);
+      }
+#pragma GCC diagnostic pop
+
+      static inline StringSizeType readStringSize(HeaderType tag, char*& dataPtr) {
+        StringSizeType size = tag & lengthMask;
+        if (size == lengthMask) {
+          size = static_cast<StringSizeType>(size + readVarint(dataPtr));
+        }
+        return size;
+      }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+      static inline void writePrefixSize(char* tagPtr, char*& dataPtr, PrefixSizeType prefixSize) {
+        writeVarint(dataPtr, prefixSize);
+      }
+#pragma GCC diagnostic pop
+
+      static inline void writeStringSize(char* tagPtr, char*& dataPtr, StringSizeType size) {
+        if (size < lengthMask) {
+          *tagPtr = static_cast<char>(*tagPtr | size);
+        }
+        else {
+          *tagPtr = static_cast<char>(*tagPtr | lengthMask);
+          writeVarint(dataPtr, static_cast<uint16_t>(size - lengthMask));
+        }
+      }
+
+      static inline uint64_t headerSize(bool delta, PrefixSizeType prefixSize, StringSizeType size) {
+        return sizeof(HeaderType) + (delta ? varintSize(prefixSize) : 0) + (size < lengthMask ? 0 : varintSize(static_cast<uint16_t>(size - lengthMask)));
+      }
+  };
+
+  /**
+   * Header layout of a page type: TPage::Layout if it is defined, FixedLayout otherwise.
+   */
+  template<class TPage>
+    class LayoutOf {
+      private:
+        template<class T> static typename T::Layout test(typename T::Layout*);
+        template<class T> static FixedLayout test(...);
+
+      public:
+        typedef decltype(test<TPage>(nullptr)) type;
+    };
+
+  /**
+   * Owner of pages that are not allocated from an arena.
+   */
+  struct NoArena {
+  };
+
+  /**
+   * Arena a page type is allocated from: TPage::Arena if it is defined, NoArena otherwise.
+   */
+  template<class TPage>
+    class ArenaOf {
+      private:
+        template<class T> static typename T::Arena test(typename T::Arena*);
+        template<class T> static NoArena test(...);
+
+      public:
+        typedef decltype(test<TPage>(nullptr)) type;
+    };
+
   template<class TPage>
     class Loader {
       public:
         typedef std::function<void(TPage*, page::IndexEntriesType, uint16_t, IdType, std::string)> CallbackType;
         virtual ~Loader() { }
-        virtual void load(std::vector<std::pair<page::IdType, std::string>> values, CallbackType callback) = 0;
+
+        /**
+         * Writes pages for sorted values, linked to the pages of earlier calls.
+         *
+         * @return Number of values written; all of them, unless more values
+         *   follow (see loadChunk)
+         */
+        virtual size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, CallbackType callback) = 0;
+
+        /**
+         * Writes pages for a chunk of a larger, sorted input. Where a page
+         * ends can depend on the values behind it, so the values of pages
+         * reaching the end of a chunk are kept and written with the next one.
+         * Loading chunk by chunk thus gives the same pages as loading all
+         * values at once.
+         *
+         * @param last Whether this is the last chunk
+         */
+        void loadChunk(std::vector<std::pair<page::IdType, std::string>> values, CallbackType callback, bool last) {
+          if (!pending.empty()) {
+            pending.insert(pending.end(), std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+            values.swap(pending);
+          }
+          moreValues = !last;
+          size_t loaded = load(values, callback);
+          moreValues = false;
+          pending.assign(std::make_move_iterator(values.begin() + static_cast<int64_t>(loaded)), std::make_move_iterator(values.end()));
+        }
+
       protected:
+        typedef typename LayoutOf<TPage>::type Layout;
+
+        // Header byte of the value being written, which may hold its length
+        char* entryTag;
+
+        // Whether more values follow the ones passed to load()
+        bool moreValues;
+
+        // Page written last, to be linked to the next one
+        TPage* lastPage;
+
+        // Values of a chunk that are written with the next one
+        std::vector<std::pair<page::IdType, std::string>> pending;
+
+        // Page cuts move back by at most this fraction of a page's values,
+        // and at most by this many values
+        static const int64_t boundaryWindow = 4;
+        static const int64_t maxBoundaryCandidates = 32;
+
+        Loader() : entryTag(nullptr), moreValues(false), lastPage(nullptr) { }
+
         inline static void call(CallbackType callback, TPage* page, uint16_t deltaNumber, uint64_t valueAddress, IdType id, std::string value) {
           uint64_t pageAddress = reinterpret_cast<uint64_t>(page->getData());
 #ifdef DEBUG
@@ -134,43 +330,127 @@ namespace page {
           callback(page, deltaNumber, offset, id, value);
         }
 
-        inline StringSizeType deltaLength(const std::string& ref, const std::string& value) {
-          uint64_t pos = 0;
-          while (pos < ref.size() && pos < value.size() && ref[pos] == value[pos]) {
-            pos++;
-          }
-#ifdef DEBUG
-          assert(pos <= std::numeric_limits<PrefixSizeType>::max());
-          assert(value.size()-pos <= std::numeric_limits<StringSizeType>::max());
-#endif
-          return static_cast<StringSizeType>(value.size()-pos);
+        inline uint64_t deltaLength(const std::string& ref, const std::string& value) {
+          return value.size() - prefixLength(ref.c_str(), ref.size(), value);
         }
 
         inline std::string delta(const std::string& ref, const std::string& value, PrefixSizeType& prefixSize) {
           return page::delta(ref, value, prefixSize);
         }
 
+        /**
+         * Returns whether an uncompressed value is stored in the blob store.
+         * A page holds at most one value longer than half of it, so these
+         * values gain nothing from being stored in the page, and values
+         * longer than the page cannot be stored there at all.
+         */
+        static inline bool overflows(const std::string& value) {
+          return value.size() > TPage::size / 2;
+        }
+
+        /**
+         * Returns the bytes a value takes in the page when stored uncompressed.
+         */
+        static inline uint64_t storedSize(const std::string& value) {
+          return overflows(value) ? sizeof(const char*) : value.size();
+        }
+
+        /**
+         * Returns the bytes needed to store a value uncompressed, without its ID.
+         */
+        inline uint64_t valueEntrySize(const std::string& value) {
+          StringSizeType size = overflows(value) ? overflowMarker : static_cast<StringSizeType>(value.size());
+          return Layout::headerSize(false, 0, size) + storedSize(value);
+        }
+
+        /**
+         * Returns the bytes needed to store a value as delta to ref, without its ID.
+         */
+        inline uint64_t deltaEntrySize(const std::string& ref, const std::string& value) {
+          uint64_t prefixSize = prefixLength(ref.c_str(), ref.size(), value);
+          uint64_t size = value.size() - prefixSize;
+          // Deltas that don't fit in the lengths don't fit on a page either
+          return Layout::headerSize(true, static_cast<PrefixSizeType>(page::min<uint64_t>(prefixSize, std::numeric_limits<PrefixSizeType>::max())), static_cast<StringSizeType>(page::min<uint64_t>(size, std::numeric_limits<StringSizeType>::max()))) + size;
+        }
+
+        /**
+         * Chooses where a page ends.
+         *
+         * reach(start) returns the end of the values that fit on a page
+         * starting at start. Values are compressed against the first value of
+         * their page, so filling a page greedily can start the next page in
+         * the middle of a prefix group, which then compresses badly. The cut
+         * can move back by up to a boundaryWindow-th of the page; of these,
+         * the one letting the next page reach furthest is picked. Ties prefer
+         * cuts at prefix group changes, i.e. where the values around the cut
+         * share the fewest bytes, and then fuller pages.
+         *
+         * @return The end of the values to put on the page starting at first,
+         *   or first if more values follow and the choice depends on them
+         */
+        template<class TIterator, class TReach>
+        TIterator pageEnd(TIterator first, TIterator last, TReach reach) const {
+          TIterator end = reach(first);
+          if (end == last) {
+            return moreValues ? first : end;
+          }
+
+          auto shared = [](const std::string& value1, const std::string& value2) {
+            uint64_t pos = 0;
+            while (pos < value1.size() && pos < value2.size() && value1[pos] == value2[pos]) {
+              pos++;
+            }
+            return pos;
+          };
+
+          const int64_t window = std::min<int64_t>((end - first) / boundaryWindow, maxBoundaryCandidates);
+          TIterator best = end;
+          TIterator bestReach = reach(end);
+          if (moreValues && bestReach == last) {
+            return first;
+          }
+          uint64_t bestShared = shared((end-1)->second, end->second);
+          for (TIterator cut = end - 1; cut - first > 0 && end - cut <= window; --cut) {
+            TIterator cutReach = reach(cut);
+            if (moreValues && cutReach == last) {
+              return first;
+            }
+            uint64_t cutShared = shared((cut-1)->second, cut->second);
+            if (cutReach > bestReach || (cutReach == bestReach && cutShared < bestShared)) {
+              best = cut;
+              bestReach = cutReach;
+              bestShared = cutShared;
+            }
+          }
+          return best;
+        }
+
+        inline void writeTag(char*& dataPtr, page::Header header) {
+          entryTag = dataPtr;
+          page::write<HeaderType>(dataPtr, Layout::tag(header));
+        }
+
         // Start/End blocks
         uintptr_t startPrefix(char*& dataPtr) {
           uintptr_t ptrVal = reinterpret_cast<uintptr_t>(dataPtr);
-          writeHeader(dataPtr, page::Header::StartOfUncompressedValue);
+          writeTag(dataPtr, page::Header::StartOfUncompressedValue);
           return ptrVal;
         }
 
         uintptr_t startIndex(char*& dataPtr) {
           uintptr_t ptrVal = reinterpret_cast<uintptr_t>(dataPtr);
-          writeHeader(dataPtr, page::Header::StartOfIndex);
+          writeTag(dataPtr, page::Header::StartOfIndex);
           return ptrVal;
         }
 
         uintptr_t startDelta(char*& dataPtr) {
           uintptr_t ptrVal = reinterpret_cast<uintptr_t>(dataPtr);
-          writeHeader(dataPtr, page::Header::StartOfDelta);
+          writeTag(dataPtr, page::Header::StartOfDelta);
           return ptrVal;
         }
 
         void endPage(char*& dataPtr) {
-          writeHeader(dataPtr, page::Header::EndOfPage);
+          writeTag(dataPtr, page::Header::EndOfPage);
         }
 
         // Write values
@@ -180,18 +460,51 @@ namespace page {
 
         void writeValue(char*& dataPtr, const std::string& value) {
 #ifdef DEBUG
-          assert(value.size() <= std::numeric_limits<StringSizeType>::max());
+          assert(value.size() < overflowMarker);
 #endif
-          page::write<StringSizeType>(dataPtr, static_cast<StringSizeType>(value.size()));
+          Layout::writeStringSize(entryTag, dataPtr, static_cast<StringSizeType>(value.size()));
           page::writeString(dataPtr, value);
         }
 
+        /**
+         * Writes an uncompressed value, or a reference to it if it overflows.
+         */
+        void writeValue(char*& dataPtr, const std::string& value, BlobStore& blobs) {
+          if (overflows(value)) {
+            Layout::writeStringSize(entryTag, dataPtr, overflowMarker);
+            page::write<const char*>(dataPtr, blobs.store(value.c_str(), value.size()));
+          }
+          else {
+            writeValue(dataPtr, value);
+          }
+        }
+
         void writeDelta(char*& dataPtr, const std::string& delta, PrefixSizeType prefixSize) {
-          page::write(dataPtr, prefixSize);
+          Layout::writePrefixSize(entryTag, dataPtr, prefixSize);
           writeValue(dataPtr, delta);
         }
     };
 
+    template<class TPage>
+    const int64_t Loader<TPage>::boundaryWindow;
+
+    template<class TPage>
+    const int64_t Loader<TPage>::maxBoundaryCandidates;
+
+  /**
+   * Pages that provide idOf(entry) derive the ID of a value from its
+   * position instead of storing it with every value.
+   */
+  template<class TPage>
+    class ImplicitIds {
+      private:
+        template<class T> static std::true_type test(decltype(&T::idOf));
+        template<class T> static std::false_type test(...);
+
+      public:
+        static const bool value = decltype(test<TPage>(nullptr))::value;
+    };
+
   template<class TPage>
     class Iterator {
       friend TPage;
@@ -200,13 +513,81 @@ namespace page {
       char* dataPtr;
       TPage* currentPage;
       TPage* nextPage;
-      char* startOfFullString;
+      const char* startOfFullString;
+      // Position of the current value in its page (0 = uncompressed value);
+      // only kept up to date for pages with implicit IDs
+      page::IndexEntriesType entry;
+
+      static const bool implicitIds = ImplicitIds<TPage>::value;
+
+      typedef typename LayoutOf<TPage>::type Layout;
+      // Header byte read last; lengths of the same entry may be packed into it
+      mutable HeaderType tag;
+
+      inline page::Header readHeader(char*& readPtr) const {
+        tag = page::read<HeaderType>(readPtr);
+        return Layout::header(tag);
+      }
+
+      inline PrefixSizeType readPrefixSize(char*& readPtr) const {
+        return Layout::readPrefixSize(tag, readPtr);
+      }
+
+      inline StringSizeType readStringSize(char*& readPtr) const {
+        return Layout::readStringSize(tag, readPtr);
+      }
+
+      /**
+       * Reads the size and bytes of an uncompressed value, following the
+       * reference to the blob store if the value overflows.
+       */
+      inline const char* readValue(char*& readPtr, uint64_t& size) const {
+        StringSizeType storedSize = readStringSize(readPtr);
+        if (storedSize == overflowMarker) {
+          const char* blob = page::read<const char*>(readPtr);
+          size = BlobStore::size(blob);
+          return BlobStore::bytes(blob);
+        }
+        size = storedSize;
+        return page::readString(readPtr, storedSize);
+      }
+
+      inline void skipIndexSection(char*& readPtr) const {
+        assert(readHeader(readPtr) == page::Header::StartOfIndex);
+        page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(readPtr);
+        page::advance<OffsetType>(readPtr, indexEntries);
+#ifdef DEBUG
+        char* checkPtr = readPtr;
+        assert(readHeader(checkPtr) == page::Header::StartOfUncompressedValue);
+#endif
+      }
+
+      inline void skipId(char*& readPtr) const {
+        if (!implicitIds) {
+          page::advance<IdType>(readPtr);
+        }
+      }
+
+      inline IdType readId(char*& readPtr, page::IndexEntriesType entryNumber) const {
+        return readId(readPtr, entryNumber, std::integral_constant<bool, implicitIds>());
+      }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+      inline IdType readId(char*& readPtr, page::IndexEntriesType entryNumber, std::false_type) const {
+        return page::read<IdType>(readPtr);
+      }
+
+      inline IdType readId(char*& readPtr, page::IndexEntriesType entryNumber, std::true_type) const {
+        return currentPage->idOf(entryNumber);
+      }
+#pragma GCC diagnostic pop
 
       public:
-      Iterator() : dataPtr(nullptr), currentPage(nullptr), nextPage(nullptr), startOfFullString(nullptr) {
+      Iterator() : dataPtr(nullptr), currentPage(nullptr), nextPage(nullptr), startOfFullString(nullptr), entry(0), tag(0) {
       }
 
-      Iterator(TPage* pagePtr) : dataPtr(pagePtr->getData()), currentPage(pagePtr), nextPage(pagePtr->nextPage), startOfFullString(nullptr) {
+      Iterator(TPage* pagePtr) : dataPtr(pagePtr->getData()), currentPage(pagePtr), nextPage(pagePtr->nextPage), startOfFullString(nullptr), entry(0), tag(0) {
       }
 
       IdType getId() {
@@ -214,13 +595,62 @@ namespace page {
         char* readPtr = this->dataPtr;
         this->dataPtr = nullptr;
 
-        page::Header header = page::readHeader(readPtr);
+        page::Header header = readHeader(readPtr);
 
         if (header != page::Header::StartOfUncompressedValue) {
           assert(header == page::Header::StartOfDelta);
         }
 
-        return page::read<IdType>(readPtr);
+        return readId(readPtr, entry);
+      }
+
+      /**
+       * Compares bytes [from, to) of the current value with the same bytes
+       * of a key, reading the page in place. Bytes behind the end of the
+       * value compare as 0.
+       *
+       * @return Position of the first mismatching byte, or to if all bytes match
+       */
+      unsigned valueMismatch(const uint8_t* key, unsigned from, unsigned to) {
+        assert(this->dataPtr != nullptr);
+        char* readPtr = this->dataPtr;
+
+        // The value is the prefix of the full string followed by the stored part
+        const char* prefix = startOfFullString;
+        PrefixSizeType prefixSize = 0;
+        uint64_t size;
+        const char* suffix;
+        page::Header header = readHeader(readPtr);
+        skipId(readPtr);
+        if (header == page::Header::StartOfDelta) {
+          assert(startOfFullString != nullptr);
+          prefixSize = readPrefixSize(readPtr);
+          size = readStringSize(readPtr);
+          suffix = page::readString(readPtr, size);
+        }
+        else {
+          assert(header == page::Header::StartOfUncompressedValue);
+          suffix = readValue(readPtr, size);
+        }
+        const uint64_t valueSize = prefixSize + size;
+
+        unsigned pos = from;
+        for (; pos < to && pos < prefixSize; pos++) {
+          if (static_cast<uint8_t>(prefix[pos]) != key[pos]) {
+            return pos;
+          }
+        }
+        for (; pos < to && pos < valueSize; pos++) {
+          if (static_cast<uint8_t>(suffix[pos-prefixSize]) != key[pos]) {
+            return pos;
+          }
+        }
+        for (; pos < to; pos++) {
+          if (key[pos] != 0) {
+            return pos;
+          }
+        }
+        return pos;
       }
 
       std::string getValue() {
@@ -228,28 +658,25 @@ namespace page {
         char* readPtr = this->dataPtr;
         this->dataPtr = nullptr;
 
-        page::Header header = page::readHeader(readPtr);
+        page::Header header = readHeader(readPtr);
         if (header == page::Header::StartOfUncompressedValue) {
-          page::advance<IdType>(readPtr);
-          StringSizeType size = page::read<StringSizeType>(readPtr);
-          const char* value = page::readString(readPtr, size);
+          skipId(readPtr);
+          uint64_t size;
+          const char* value = readValue(readPtr, size);
           return std::string(value, size);
         }
         else {
           assert(header == page::Header::StartOfDelta);
 
-          page::advance<IdType>(readPtr);
-          PrefixSizeType prefixSize = page::read<PrefixSizeType>(readPtr);
-          StringSizeType size = page::read<StringSizeType>(readPtr);
+          skipId(readPtr);
+          PrefixSizeType prefixSize = readPrefixSize(readPtr);
+          StringSizeType size = readStringSize(readPtr);
           const char* value = page::readString(readPtr, size);
 
           std::string output;
           output.reserve(prefixSize + size + 1);
           assert(startOfFullString != nullptr);
-          char* readPtr = startOfFullString;
-          const char* fullValue = page::readString(readPtr, prefixSize);
-
-          output.insert(0, fullValue, prefixSize);
+          output.insert(0, startOfFullString, prefixSize);
           output.insert(prefixSize, value, size);
           output[prefixSize+size] = '\0';
 
@@ -260,12 +687,12 @@ namespace page {
       const page::Leaf operator*() {
         assert(this->dataPtr != nullptr);
         char* readPtr = this->dataPtr;
-        page::Header header = page::readHeader(readPtr);
+        page::Header header = readHeader(readPtr);
         if (header == page::Header::StartOfUncompressedValue) {
-          IdType id = page::read<IdType>(readPtr);
-          StringSizeType size = page::read<StringSizeType>(readPtr);
-          startOfFullString = readPtr;
-          const char* value = page::readString(readPtr, size);
+          IdType id = readId(readPtr, entry);
+          uint64_t size;
+          const char* value = readValue(readPtr, size);
+          startOfFullString = value;
 
           return page::Leaf {
             id,
@@ -275,18 +702,15 @@ namespace page {
         else {
           assert(header == page::Header::StartOfDelta);
 
-          IdType id = page::read<IdType>(readPtr);
-          PrefixSizeType prefixSize = page::read<PrefixSizeType>(readPtr);
-          StringSizeType size = page::read<StringSizeType>(readPtr);
+          IdType id = readId(readPtr, entry);
+          PrefixSizeType prefixSize = readPrefixSize(readPtr);
+          StringSizeType size = readStringSize(readPtr);
           const char* value = page::readString(readPtr, size);
 
           std::string output;
           output.reserve(prefixSize + size +1);
           assert(startOfFullString != nullptr);
-          char* readPtr = startOfFullString;
-          const char* fullValue = page::readString(readPtr, prefixSize);
-
-          output.insert(0, fullValue, prefixSize);
+          output.insert(0, startOfFullString, prefixSize);
           output.insert(prefixSize, value, size);
           output[prefixSize+size] = '\0';
 
@@ -299,29 +723,32 @@ namespace page {
 
       Iterator& operator++() {
         assert(this->dataPtr != nullptr);
-        page::Header header = page::readHeader(this->dataPtr);
+        page::Header header = readHeader(this->dataPtr);
         if (header == page::Header::StartOfUncompressedValue) {
-          page::advance<IdType>(this->dataPtr);
-          StringSizeType size = page::read<StringSizeType>(this->dataPtr);
-          page::advance(this->dataPtr, size);
+          skipId(this->dataPtr);
+          uint64_t size;
+          readValue(this->dataPtr, size);
         }
         else if (header == page::Header::StartOfDelta) {
-          page::advance<IdType>(this->dataPtr);
-          page::advance<PrefixSizeType>(this->dataPtr);
-          StringSizeType size = page::read<StringSizeType>(this->dataPtr);
+          skipId(this->dataPtr);
+          readPrefixSize(this->dataPtr);
+          StringSizeType size = readStringSize(this->dataPtr);
           page::advance(this->dataPtr, size);
         }
 
         char* readPtr = this->dataPtr;
-        header = page::readHeader(readPtr);
+        header = readHeader(readPtr);
         if (header == page::Header::StartOfUncompressedValue || header == page::Header::StartOfDelta) {
+          entry++;
         }
         else if (header == page::Header::EndOfPage && this->nextPage != nullptr) {
+          this->currentPage = this->nextPage;
           this->dataPtr = this->nextPage->getData();
           this->nextPage = this->nextPage->nextPage;
+          entry = 0;
           char* readPtr = this->dataPtr;
-          if (page::readHeader(readPtr) == page::Header::StartOfIndex) {
-            page::skipIndex(this->dataPtr);
+          if (readHeader(readPtr) == page::Header::StartOfIndex) {
+            skipIndexSection(this->dataPtr);
           }
         }
         else {
@@ -336,7 +763,7 @@ namespace page {
         }
 
         char* readPtr = this->dataPtr;
-        page::Header header = page::readHeader(readPtr);
+        page::Header header = readHeader(readPtr);
         return (header == page::Header::StartOfUncompressedValue || header == page::Header::StartOfDelta)
           || (header == page::Header::EndOfPage && this->nextPage != nullptr);
       }
@@ -344,7 +771,7 @@ namespace page {
       Iterator& skipIndex() {
         assert(this->dataPtr != nullptr);
 
-        page::skipIndex(this->dataPtr);
+        skipIndexSection(this->dataPtr);
 
         return *this;
       }
@@ -352,19 +779,19 @@ namespace page {
       Iterator& prefixEndIndexSearch(const std::string& str) {
         assert(this->dataPtr != nullptr);
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfIndex);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfIndex);
         page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(this->dataPtr);
 
         OffsetType* indexPtr = reinterpret_cast<OffsetType*>(this->dataPtr);
         page::advance<OffsetType>(this->dataPtr, indexEntries);
         char* startOfUncompressedSection = this->dataPtr;
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
-        page::advance<IdType>(this->dataPtr);
-        StringSizeType fullStringSize = page::read<StringSizeType>(this->dataPtr);
-        startOfFullString = this->dataPtr;
-        const char* fullString = page::readString(this->dataPtr, fullStringSize);
-        PrefixSizeType prefixSize = prefixLength(fullString, fullStringSize, str);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
+        skipId(this->dataPtr);
+        uint64_t fullStringSize;
+        const char* fullString = readValue(this->dataPtr, fullStringSize);
+        startOfFullString = fullString;
+        uint64_t prefixSize = prefixLength(fullString, fullStringSize, str);
 
         char* uncompressedGoodPtr;
         if (prefixSize == str.size()) {
@@ -375,6 +802,7 @@ namespace page {
         }
 
         char* lastGoodPtr = nullptr;
+        page::IndexEntriesType lastGoodEntry = 0;
         if (indexEntries > 0) {
           // Perform binary search
           page::IndexEntriesType start = 0;
@@ -390,24 +818,25 @@ namespace page {
 
             char* deltaPtr = startOfUncompressedSection + indexPtr[middle];
 #ifdef DEBUG
-            assert(page::readHeader(deltaPtr) == page::Header::StartOfDelta);
+            assert(readHeader(deltaPtr) == page::Header::StartOfDelta);
 #else
-            page::advance<HeaderType>(deltaPtr);
+            readHeader(deltaPtr);
 #endif
-            page::advance<IdType>(deltaPtr);
+            skipId(deltaPtr);
 
-            PrefixSizeType deltaPrefixSize = page::read<PrefixSizeType>(deltaPtr);
+            PrefixSizeType deltaPrefixSize = readPrefixSize(deltaPtr);
             if (prefixSize < deltaPrefixSize) {
               // The delta has a bigger matching prefix and is thus
               // lexicographically smaller -> abort early
               start = middle + 1;
               if (uncompressedGoodPtr != nullptr) {
                 lastGoodPtr = startOfUncompressedSection + indexPtr[middle];
+                lastGoodEntry = middle + 1;
               }
             }
             else {
               // Compare delta string
-              StringSizeType deltaSize = page::read<StringSizeType>(deltaPtr);
+              StringSizeType deltaSize = readStringSize(deltaPtr);
               if (prefixSize == str.size() && prefixSize != deltaPrefixSize) {
                 break;
               }
@@ -416,6 +845,7 @@ namespace page {
               if (cmp == 0) {
                 // Found a matching entry; go find the last one!
                 lastGoodPtr = startOfUncompressedSection + indexPtr[middle];
+                lastGoodEntry = middle + 1;
                 start = middle + 1;
               }
               else if (cmp < 0) {
@@ -429,28 +859,30 @@ namespace page {
         }
 
         this->dataPtr = (lastGoodPtr == nullptr ? uncompressedGoodPtr : lastGoodPtr);
+        entry = lastGoodEntry;
         return *this;
       }
 
       Iterator& prefixStartIndexSearch(const std::string& str) {
         assert(this->dataPtr != nullptr);
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfIndex);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfIndex);
         page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(this->dataPtr);
 
         OffsetType* indexPtr = reinterpret_cast<OffsetType*>(this->dataPtr);
         page::advance<OffsetType>(this->dataPtr, indexEntries);
         char* startOfUncompressedSection = this->dataPtr;
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
-        page::advance<IdType>(this->dataPtr);
-        StringSizeType fullStringSize = page::read<StringSizeType>(this->dataPtr);
-        startOfFullString = this->dataPtr;
-        const char* fullString = page::readString(this->dataPtr, fullStringSize);
-        PrefixSizeType prefixSize = prefixLength(fullString, fullStringSize, str);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
+        skipId(this->dataPtr);
+        uint64_t fullStringSize;
+        const char* fullString = readValue(this->dataPtr, fullStringSize);
+        startOfFullString = fullString;
+        uint64_t prefixSize = prefixLength(fullString, fullStringSize, str);
 
         if (prefixSize == str.size()) {
           this->dataPtr = startOfUncompressedSection;
+          entry = 0;
           return *this;
         }
 
@@ -469,13 +901,13 @@ namespace page {
 
             char* deltaPtr = startOfUncompressedSection + indexPtr[middle];
 #ifdef DEBUG
-            assert(page::readHeader(deltaPtr) == page::Header::StartOfDelta);
+            assert(readHeader(deltaPtr) == page::Header::StartOfDelta);
 #else
-            page::advance<HeaderType>(deltaPtr);
+            readHeader(deltaPtr);
 #endif
-            page::advance<IdType>(deltaPtr);
+            skipId(deltaPtr);
 
-            PrefixSizeType deltaPrefixSize = page::read<PrefixSizeType>(deltaPtr);
+            PrefixSizeType deltaPrefixSize = readPrefixSize(deltaPtr);
             if (prefixSize < deltaPrefixSize) {
               // The delta has a bigger matching prefix and is thus
               // lexicographically smaller -> abort early
@@ -483,12 +915,13 @@ namespace page {
             }
             else {
               // Compare delta string
-              StringSizeType deltaSize = page::read<StringSizeType>(deltaPtr);
+              StringSizeType deltaSize = readStringSize(deltaPtr);
               const char* delta = page::readString(deltaPtr, deltaSize);
 
               int cmp = memcmp(delta, str.c_str()+deltaPrefixSize, min<uint64_t>(deltaSize, str.size()-prefixSize));
               if (cmp == 0) {
                 this->dataPtr = startOfUncompressedSection + indexPtr[middle];
+                entry = middle + 1;
                 return *this;
               }
               end = middle;
@@ -504,14 +937,15 @@ namespace page {
       Iterator& last() {
         assert(this->dataPtr != nullptr);
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfIndex);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfIndex);
 
         page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(this->dataPtr);
 
         if (indexEntries == 0) {
           // Return uncompressed value
           page::advance<OffsetType>(this->dataPtr, indexEntries);
-          assert(page::readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
+          assert(readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
+          entry = 0;
           return *this;
         }
 
@@ -521,28 +955,29 @@ namespace page {
 
         char* readPtr = this->dataPtr;
         assert(readHeader(readPtr) == page::Header::StartOfUncompressedValue);
-        advance<IdType>(readPtr);
-        advance<StringSizeType>(readPtr);
-        startOfFullString = readPtr;
+        skipId(readPtr);
+        uint64_t fullStringSize;
+        startOfFullString = readValue(readPtr, fullStringSize);
 
         this->dataPtr = startOfUncompressedSection + indexPtr[indexEntries-1];
+        entry = indexEntries;
         return *this;
       }
 
       Iterator& getIndexEntry(page::IndexEntriesType entry) {
         assert(this->dataPtr != nullptr);
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfIndex);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfIndex);
         page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(this->dataPtr);
         assert(entry <= indexEntries);
         OffsetType* indexPtr = reinterpret_cast<OffsetType*>(this->dataPtr);
 
         page::advance<OffsetType>(this->dataPtr, indexEntries);
         char* startOfUncompressedSection = this->dataPtr;
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
 
-        page::advance<IdType>(this->dataPtr);
-        page::advance<StringSizeType>(this->dataPtr);
-        startOfFullString = this->dataPtr;
+        skipId(this->dataPtr);
+        uint64_t fullStringSize;
+        startOfFullString = readValue(this->dataPtr, fullStringSize);
 
         // entry = 0 means the uncompressed string
         if (entry == 0) {
@@ -551,6 +986,7 @@ namespace page {
         else {
           this->dataPtr = startOfUncompressedSection + indexPtr[entry-1];
         }
+        this->entry = entry;
         return *this;
       }
 
@@ -560,6 +996,7 @@ namespace page {
 
         HeaderType header;
         const char* uncompressedStringPtr = nullptr;
+        page::IndexEntriesType entryNumber = 0;
 
         while (true) {
           header = readHeader(readPtr);
@@ -578,10 +1015,10 @@ namespace page {
 
           if (header == Header::StartOfUncompressedValue) {
             std::cout << "> Uncompressed section" << std::endl;
-            IdType id = read<IdType>(readPtr);
+            IdType id = readId(readPtr, entryNumber++);
             std::cout << "  " << id << std::endl;
-            StringSizeType size = read<StringSizeType>(readPtr);
-            uncompressedStringPtr = page::readString(readPtr, size);
+            uint64_t size;
+            uncompressedStringPtr = readValue(readPtr, size);
             std::cout << "  (" << size << ") " << std::string(uncompressedStringPtr, size) << std::endl;
             continue;
           }
@@ -589,10 +1026,10 @@ namespace page {
           if (header == Header::StartOfDelta) {
             std::cout << "> Compressed section" << std::endl;
             assert(uncompressedStringPtr != nullptr);
-            IdType id = read<IdType>(readPtr);
+            IdType id = readId(readPtr, entryNumber++);
             std::cout << "  " << id << std::endl;
-            PrefixSizeType prefixSize = read<PrefixSizeType>(readPtr);
-            StringSizeType stringSize = read<StringSizeType>(readPtr);
+            PrefixSizeType prefixSize = readPrefixSize(readPtr);
+            StringSizeType stringSize = readStringSize(readPtr);
             const char* value = page::readString(readPtr, stringSize);
             std::cout << "  (" << stringSize << ") " << std::string(uncompressedStringPtr, prefixSize) + std::string(value, stringSize) << std::endl;
             continue;
@@ -608,12 +1045,23 @@ namespace page {
         this->nextPage = this->nextPage->nextPage;
         this->dataPtr = this->currentPage->getData();
         startOfFullString = nullptr;
+        entry = 0;
+      }
+
+      Iterator& indexSearchNextPage(const std::string& str) {
+        if (this->nextPage == nullptr) {
+          // Greater than the last value
+          this->dataPtr = nullptr;
+          return *this;
+        }
+        gotoNextPage();
+        return indexSearch(str);
       }
 
       Iterator& indexSearch(const std::string& str) {
         assert(this->dataPtr != nullptr);
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfIndex);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfIndex);
 
         page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(this->dataPtr);
 
@@ -621,15 +1069,16 @@ namespace page {
         page::advance<OffsetType>(this->dataPtr, indexEntries);
         char* startOfUncompressedSection = this->dataPtr;
 
-        assert(page::readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
-        page::advance<IdType>(this->dataPtr);
-        StringSizeType fullStringSize = page::read<StringSizeType>(this->dataPtr);
-        startOfFullString = this->dataPtr;
-        const char* fullString = page::readString(this->dataPtr, fullStringSize);
-        PrefixSizeType prefixSize = prefixLength(fullString, fullStringSize, str);
+        assert(readHeader(this->dataPtr) == page::Header::StartOfUncompressedValue);
+        skipId(this->dataPtr);
+        uint64_t fullStringSize;
+        const char* fullString = readValue(this->dataPtr, fullStringSize);
+        startOfFullString = fullString;
+        uint64_t prefixSize = prefixLength(fullString, fullStringSize, str);
 
         if (prefixSize == str.size() && fullStringSize == prefixSize) {
           this->dataPtr = startOfUncompressedSection;
+          entry = 0;
           return *this;
         }
 
@@ -640,33 +1089,31 @@ namespace page {
 
           // First, check if this is even the correct page
           char* readPtr = startOfUncompressedSection+indexPtr[indexEntries-1];
-          assert(page::readHeader(readPtr) == page::Header::StartOfDelta);
-          page::advance<IdType>(readPtr);
-          PrefixSizeType endPrefixSize = page::read<PrefixSizeType>(readPtr);
+          assert(readHeader(readPtr) == page::Header::StartOfDelta);
+          skipId(readPtr);
+          PrefixSizeType endPrefixSize = readPrefixSize(readPtr);
           if (prefixSize < endPrefixSize) {
             // The delta has a bigger matching prefix and is thus
             // lexicographically smaller -> goto next page
-            gotoNextPage();
-            return indexSearch(str);
+            return indexSearchNextPage(str);
           }
           else {
             // Compare delta string
-            StringSizeType endSize = page::read<StringSizeType>(readPtr);
+            StringSizeType endSize = readStringSize(readPtr);
             const char* delta = page::readString(readPtr, endSize);
             int cmp = memcmp(delta, &str.c_str()[endPrefixSize], min<uint64_t>(str.size()-endPrefixSize, endSize));
             if (cmp == 0) {
               if (str.size() == endSize+endPrefixSize) {
                 this->dataPtr = startOfUncompressedSection + indexPtr[indexEntries-1];
+                entry = indexEntries;
                 return *this;
               }
               if (str.size() > endSize+endPrefixSize) {
-                gotoNextPage();
-                return indexSearch(str);
+                return indexSearchNextPage(str);
               }
             }
             else if (cmp < 0) {
-              gotoNextPage();
-              return indexSearch(str);
+              return indexSearchNextPage(str);
             }
           }
           end--;
@@ -682,13 +1129,13 @@ namespace page {
             char* deltaPtr = startOfUncompressedSection + indexPtr[middle];
 
 #ifdef DEBUG
-            assert(page::readHeader(deltaPtr) == page::Header::StartOfDelta);
+            assert(readHeader(deltaPtr) == page::Header::StartOfDelta);
 #else
-            page::advance<HeaderType>(deltaPtr);
+            readHeader(deltaPtr);
 #endif
-            page::advance<IdType>(deltaPtr);
+            skipId(deltaPtr);
 
-            PrefixSizeType deltaPrefixSize = page::read<PrefixSizeType>(deltaPtr);
+            PrefixSizeType deltaPrefixSize = readPrefixSize(deltaPtr);
             if (prefixSize < deltaPrefixSize) {
               // The delta has a bigger matching prefix and is thus
               // lexicographically smaller -> abort early
@@ -696,12 +1143,13 @@ namespace page {
             }
             else {
               // Compare delta string
-              StringSizeType deltaSize = page::read<StringSizeType>(deltaPtr);
+              StringSizeType deltaSize = readStringSize(deltaPtr);
               const char* delta = page::readString(deltaPtr, deltaSize);
               int cmp = memcmp(delta, &str.c_str()[deltaPrefixSize], min<uint64_t>(str.size()-deltaPrefixSize, deltaSize));
               if (cmp == 0) {
                 if (str.size() == deltaSize+deltaPrefixSize) {
                   this->dataPtr = startOfUncompressedSection + indexPtr[middle];
+                  entry = middle + 1;
                   return *this;
                 }
                 else if (str.size() > deltaSize+deltaPrefixSize) {
@@ -731,39 +1179,41 @@ namespace page {
         do {
           char* readPtr = this->dataPtr;
 #ifdef DEBUG
-          auto hdr = page::readHeader(readPtr);
+          auto hdr = readHeader(readPtr);
           assert(hdr  == page::Header::StartOfUncompressedValue);
 #else
-          page::advance<page::HeaderType>(readPtr);
+          readHeader(readPtr);
 #endif
-          IdType foundId = page::read<IdType>(readPtr);
+          IdType foundId = readId(readPtr, entry);
           if (id == foundId) {
             return *this;
           }
 
-          page::Header header = page::readHeader(this->dataPtr);
+          page::Header header = readHeader(this->dataPtr);
           // Not found; skip according to header
           if (header == page::Header::StartOfUncompressedValue) {
-            page::advance<IdType>(this->dataPtr);
-            StringSizeType size = page::read<StringSizeType>(this->dataPtr);
-            startOfFullString = this->dataPtr;
-            page::advance(this->dataPtr, size);
+            skipId(this->dataPtr);
+            uint64_t size;
+            startOfFullString = readValue(this->dataPtr, size);
           }
           else if (header == page::Header::StartOfDelta) {
-            page::advance<IdType>(this->dataPtr);
-            page::advance<PrefixSizeType>(this->dataPtr);
-            StringSizeType size = page::read<StringSizeType>(this->dataPtr);
+            skipId(this->dataPtr);
+            readPrefixSize(this->dataPtr);
+            StringSizeType size = readStringSize(this->dataPtr);
             page::advance(this->dataPtr, size);
           }
 
           readPtr = this->dataPtr;
-          header = page::readHeader(readPtr);
+          header = readHeader(readPtr);
           if (header == page::Header::StartOfUncompressedValue || header == page::Header::StartOfDelta) {
+            entry++;
           }
           else if (header == page::Header::EndOfPage && this->nextPage != nullptr) {
+            this->currentPage = this->nextPage;
             this->dataPtr = this->nextPage->getData();
             this->nextPage = this->nextPage->nextPage;
             this->startOfFullString = nullptr;
+            entry = 0;
           }
           else {
             this->dataPtr = nullptr;
@@ -779,13 +1229,13 @@ namespace page {
         uint64_t pos = 0;
         do {
           char* readPtr = this->dataPtr;
-          page::Header header = page::readHeader(readPtr);
-          page::advance<IdType>(readPtr);
+          page::Header header = readHeader(readPtr);
+          skipId(readPtr);
 
           if (header == page::Header::StartOfUncompressedValue) {
             // String is stored uncompressed
-            StringSizeType size = page::read<StringSizeType>(readPtr);
-            const char* value = page::readString(readPtr, size);
+            uint64_t size;
+            const char* value = readValue(readPtr, size);
 
             pos = 0;
             while(pos < size && pos < searchValue.size() && searchValue[pos] == value[pos]) {
@@ -799,8 +1249,8 @@ namespace page {
             this->fullString = std::string(value, value+size);
           }
           else if (header == page::Header::StartOfDelta) {
-            PrefixSizeType prefixSize = page::read<PrefixSizeType>(readPtr);
-            StringSizeType size = page::read<StringSizeType>(readPtr);
+            PrefixSizeType prefixSize = readPrefixSize(readPtr);
+            StringSizeType size = readStringSize(readPtr);
             if (prefixSize == pos && searchValue.size() <= prefixSize + size) {
               // Possible match; compare characters
               const char* value = page::readString(readPtr, size);
@@ -817,28 +1267,31 @@ namespace page {
             }
           }
 
-          header = page::readHeader(this->dataPtr);
+          header = readHeader(this->dataPtr);
           // Not found; skip according to header
           if (header == page::Header::StartOfUncompressedValue) {
-            page::advance<IdType>(this->dataPtr);
-            StringSizeType size = page::read<StringSizeType>(this->dataPtr);
-            page::advance(this->dataPtr, size);
+            skipId(this->dataPtr);
+            uint64_t size;
+            readValue(this->dataPtr, size);
           }
           else if (header == page::Header::StartOfDelta) {
-            page::advance<IdType>(this->dataPtr);
-            page::advance<PrefixSizeType>(this->dataPtr);
-            StringSizeType size = page::read<StringSizeType>(this->dataPtr);
+            skipId(this->dataPtr);
+            readPrefixSize(this->dataPtr);
+            StringSizeType size = readStringSize(this->dataPtr);
             page::advance(this->dataPtr, size);
           }
 
           readPtr = this->dataPtr;
-          header = page::readHeader(readPtr);
+          header = readHeader(readPtr);
           if (header == page::Header::StartOfUncompressedValue || header == page::Header::StartOfDelta) {
+            entry++;
           }
           else if (header == page::Header::EndOfPage && this->nextPage != nullptr) {
+            this->currentPage = this->nextPage;
             this->dataPtr = this->nextPage->getData();
             this->nextPage = this->nextPage->nextPage;
             this->startOfFullString = nullptr;
+            entry = 0;
           }
           else {
             this->dataPtr = nullptr;
@@ -958,18 +1411,17 @@ header = page::readHeader(this->dataPtr);
 
       uint16_t pos = 0;
       while (pos < delta) {
-        page::Header header = page::readHeader(this->dataPtr);
+        page::Header header = readHeader(this->dataPtr);
         // Skip according to header
         if (header == page::Header::StartOfUncompressedValue) {
-          page::advance<IdType>(this->dataPtr);
-          StringSizeType size = page::read<StringSizeType>(this->dataPtr);
-          this->startOfFullString = this->dataPtr;
-          page::advance(this->dataPtr, size);
+          skipId(this->dataPtr);
+          uint64_t size;
+          this->startOfFullString = readValue(this->dataPtr, size);
         }
         else if (header == page::Header::StartOfDelta) {
-          page::advance<IdType>(this->dataPtr);
-          page::advance<PrefixSizeType>(this->dataPtr);
-          StringSizeType size = page::read<StringSizeType>(this->dataPtr);
+          skipId(this->dataPtr);
+          readPrefixSize(this->dataPtr);
+          StringSizeType size = readStringSize(this->dataPtr);
           page::advance(this->dataPtr, size);
         }
         else {
@@ -985,7 +1437,7 @@ header = page::readHeader(this->dataPtr);
     Iterator& gotoIndexOffset(uint16_t offset) {
       assert(this->dataPtr != nullptr);
 
-      assert(page::readHeader(dataPtr) == page::Header::StartOfIndex);
+      assert(readHeader(dataPtr) == page::Header::StartOfIndex);
       page::IndexEntriesType indexEntries = page::read<page::IndexEntriesType>(dataPtr);
       page::advance<OffsetType>(dataPtr, indexEntries);
 
@@ -994,17 +1446,17 @@ header = page::readHeader(this->dataPtr);
       }
 
       char* offsetPtr = this->dataPtr+offset;
-      page::Header header = page::readHeader(this->dataPtr);
+      page::Header header = readHeader(this->dataPtr);
       assert(header == page::Header::StartOfUncompressedValue);
 
       // Read full string
-      page::advance<IdType>(this->dataPtr);
-      page::advance<StringSizeType>(this->dataPtr);
-      startOfFullString = this->dataPtr;
+      skipId(this->dataPtr);
+      uint64_t fullStringSize;
+      startOfFullString = readValue(this->dataPtr, fullStringSize);
 
       // Set pointer to delta
       this->dataPtr = offsetPtr;
-      header = page::readHeader(offsetPtr);
+      header = readHeader(offsetPtr);
       assert(header == page::Header::StartOfDelta);
 
       return *this;
@@ -1017,17 +1469,17 @@ header = page::readHeader(this->dataPtr);
       }
 
       char* offsetPtr = this->dataPtr+offset;
-      page::Header header = page::readHeader(this->dataPtr);
+      page::Header header = readHeader(this->dataPtr);
       assert(header == page::Header::StartOfUncompressedValue);
 
       // Read full string
-      page::advance<IdType>(this->dataPtr);
-      page::advance<StringSizeType>(this->dataPtr);
-      startOfFullString = this->dataPtr;
+      skipId(this->dataPtr);
+      uint64_t fullStringSize;
+      startOfFullString = readValue(this->dataPtr, fullStringSize);
 
       // Set pointer to delta
       this->dataPtr = offsetPtr;
-      header = page::readHeader(offsetPtr);
+      header = readHeader(offsetPtr);
       assert(header == page::Header::StartOfDelta);
 
       return *this;
@@ -1037,32 +1489,34 @@ header = page::readHeader(this->dataPtr);
       assert(this->dataPtr != nullptr);
       uint16_t pos = 0;
       while (pos < delta) {
-        page::Header header = page::readHeader(this->dataPtr);
+        page::Header header = readHeader(this->dataPtr);
         // Not found; skip according to header
         if (header == page::Header::StartOfUncompressedValue) {
-          page::advance<IdType>(this->dataPtr);
-          StringSizeType size = page::read<StringSizeType>(this->dataPtr);
-          startOfFullString = this->dataPtr;
-          page::advance(this->dataPtr, size);
+          skipId(this->dataPtr);
+          uint64_t size;
+          startOfFullString = readValue(this->dataPtr, size);
         }
         else if (header == page::Header::StartOfDelta) {
-          page::advance<IdType>(this->dataPtr);
-          page::advance<PrefixSizeType>(this->dataPtr);
-          StringSizeType size = page::read<StringSizeType>(this->dataPtr);
+          skipId(this->dataPtr);
+          readPrefixSize(this->dataPtr);
+          StringSizeType size = readStringSize(this->dataPtr);
           page::advance(this->dataPtr, size);
         }
 
         pos++;
       }
+      entry = delta;
 
       char* readPtr = this->dataPtr;
-      page::Header header = page::readHeader(readPtr);
+      page::Header header = readHeader(readPtr);
       if (header == page::Header::StartOfUncompressedValue || header == page::Header::StartOfDelta) {
       }
       else if (header == page::Header::EndOfPage && this->nextPage != nullptr) {
+        this->currentPage = this->nextPage;
         this->dataPtr = this->nextPage->getData();
         this->nextPage = this->nextPage->nextPage;
         this->startOfFullString = nullptr;
+        entry = 0;
       }
       else {
         this->dataPtr = nullptr;
@@ -1075,7 +1529,7 @@ header = page::readHeader(this->dataPtr);
   template<uint64_t TSize, class TPage>
     class Page {
       public:
-        const uint64_t size = TSize;
+        static const uint64_t size = TSize;
         TPage* nextPage;
         char data[TSize];
 
@@ -1085,7 +1539,30 @@ header = page::readHeader(this->dataPtr);
 
         Page() : nextPage(nullptr) {
         }
+
+        /**
+         * Pages are allocated from an arena owned by their dictionary, and
+         * freed with it; there is no other way to allocate them.
+         */
+        typedef PageArena<TPage> Arena;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+        static void* operator new(size_t allocationSize, PageArena<TPage>& arena) {
+#ifdef DEBUG
+          assert(allocationSize == sizeof(TPage));
+#endif
+          return arena.allocate();
+        }
+
+        static void operator delete(void* page, PageArena<TPage>& arena) {
+          // Memory is owned by the arena
+        }
+#pragma GCC diagnostic pop
     };
+
+    template<uint64_t TSize, class TPage>
+    const uint64_t Page<TSize, TPage>::size;
 }
 
 template<uint64_t TSize, class TPage>
@@ -0,0 +1,119 @@
+#ifndef H_PageArena
+#define H_PageArena
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <new>
+#include <vector>
+#include <sys/mman.h>
+#include "BlobStore.hpp"
+#include "Exception.hpp"
+
+/**
+ * Allocates fixed-size pages contiguously and numbers them.
+ *
+ * Pages are carved out of large chunks, which can be backed by huge pages.
+ * Page numbers start at 1, so a leaf value of 0 never refers to a page.
+ * Page numbers are much smaller than pointers and thus allow leaf values
+ * of 32 bits.
+ *
+ * Values too long for the pages are stored in the blob store of the arena,
+ * so they are freed with the pages.
+ */
+template<class TPage>
+class PageArena {
+  private:
+    static const size_t minChunkSize = 2 << 20;
+    static const uint64_t pagesPerChunk = minChunkSize / sizeof(TPage) > 0 ? minChunkSize / sizeof(TPage) : 1;
+    static const size_t chunkSize = pagesPerChunk * sizeof(TPage);
+
+    bool hugePages;
+    std::vector<char*> chunks;
+    // Chunk start address to the number of its first page, for numberOf()
+    std::map<uintptr_t, uint64_t> chunkNumbers;
+    uint64_t nextNumber;
+
+    void newChunk() {
+      void* chunk = mmap(nullptr, chunkSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (chunk == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+#ifdef MADV_HUGEPAGE
+      if (hugePages) {
+        madvise(chunk, chunkSize, MADV_HUGEPAGE);
+      }
+#endif
+      chunks.push_back(static_cast<char*>(chunk));
+      chunkNumbers[reinterpret_cast<uintptr_t>(chunk)] = nextNumber;
+    }
+
+  public:
+    BlobStore blobs;
+
+    PageArena() : hugePages(false), nextNumber(1) {
+    }
+
+    ~PageArena() {
+      for (char* chunk : chunks) {
+        munmap(chunk, chunkSize);
+      }
+    }
+
+    PageArena(const PageArena&) = delete;
+    PageArena& operator=(const PageArena&) = delete;
+
+    /**
+     * Advises the system to back chunks allocated from now on by huge pages.
+     */
+    void useHugePages(bool enable) {
+      hugePages = enable;
+    }
+
+    /**
+     * Allocates uninitialized memory for the next page.
+     */
+    void* allocate() {
+      if ((nextNumber - 1) % pagesPerChunk == 0) {
+        newChunk();
+      }
+      void* page = get(nextNumber);
+      nextNumber++;
+      return page;
+    }
+
+    /**
+     * Gets a page by its number.
+     */
+    inline TPage* get(uint64_t number) const {
+      const uint64_t index = number - 1;
+      return reinterpret_cast<TPage*>(chunks[index / pagesPerChunk] + (index % pagesPerChunk) * sizeof(TPage));
+    }
+
+    /**
+     * Gets the number of a page allocated by this arena.
+     */
+    uint64_t numberOf(const TPage* page) const {
+      const uintptr_t address = reinterpret_cast<uintptr_t>(page);
+      auto it = chunkNumbers.upper_bound(address);
+      if (it == chunkNumbers.begin()) {
+        throw Exception("Page not allocated by arena");
+      }
+      --it;
+#ifdef DEBUG
+      if (address >= it->first + chunkSize) {
+        throw Exception("Page not allocated by arena");
+      }
+#endif
+      return it->second + (address - it->first) / sizeof(TPage);
+    }
+
+    /**
+     * Returns the number of pages allocated so far.
+     */
+    uint64_t size() const {
+      return nextNumber - 1;
+    }
+};
+
+#endif
@@ -5,6 +5,9 @@
 #include "DynamicPage.hpp"
 #include "DynamicSlottedPage.hpp"
 #include "SlottedPage.hpp"
+#include "ImplicitIdPage.hpp"
+#include "PaxPage.hpp"
+#include "RestartPage.hpp"
 #include "BottomUpPage.hpp"
 
 #endif
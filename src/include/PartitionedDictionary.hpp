@@ -0,0 +1,242 @@
+#ifndef H_PartitionedDictionary
+#define H_PartitionedDictionary
+
+#include "Dictionary.hpp"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace partition {
+  /**
+   * Roles of a term in the triples; a term's roles are combined as flags.
+   */
+  enum Role : uint8_t {
+    Subject = 1,
+    Predicate = 2,
+    Object = 4,
+    Literal = 8
+  };
+
+  enum Section : uint8_t {
+    Shared,
+    Subjects,
+    Objects,
+    Predicates,
+    Literals
+  };
+
+  const uint8_t numberOfSections = 5;
+
+  /**
+   * Returns the section of a term with the given roles. Predicates get
+   * their own section even if they are used as subjects or objects, too.
+   */
+  inline Section sectionOf(uint8_t roles) {
+    if (roles & Predicate) {
+      return Predicates;
+    }
+    if (roles & Literal) {
+      return Literals;
+    }
+    if ((roles & Subject) && (roles & Object)) {
+      return Shared;
+    }
+    return (roles & Subject) ? Subjects : Objects;
+  }
+}
+
+/**
+ * Dictionary split into sections by the roles of its terms, like the HDT
+ * dictionary: terms used as both subject and object, subject-only terms,
+ * object-only terms, predicates and literals.
+ *
+ * Each section is a dictionary of its own, so its page type and indexes can
+ * fit its terms, e.g. small pages for the few, hot predicates and large,
+ * front coded pages for long literals. The section of a term is stored in
+ * the top bits of its ID below the highest one, so ID lookups go straight to
+ * the section; value lookups that know the role of a term only search the
+ * sections it can be in. Predicates used as subjects or objects are only
+ * stored in the predicate section, which subject and object lookups search
+ * last.
+ *
+ * Bulk loads without roles store all values in the shared section.
+ */
+template<class TShared, class TSubjects, class TObjects, class TPredicates, class TLiterals>
+class PartitionedDictionary final : public Dictionary {
+  private:
+    static const unsigned sectionShift = 60;
+    static const uint64_t localIdMask = (1ull << sectionShift) - 1;
+
+    TShared shared;
+    TSubjects subjects;
+    TObjects objects;
+    TPredicates predicates;
+    TLiterals literals;
+    std::array<Dictionary*, partition::numberOfSections> sections;
+
+    static inline uint64_t globalId(partition::Section section, uint64_t localId) {
+      return (static_cast<uint64_t>(section) << sectionShift) | localId;
+    }
+
+    // Lookups use the concrete section types, so they are resolved statically
+    bool lookupIn(partition::Section section, const std::string& value, uint64_t& id) const {
+      uint64_t localId;
+      bool found = false;
+      switch (section) {
+        case partition::Shared:
+          found = shared.lookup(value, localId);
+          break;
+        case partition::Subjects:
+          found = subjects.lookup(value, localId);
+          break;
+        case partition::Objects:
+          found = objects.lookup(value, localId);
+          break;
+        case partition::Predicates:
+          found = predicates.lookup(value, localId);
+          break;
+        case partition::Literals:
+          found = literals.lookup(value, localId);
+          break;
+      }
+      if (found) {
+        id = globalId(section, localId);
+      }
+      return found;
+    }
+
+  public:
+    PartitionedDictionary() : sections {{ &shared, &subjects, &objects, &predicates, &literals }} {
+    }
+
+    ~PartitionedDictionary() noexcept {
+    }
+
+    PartitionedDictionary(const PartitionedDictionary&) = delete;
+    PartitionedDictionary& operator=(const PartitionedDictionary&) = delete;
+
+    /**
+     * Returns the section of an ID.
+     */
+    static inline partition::Section sectionOfId(uint64_t id) {
+      return static_cast<partition::Section>(id >> sectionShift);
+    }
+
+    void bulkInsert(size_t size, std::string* values) {
+      shared.bulkInsert(size, values);
+      nextId += size;
+    }
+
+    /**
+     * Inserts multiple string values into the sections for their roles.
+     *
+     * @param size Number of string values to insert
+     * @param values Pointer to an array of sorted string values to insert
+     * @param roles Pointer to an array of the partition::Role flags of each value
+     */
+    void bulkInsert(size_t size, std::string* values, const uint8_t* roles) {
+      std::array<std::vector<std::string>, partition::numberOfSections> sectionValues;
+      for (size_t i = 0; i < size; i++) {
+        sectionValues[partition::sectionOf(roles[i])].push_back(values[i]);
+      }
+
+      for (uint8_t section = 0; section < partition::numberOfSections; section++) {
+        if (!sectionValues[section].empty()) {
+          sections[section]->bulkInsert(sectionValues[section].size(), sectionValues[section].data());
+        }
+      }
+      nextId += size;
+    }
+
+    uint64_t insert(std::string value) {
+      uint64_t id = globalId(partition::Shared, shared.insert(value));
+      nextId++;
+      return id;
+    }
+
+    bool lookup(std::string value, uint64_t& id) const {
+      // The predicates are the smallest section
+      return lookupIn(partition::Predicates, value, id)
+        || lookupIn(partition::Shared, value, id)
+        || lookupIn(partition::Subjects, value, id)
+        || lookupIn(partition::Objects, value, id)
+        || lookupIn(partition::Literals, value, id);
+    }
+
+    /**
+     * Looks up a string by its value, only searching the sections of a role.
+     *
+     * @param [in] value Value to look up
+     * @param [in] role partition::Role the value is used in
+     * @param [out] id ID of the given value
+     * @return True if the given value was found, false otherwise
+     */
+    bool lookup(const std::string& value, partition::Role role, uint64_t& id) const {
+      switch (role) {
+        // Predicates may be subjects or objects, too, e.g. when they are
+        // described by triples; their section is the smallest
+        case partition::Subject:
+          return lookupIn(partition::Shared, value, id) || lookupIn(partition::Subjects, value, id) || lookupIn(partition::Predicates, value, id);
+        case partition::Predicate:
+          return lookupIn(partition::Predicates, value, id);
+        case partition::Object:
+          return lookupIn(partition::Shared, value, id) || lookupIn(partition::Objects, value, id) || lookupIn(partition::Predicates, value, id);
+        case partition::Literal:
+          return lookupIn(partition::Literals, value, id);
+      }
+      return false;
+    }
+
+    bool lookup(uint64_t id, std::string& value) const {
+      uint64_t localId = id & localIdMask;
+      switch (id >> sectionShift) {
+        case partition::Shared:
+          return shared.lookup(localId, value);
+        case partition::Subjects:
+          return subjects.lookup(localId, value);
+        case partition::Objects:
+          return objects.lookup(localId, value);
+        case partition::Predicates:
+          return predicates.lookup(localId, value);
+        case partition::Literals:
+          return literals.lookup(localId, value);
+      }
+      return false;
+    }
+
+    void rangeLookup(std::string prefix, RangeLookupCallbackType callback) const {
+      for (uint8_t section = 0; section < partition::numberOfSections; section++) {
+        sections[section]->rangeLookup(prefix, [&](uint64_t localId, std::string value) {
+          callback(globalId(static_cast<partition::Section>(section), localId), value);
+        });
+      }
+    }
+
+    std::string description() const {
+      return "Partitioned/" + shared.description() + "/" + subjects.description() + "/" + objects.description() + "/" + predicates.description() + "/" + literals.description();
+    }
+
+    std::string numberOfLeaves() const {
+      return shared.numberOfLeaves() + "/" + subjects.numberOfLeaves() + "/" + objects.numberOfLeaves() + "/" + predicates.numberOfLeaves() + "/" + literals.numberOfLeaves();
+    }
+
+    bool numbersByRank() const {
+      // Bulk loads without roles only fill the shared section, whose IDs
+      // have no section bits
+      return shared.numbersByRank();
+    }
+
+    void debug() const {
+      for (const Dictionary* section : sections) {
+        section->debug();
+      }
+    }
+};
+
+template<class TShared, class TSubjects, class TObjects, class TPredicates, class TLiterals>
+const unsigned PartitionedDictionary<TShared, TSubjects, TObjects, TPredicates, TLiterals>::sectionShift;
+
+template<class TShared, class TSubjects, class TObjects, class TPredicates, class TLiterals>
+const uint64_t PartitionedDictionary<TShared, TSubjects, TObjects, TPredicates, TLiterals>::localIdMask;
+
+#endif
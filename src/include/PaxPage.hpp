@@ -0,0 +1,499 @@
+#ifndef H_PaxPage
+#define H_PaxPage
+
+#include "Page.hpp"
+#include "Exception.hpp"
+#include <cstring>
+#include <emmintrin.h> // x86 SSE intrinsics
+
+template<uint64_t TSize>
+class PaxPage;
+
+namespace page {
+  /**
+   * Iterator over the values of PaxPages, which store their values column-wise.
+   */
+  template<uint64_t TSize>
+    class Iterator<PaxPage<TSize>> {
+      friend PaxPage<TSize>;
+
+      protected:
+      PaxPage<TSize>* currentPage;
+      page::IndexEntriesType entry;
+
+      Iterator(PaxPage<TSize>* pagePtr, page::IndexEntriesType entry) : currentPage(pagePtr), entry(entry) {
+      }
+
+      public:
+      Iterator() : currentPage(nullptr), entry(0) {
+      }
+
+      Iterator(PaxPage<TSize>* pagePtr) : currentPage(pagePtr), entry(0) {
+      }
+
+      IdType getId() {
+        assert(currentPage != nullptr);
+        return currentPage->idAt(entry);
+      }
+
+      std::string getValue() {
+        assert(currentPage != nullptr);
+        PrefixSizeType prefixSize = currentPage->prefixSizeAt(entry);
+        std::string value(currentPage->bytesAt(0), prefixSize);
+        value.append(currentPage->bytesAt(entry), currentPage->stringSizeAt(entry));
+        return value;
+      }
+
+      const page::Leaf operator*() {
+        assert(currentPage != nullptr);
+        IdType id = getId();
+        return std::make_pair(id, getValue());
+      }
+
+      /**
+       * Compares bytes [from, to) of the current value with the same bytes
+       * of a key, reading the page in place. Bytes behind the end of the
+       * value compare as 0.
+       *
+       * @return Position of the first mismatching byte, or to if all bytes match
+       */
+      unsigned valueMismatch(const uint8_t* key, unsigned from, unsigned to) {
+        assert(currentPage != nullptr);
+        const char* prefix = currentPage->bytesAt(0);
+        const char* suffix = currentPage->bytesAt(entry);
+        unsigned prefixSize = currentPage->prefixSizeAt(entry);
+        uint64_t valueSize = prefixSize + currentPage->stringSizeAt(entry);
+
+        unsigned pos = from;
+        for (; pos < to && pos < prefixSize; pos++) {
+          if (static_cast<uint8_t>(prefix[pos]) != key[pos]) {
+            return pos;
+          }
+        }
+        for (; pos < to && pos < valueSize; pos++) {
+          if (static_cast<uint8_t>(suffix[pos-prefixSize]) != key[pos]) {
+            return pos;
+          }
+        }
+        for (; pos < to; pos++) {
+          if (key[pos] != 0) {
+            return pos;
+          }
+        }
+        return pos;
+      }
+
+      Iterator& operator++() {
+        assert(currentPage != nullptr);
+        entry++;
+        if (entry == currentPage->numberOfEntries()) {
+          currentPage = currentPage->nextPage;
+          entry = 0;
+        }
+        return *this;
+      }
+
+      operator bool() {
+        return currentPage != nullptr;
+      }
+
+      void debug() const {
+        assert(currentPage != nullptr);
+        std::cout << "> PAX page, " << currentPage->numberOfEntries() << " entries" << std::endl;
+        for (page::IndexEntriesType i = 0; i < currentPage->numberOfEntries(); i++) {
+          std::cout << "  " << currentPage->idAt(i) << " (" << currentPage->prefixSizeAt(i) << "+" << currentPage->stringSizeAt(i) << ") "
+            << std::string(currentPage->bytesAt(0), currentPage->prefixSizeAt(i)) + std::string(currentPage->bytesAt(i), currentPage->stringSizeAt(i)) << std::endl;
+        }
+      }
+    };
+}
+
+/**
+ * Fixed-size page that stores its values column-wise (PAX layout).
+ *
+ * The page starts with the number of values, followed by one column each
+ * for the IDs, the prefix lengths, the sizes and the heap offsets of the
+ * values, and the heap with the value bytes. The first value is stored
+ * completely, all others as delta to it. A first value longer than half of
+ * the page is stored in the blob store of the arena; its size is then
+ * page::overflowMarker, and the heap holds a reference to the blob.
+ *
+ * The prefix lengths (shared with the first value) of sorted values are
+ * non-increasing. Searches scan the prefix length column with SSE2 to find
+ * the values that share exactly as many bytes with the first value as the
+ * key does; all others are smaller or bigger without comparing any string
+ * bytes. Only the remaining candidates are binary searched in the heap.
+ *
+ * Can be used with the BottomUpStrategy; the offsets passed to the loader
+ * callback are byte offsets into the columns, i.e. twice the entry number.
+ */
+template<uint64_t TSize>
+class PaxPage : public Page<TSize, PaxPage<TSize>> {
+  friend class page::Iterator<PaxPage<TSize>>;
+
+  private:
+    // Number of values, padded for the alignment of the ID column
+    static const uint64_t headerSize = sizeof(page::IdType);
+    static const uint64_t entrySize = sizeof(page::IdType) + sizeof(page::PrefixSizeType) + sizeof(page::StringSizeType) + sizeof(page::OffsetType);
+
+    static_assert(TSize - headerSize <= static_cast<uint64_t>(std::numeric_limits<page::OffsetType>::max()) + 1, "Heap offsets have to fit into page::OffsetType");
+
+    inline page::IdType* ids() {
+      return reinterpret_cast<page::IdType*>(this->data + headerSize);
+    }
+
+    inline page::PrefixSizeType* prefixSizes() {
+      return reinterpret_cast<page::PrefixSizeType*>(ids() + numberOfEntries());
+    }
+
+    inline page::StringSizeType* stringSizes() {
+      return reinterpret_cast<page::StringSizeType*>(prefixSizes() + numberOfEntries());
+    }
+
+    inline page::OffsetType* heapOffsets() {
+      return reinterpret_cast<page::OffsetType*>(stringSizes() + numberOfEntries());
+    }
+
+    inline char* heap() {
+      return reinterpret_cast<char*>(heapOffsets() + numberOfEntries());
+    }
+
+    inline page::IdType idAt(page::IndexEntriesType entry) {
+      return ids()[entry];
+    }
+
+    inline page::PrefixSizeType prefixSizeAt(page::IndexEntriesType entry) {
+      return prefixSizes()[entry];
+    }
+
+    inline const char* blobAt(page::IndexEntriesType entry) {
+      return *reinterpret_cast<const char**>(heap() + heapOffsets()[entry]);
+    }
+
+    inline uint64_t stringSizeAt(page::IndexEntriesType entry) {
+      page::StringSizeType size = stringSizes()[entry];
+      return size == page::overflowMarker ? BlobStore::size(blobAt(entry)) : size;
+    }
+
+    inline const char* bytesAt(page::IndexEntriesType entry) {
+      if (stringSizes()[entry] == page::overflowMarker) {
+        return BlobStore::bytes(blobAt(entry));
+      }
+      return heap() + heapOffsets()[entry];
+    }
+
+    /**
+     * Counts the values (except the first) sharing more than, and at least
+     * prefixSize bytes with the first value. Since the column is
+     * non-increasing, these are the positions where the values sharing
+     * exactly prefixSize bytes start and end.
+     */
+    void scanPrefixSizes(page::PrefixSizeType prefixSize, page::IndexEntriesType& start, page::IndexEntriesType& end) {
+      const page::PrefixSizeType* column = prefixSizes();
+      page::IndexEntriesType entries = numberOfEntries();
+      // Flip the sign bits for unsigned comparisons
+      const __m128i signBits = _mm_set1_epi16(static_cast<short>(0x8000));
+      const __m128i key = _mm_set1_epi16(static_cast<short>(prefixSize ^ 0x8000));
+
+      unsigned greater = 0;
+      unsigned greaterOrEqual = 0;
+      unsigned i = 1;
+      for (; i + 8 <= entries; i += 8) {
+        __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i)), signBits);
+        unsigned greaterMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(block, key)));
+        unsigned equalMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(block, key)));
+        // Two mask bits per value
+        greater += static_cast<unsigned>(__builtin_popcount(greaterMask)) / 2;
+        greaterOrEqual += static_cast<unsigned>(__builtin_popcount(greaterMask | equalMask)) / 2;
+        if ((greaterMask | equalMask) != 0xFFFF) {
+          // All following values share fewer bytes
+          i = entries;
+          break;
+        }
+      }
+      for (; i < entries && column[i] >= prefixSize; i++) {
+        greater += column[i] > prefixSize;
+        greaterOrEqual++;
+      }
+
+      start = static_cast<page::IndexEntriesType>(1 + greater);
+      end = static_cast<page::IndexEntriesType>(1 + greaterOrEqual);
+    }
+
+    /**
+     * Returns the first value of this page that is bigger than (upper) or
+     * not smaller than (!upper) the key. If prefixOnly, values are cut to
+     * the size of the key before comparing, so values starting with the key
+     * compare equal.
+     *
+     * @return Position of the value, or numberOfEntries() if there is none
+     */
+    page::IndexEntriesType bound(const std::string& key, bool prefixOnly, bool upper) {
+      const char* first = bytesAt(0);
+      uint64_t firstSize = stringSizeAt(0);
+      uint64_t prefixSize = page::prefixLength(first, firstSize, key);
+
+      // Comparison of the key with the first value
+      int firstCmp;
+      if (prefixSize < firstSize && prefixSize < key.size()) {
+        firstCmp = static_cast<uint8_t>(key[prefixSize]) < static_cast<uint8_t>(first[prefixSize]) ? -1 : 1;
+      }
+      else {
+        firstCmp = key.size() < firstSize ? -1 : (key.size() > firstSize ? 1 : 0);
+      }
+
+      // Values sharing more bytes with the first value compare like it;
+      // values sharing fewer bytes are bigger than the key
+      int sharingMoreCmp = (prefixOnly && prefixSize == key.size()) ? 0 : -firstCmp;
+      if (upper ? sharingMoreCmp > 0 : sharingMoreCmp >= 0) {
+        return 0;
+      }
+
+      page::IndexEntriesType start, end;
+      if (prefixSize > std::numeric_limits<page::PrefixSizeType>::max()) {
+        // No other value shares that many bytes with the first one
+        start = end = 1;
+      }
+      else {
+        scanPrefixSizes(static_cast<page::PrefixSizeType>(prefixSize), start, end);
+      }
+
+      // Binary search the values sharing exactly prefixSize bytes
+      const char* rest = key.c_str() + prefixSize;
+      uint64_t restSize = key.size() - prefixSize;
+      while (start < end) {
+        page::IndexEntriesType middle = start+(end-start)/2;
+        uint64_t size = stringSizeAt(middle);
+        int cmp = memcmp(bytesAt(middle), rest, page::min<uint64_t>(size, restSize));
+        if (cmp == 0) {
+          if (prefixOnly) {
+            cmp = size >= restSize ? 0 : -1;
+          }
+          else {
+            cmp = size < restSize ? -1 : (size > restSize ? 1 : 0);
+          }
+        }
+
+        if (upper ? cmp > 0 : cmp >= 0) {
+          end = middle;
+        }
+        else {
+          start = middle + 1;
+        }
+      }
+      return end;
+    }
+
+    bool startsWith(page::IndexEntriesType entry, const std::string& prefix) {
+      page::Iterator<PaxPage<TSize>> iterator(this, entry);
+      const uint8_t* key = reinterpret_cast<const uint8_t*>(prefix.c_str());
+      unsigned size = static_cast<unsigned>(prefix.size());
+      if (prefixSizeAt(entry) + stringSizeAt(entry) < size) {
+        return false;
+      }
+      return iterator.valueMismatch(key, 0, size) == size;
+    }
+
+  public:
+    static uint64_t counter;
+
+    PaxPage() : Page<TSize, PaxPage<TSize>>() {
+      counter++;
+    }
+
+    PaxPage(const PaxPage&) = delete;
+    PaxPage& operator=(const PaxPage&) = delete;
+
+    inline page::IndexEntriesType numberOfEntries() const {
+      return *reinterpret_cast<const page::IndexEntriesType*>(this->data);
+    }
+
+    PageIterator<PaxPage<TSize>> getIndexEntry(page::IndexEntriesType indexEntry) {
+      return PageIterator<PaxPage<TSize>>(this, indexEntry);
+    }
+
+    PageIterator<PaxPage<TSize>> getByOffset(uint16_t offset) {
+      return PageIterator<PaxPage<TSize>>(this, static_cast<page::IndexEntriesType>(offset / sizeof(page::OffsetType)));
+    }
+
+    PageIterator<PaxPage<TSize>> find(const std::string& str) {
+      PaxPage<TSize>* current = this;
+      while (true) {
+        page::IndexEntriesType entry = current->bound(str, false, false);
+        if (entry < current->numberOfEntries()) {
+          if (current->prefixSizeAt(entry) + current->stringSizeAt(entry) == str.size() && current->startsWith(entry, str)) {
+            return PageIterator<PaxPage<TSize>>(current, entry);
+          }
+          return PageIterator<PaxPage<TSize>>();
+        }
+        if (current->nextPage == nullptr) {
+          return PageIterator<PaxPage<TSize>>();
+        }
+        // Bigger than all values of this page
+        current = current->nextPage;
+      }
+    }
+
+    PageIterator<PaxPage<TSize>> firstPrefix(const std::string& str) {
+      PaxPage<TSize>* current = this;
+      while (true) {
+        page::IndexEntriesType entry = current->bound(str, true, false);
+        if (entry < current->numberOfEntries()) {
+          if (current->startsWith(entry, str)) {
+            return PageIterator<PaxPage<TSize>>(current, entry);
+          }
+          return PageIterator<PaxPage<TSize>>();
+        }
+        if (current->nextPage == nullptr) {
+          return PageIterator<PaxPage<TSize>>();
+        }
+        current = current->nextPage;
+      }
+    }
+
+    PageIterator<PaxPage<TSize>> lastPrefix(const std::string& str) {
+      PaxPage<TSize>* current = this;
+      while (true) {
+        page::IndexEntriesType entry = current->bound(str, true, true);
+        if (entry == current->numberOfEntries() && current->nextPage != nullptr && current->nextPage->bound(str, true, true) > 0) {
+          // The range continues on the next page
+          current = current->nextPage;
+          continue;
+        }
+        if (entry > 0 && current->startsWith(entry - 1, str)) {
+          return PageIterator<PaxPage<TSize>>(current, entry - 1);
+        }
+        return PageIterator<PaxPage<TSize>>();
+      }
+    }
+
+    PageIterator<PaxPage<TSize>> last() {
+      return PageIterator<PaxPage<TSize>>(this, numberOfEntries() - 1);
+    }
+
+  public:
+    class Loader : public page::Loader<PaxPage<TSize>> {
+      private:
+        PageArena<PaxPage<TSize>>& arena;
+
+        // Last value written, for "retro-inserts"
+        std::pair<page::IdType, std::string> lastPair;
+
+      public:
+        Loader(PageArena<PaxPage<TSize>>& arena) : arena(arena) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename page::Loader<PaxPage<TSize>>::CallbackType callback) {
+          PaxPage<TSize>* currentPage = nullptr;
+          std::vector<page::PrefixSizeType> prefixSizes;
+
+          // End of the values that fit on a page starting at start
+          auto reach = [&](decltype(values.cbegin()) start) {
+            uint64_t pageSize = headerSize + entrySize + this->storedSize(start->second);
+            auto endIt = start + 1;
+            for (uint64_t entries = 1; endIt != values.cend() && entries < std::numeric_limits<page::IndexEntriesType>::max(); ++endIt, entries++) {
+              uint64_t size = entrySize + endIt->second.size() - page::prefixLength(start->second.c_str(), start->second.size(), endIt->second);
+              if (pageSize + size > TSize) {
+                break;
+              }
+              pageSize += size;
+            }
+            return endIt;
+          };
+
+          auto pairIt = values.cbegin();
+          while (pairIt != values.cend()) {
+            const std::string& deltaRef = pairIt->second;
+
+            if (headerSize + entrySize + this->storedSize(deltaRef) > TSize) {
+              // We can't fit one string on this page!?
+              throw Exception("Can't fit on page: " + deltaRef);
+            }
+
+            // Count how many values will fit on this page
+            auto pageEnd = this->pageEnd(pairIt, values.cend(), reach);
+            if (pageEnd == pairIt) {
+              // Leave the values to the next chunk
+              return static_cast<size_t>(pairIt - values.cbegin());
+            }
+            prefixSizes.clear();
+            prefixSizes.push_back(0);
+            for (auto deltaIt = pairIt + 1; deltaIt != pageEnd; ++deltaIt) {
+              uint64_t prefixSize = page::prefixLength(deltaRef.c_str(), deltaRef.size(), deltaIt->second);
+#ifdef DEBUG
+              assert(prefixSize <= std::numeric_limits<page::PrefixSizeType>::max());
+#endif
+              prefixSizes.push_back(static_cast<page::PrefixSizeType>(prefixSize));
+            }
+            page::IndexEntriesType entries = static_cast<page::IndexEntriesType>(prefixSizes.size());
+
+            // Create new page
+            currentPage = new (arena) PaxPage<TSize>();
+            if (this->lastPage != nullptr) {
+              this->lastPage->nextPage = currentPage;
+
+              if (pairIt->second[0] == lastPair.second[0]) {
+                // "Retro-insert"
+                page::IndexEntriesType lastEntry = static_cast<page::IndexEntriesType>(this->lastPage->numberOfEntries() - 1);
+                callback(this->lastPage, 0, static_cast<uint16_t>(lastEntry * sizeof(page::OffsetType)), lastPair.first, lastPair.second);
+              }
+            }
+
+            char* dataPtr = currentPage->data;
+            page::write<page::IndexEntriesType>(dataPtr, entries);
+
+            char* heapPtr = currentPage->heap();
+            for (page::IndexEntriesType entry = 0; entry < entries; entry++, ++pairIt) {
+              page::PrefixSizeType prefixSize = prefixSizes[entry];
+              currentPage->ids()[entry] = pairIt->first;
+              currentPage->prefixSizes()[entry] = prefixSize;
+              currentPage->heapOffsets()[entry] = static_cast<page::OffsetType>(heapPtr - currentPage->heap());
+              if (entry == 0 && this->overflows(pairIt->second)) {
+                // Store the first value in the blob store, and a reference to it here
+                currentPage->stringSizes()[entry] = page::overflowMarker;
+                page::write<const char*>(heapPtr, arena.blobs.store(pairIt->second.c_str(), pairIt->second.size()));
+              }
+              else {
+#ifdef DEBUG
+                assert(pairIt->second.size() - prefixSize < page::overflowMarker);
+#endif
+                currentPage->stringSizes()[entry] = static_cast<page::StringSizeType>(pairIt->second.size() - prefixSize);
+                memcpy(heapPtr, pairIt->second.c_str() + prefixSize, pairIt->second.size() - prefixSize);
+                heapPtr += pairIt->second.size() - prefixSize;
+              }
+
+              if (entry == 0) {
+                callback(currentPage, 1, /* offset*/ 0, pairIt->first, pairIt->second);
+              }
+              else {
+                callback(currentPage, 2, static_cast<uint16_t>(entry * sizeof(page::OffsetType)), pairIt->first, pairIt->second);
+              }
+            }
+
+            lastPair = *(pairIt-1);
+            this->lastPage = currentPage;
+          }
+          return values.size();
+        }
+    };
+
+  public:
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<PaxPage<TSize>>::CallbackType callback, PageArena<PaxPage<TSize>>& arena) {
+      Loader(arena).load(values, callback);
+    }
+
+    static std::string description() {
+      return std::to_string(TSize);
+    }
+};
+
+template<uint64_t TSize>
+const uint64_t PaxPage<TSize>::headerSize;
+
+template<uint64_t TSize>
+const uint64_t PaxPage<TSize>::entrySize;
+
+template<uint64_t TSize>
+uint64_t PaxPage<TSize>::counter = 0;
+
+#endif
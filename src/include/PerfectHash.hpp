@@ -0,0 +1,72 @@
+#ifndef H_PerfectHash
+#define H_PerfectHash
+
+#include "FingerprintHash.hpp"
+#include "LeafStore.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Static index based on a minimal perfect hash function (BBHash).
+ *
+ * Only the hashes and leaf values of keys are collected until freeze() is
+ * called; lookups before that scan them. The function is then built over
+ * the hashes of all keys, in parallel, and maps
+ * every key to a distinct position in the array of leaf values. It needs
+ * about 3 bits per key, and a lookup reads one bit per level and one leaf
+ * value. The leaf values are packed to the bits of the biggest one. Since unknown keys are mapped to arbitrary positions, the leaf is
+ * verified against the leaf store. Only lookups are possible afterwards.
+ */
+template<class TKey>
+class PerfectHash {
+  private:
+    LeafStore* leafStore;
+    bool frozen;
+    std::vector<uint64_t> pendingHashes;
+    std::vector<uint64_t> pendingValues;
+
+    // Bit arrays of all levels; a set bit is the position of exactly one key
+    std::vector<uint64_t> bits;
+    // Bit offset of every level in bits, followed by the total number of bits
+    std::vector<uint64_t> levelOffsets;
+    // Number of set bits before every block of bits
+    std::vector<uint64_t> ranks;
+    // Leaf values by rank of the key's position, leafValueBits bits each
+    std::vector<uint64_t> leafValues;
+    unsigned leafValueBits;
+    // Keys that were not placed after the last level, sorted by hash
+    std::vector<std::pair<uint64_t, uint64_t>> fallback;
+
+    uint64_t rank(uint64_t position) const;
+    uint64_t leafValueAt(uint64_t index) const;
+    bool leafMatches(uint64_t leafValue, const TKey& key) const;
+
+  public:
+    PerfectHash(LeafStore* leafStore);
+
+    /**
+     * Inserts a value; only possible before the index is frozen.
+     */
+    void insert(TKey key, uint64_t value);
+    bool lookup(TKey key, uint64_t& value) const;
+    std::pair<uint64_t, uint64_t> rangeLookup(TKey prefix) const;
+
+    /**
+     * Builds the perfect hash function over all inserted keys.
+     */
+    void freeze();
+    bool isFrozen() const;
+
+    /**
+     * Returns the size of the frozen function and leaf values in bytes.
+     */
+    uint64_t frozenSize() const;
+
+    static std::string description();
+    void debug() { }
+};
+
+#endif
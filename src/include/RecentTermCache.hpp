@@ -0,0 +1,46 @@
+#ifndef H_RecentTermCache
+#define H_RecentTermCache
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Tiny cache of the most recently encoded terms and their IDs.
+ *
+ * Turtle predicate and object lists repeat the same subject (and predicate)
+ * for consecutive triples, so comparing against a handful of recent terms
+ * avoids most probes of the full term table.
+ */
+template<size_t TSize>
+class RecentTermCache {
+  private:
+    std::array<std::string, TSize> terms;
+    std::array<uint64_t, TSize> ids;
+    size_t used = 0;
+    size_t next = 0;
+
+  public:
+    bool lookup(const std::string& term, uint64_t& id) const {
+      for (size_t i = 0; i < used; i++) {
+        if (terms[i] == term) {
+          id = ids[i];
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void insert(const std::string& term, uint64_t id) {
+      // Replace entries round-robin
+      terms[next] = term;
+      ids[next] = id;
+      next = (next + 1) % TSize;
+      if (used < TSize) {
+        used++;
+      }
+    }
+};
+
+#endif
@@ -0,0 +1,337 @@
+#ifndef H_RestartPage
+#define H_RestartPage
+
+#include "Page.hpp"
+#include <cstring>
+
+template<uint64_t TSize, uint16_t TRestartInterval>
+class RestartPage;
+
+namespace page {
+  /**
+   * Iterator over the values of RestartPages. Values are front coded against
+   * their predecessor, so the iterator keeps the current value decoded.
+   */
+  template<uint64_t TSize, uint16_t TRestartInterval>
+    class Iterator<RestartPage<TSize, TRestartInterval>> {
+      friend RestartPage<TSize, TRestartInterval>;
+
+      protected:
+      RestartPage<TSize, TRestartInterval>* currentPage;
+      // Start of the entry behind the current one
+      char* readPtr;
+      page::IndexEntriesType entry;
+      IdType id;
+      std::string value;
+
+      /**
+       * Decodes the entry at readPtr, which follows the current value.
+       */
+      void decode() {
+        id = page::read<IdType>(readPtr);
+        PrefixSizeType shared = page::read<PrefixSizeType>(readPtr);
+        StringSizeType nonShared = page::read<StringSizeType>(readPtr);
+#ifdef DEBUG
+        assert(shared <= value.size());
+#endif
+        value.resize(shared);
+        if (nonShared == page::overflowMarker) {
+          const char* blob = page::read<const char*>(readPtr);
+          value.append(BlobStore::bytes(blob), BlobStore::size(blob));
+        }
+        else {
+          value.append(page::readString(readPtr, nonShared), nonShared);
+        }
+      }
+
+      Iterator& gotoEntry(page::IndexEntriesType entry) {
+        assert(currentPage != nullptr);
+        assert(entry < currentPage->numberOfEntries());
+
+        // Decode from the closest restart point, which is stored completely
+        page::IndexEntriesType restart = static_cast<page::IndexEntriesType>(entry / TRestartInterval);
+        readPtr = currentPage->restartAt(restart);
+        value.clear();
+        for (this->entry = static_cast<page::IndexEntriesType>(restart * TRestartInterval); ; this->entry++) {
+          decode();
+          if (this->entry == entry) {
+            break;
+          }
+        }
+        return *this;
+      }
+
+      Iterator(RestartPage<TSize, TRestartInterval>* pagePtr, page::IndexEntriesType entry) : currentPage(pagePtr), readPtr(nullptr), entry(0), id(0) {
+        gotoEntry(entry);
+      }
+
+      public:
+      Iterator() : currentPage(nullptr), readPtr(nullptr), entry(0), id(0) {
+      }
+
+      Iterator(RestartPage<TSize, TRestartInterval>* pagePtr) : currentPage(pagePtr), readPtr(nullptr), entry(0), id(0) {
+        gotoEntry(0);
+      }
+
+      IdType getId() {
+        assert(currentPage != nullptr);
+        return id;
+      }
+
+      std::string getValue() {
+        assert(currentPage != nullptr);
+        return value;
+      }
+
+      const page::Leaf operator*() {
+        assert(currentPage != nullptr);
+        return std::make_pair(id, value);
+      }
+
+      /**
+       * Compares bytes [from, to) of the current value with the same bytes
+       * of a key. Bytes behind the end of the value compare as 0.
+       *
+       * @return Position of the first mismatching byte, or to if all bytes match
+       */
+      unsigned valueMismatch(const uint8_t* key, unsigned from, unsigned to) {
+        assert(currentPage != nullptr);
+        unsigned pos = from;
+        for (; pos < to && pos < value.size(); pos++) {
+          if (static_cast<uint8_t>(value[pos]) != key[pos]) {
+            return pos;
+          }
+        }
+        for (; pos < to; pos++) {
+          if (key[pos] != 0) {
+            return pos;
+          }
+        }
+        return pos;
+      }
+
+      Iterator& operator++() {
+        assert(currentPage != nullptr);
+        if (entry + 1 < currentPage->numberOfEntries()) {
+          entry++;
+          decode();
+        }
+        else if (currentPage->nextPage != nullptr) {
+          currentPage = currentPage->nextPage;
+          gotoEntry(0);
+        }
+        else {
+          currentPage = nullptr;
+        }
+        return *this;
+      }
+
+      operator bool() {
+        return currentPage != nullptr;
+      }
+
+      void debug() const {
+        assert(currentPage != nullptr);
+        std::cout << "> Restart page, " << currentPage->numberOfEntries() << " entries, restart interval " << TRestartInterval << std::endl;
+        Iterator<RestartPage<TSize, TRestartInterval>> it(currentPage);
+        for (page::IndexEntriesType i = 0; i < currentPage->numberOfEntries(); i++, ++it) {
+          std::cout << (i % TRestartInterval == 0 ? "> " : "  ") << it.id << " " << it.value << std::endl;
+        }
+      }
+    };
+}
+
+/**
+ * Fixed-size page that front codes every value against its predecessor.
+ *
+ * Every TRestartInterval-th value is a restart point, which is stored
+ * completely; a directory behind the number of values holds the offsets
+ * of the restart points. Accessing a value decodes at most TRestartInterval
+ * values, starting at the preceding restart point. Smaller intervals cost
+ * compression, larger ones decode time.
+ *
+ * Each entry consists of the ID, the number of bytes shared with the
+ * previous value, and the size and bytes of the rest of the value. Rests
+ * longer than an eighth of the page are stored in a blob store instead,
+ * and the entry holds a reference to the blob. This keeps small pages
+ * usable for datasets with very long literals. The blob store belongs to
+ * the arena of the pages, so blobs are freed with the dictionary.
+ *
+ * Values are addressed by their position in the page, so the page is used
+ * with the DeltaStrategy or IndirectStrategy.
+ */
+template<uint64_t TSize, uint16_t TRestartInterval = 16>
+class RestartPage : public Page<TSize, RestartPage<TSize, TRestartInterval>> {
+  friend class page::Iterator<RestartPage<TSize, TRestartInterval>>;
+
+  private:
+    typedef uint16_t RestartCountType;
+    static const uint64_t headerSize = sizeof(page::IndexEntriesType) + sizeof(RestartCountType);
+    static const uint64_t entryHeaderSize = sizeof(page::IdType) + sizeof(page::PrefixSizeType) + sizeof(page::StringSizeType);
+    // Longer rests of values are stored out of line
+    static const uint64_t overflowSize = TSize / 8;
+
+    static_assert(TRestartInterval > 0, "The restart interval has to be positive");
+    static_assert(TSize <= static_cast<uint64_t>(std::numeric_limits<page::OffsetType>::max()) + 1, "Restart offsets have to fit into page::OffsetType");
+
+    inline RestartCountType numberOfRestarts() const {
+      return *reinterpret_cast<const RestartCountType*>(this->data + sizeof(page::IndexEntriesType));
+    }
+
+    inline page::OffsetType* restarts() {
+      return reinterpret_cast<page::OffsetType*>(this->data + headerSize);
+    }
+
+    inline char* restartAt(page::IndexEntriesType restart) {
+      return reinterpret_cast<char*>(restarts() + numberOfRestarts()) + restarts()[restart];
+    }
+
+    static inline uint64_t storedSize(uint64_t restSize) {
+      return restSize > overflowSize ? sizeof(const char*) : restSize;
+    }
+
+    /**
+     * Returns the number of bytes a value shares with the previous one,
+     * at most as many as a prefix size can hold.
+     */
+    static page::PrefixSizeType sharedLength(const std::string& previous, const std::string& value) {
+      uint64_t maxLength = page::min<uint64_t>(page::min<uint64_t>(previous.size(), value.size()), std::numeric_limits<page::PrefixSizeType>::max());
+      uint64_t pos = 0;
+      while (pos < maxLength && previous[pos] == value[pos]) {
+        pos++;
+      }
+      return static_cast<page::PrefixSizeType>(pos);
+    }
+
+  public:
+    static uint64_t counter;
+
+    RestartPage() : Page<TSize, RestartPage<TSize, TRestartInterval>>() {
+      counter++;
+    }
+
+    RestartPage(const RestartPage&) = delete;
+    RestartPage& operator=(const RestartPage&) = delete;
+
+    inline page::IndexEntriesType numberOfEntries() const {
+      return *reinterpret_cast<const page::IndexEntriesType*>(this->data);
+    }
+
+    PageIterator<RestartPage<TSize, TRestartInterval>> getIndexEntry(page::IndexEntriesType indexEntry) {
+      return PageIterator<RestartPage<TSize, TRestartInterval>>(this, indexEntry);
+    }
+
+    PageIterator<RestartPage<TSize, TRestartInterval>> getByDelta(uint16_t delta) {
+      return getIndexEntry(delta);
+    }
+
+  public:
+    class Loader : public page::Loader<RestartPage<TSize, TRestartInterval>> {
+      private:
+        PageArena<RestartPage<TSize, TRestartInterval>>& arena;
+
+      public:
+        Loader(PageArena<RestartPage<TSize, TRestartInterval>>& arena) : arena(arena) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename page::Loader<RestartPage<TSize, TRestartInterval>>::CallbackType callback) {
+          RestartPage<TSize, TRestartInterval>* currentPage = nullptr;
+          std::vector<page::PrefixSizeType> prefixSizes;
+
+          auto pairIt = values.cbegin();
+          while (pairIt != values.cend()) {
+            uint64_t pageSize = headerSize + sizeof(page::OffsetType) + entryHeaderSize + storedSize(pairIt->second.size());
+            if (pageSize > TSize) {
+              // We can't fit one string on this page!?
+              throw Exception("Can't fit on page: " + pairIt->second);
+            }
+
+            // Count how many values will fit on this page
+            prefixSizes.clear();
+            prefixSizes.push_back(0);
+            auto deltaIt = pairIt;
+            for (++deltaIt; deltaIt != values.cend() && prefixSizes.size() < std::numeric_limits<page::IndexEntriesType>::max(); ++deltaIt) {
+              bool restart = prefixSizes.size() % TRestartInterval == 0;
+              page::PrefixSizeType prefixSize = restart ? 0 : sharedLength((deltaIt-1)->second, deltaIt->second);
+              uint64_t size = (restart ? sizeof(page::OffsetType) : 0) + entryHeaderSize + storedSize(deltaIt->second.size() - prefixSize);
+              if (pageSize + size > TSize) {
+                break;
+              }
+              pageSize += size;
+              prefixSizes.push_back(prefixSize);
+            }
+            if (this->moreValues && deltaIt == values.cend()) {
+              // The page might take more values; leave them to the next chunk
+              return static_cast<size_t>(pairIt - values.cbegin());
+            }
+            page::IndexEntriesType entries = static_cast<page::IndexEntriesType>(prefixSizes.size());
+            RestartCountType restarts = static_cast<RestartCountType>((entries + TRestartInterval - 1) / TRestartInterval);
+
+            // Create new page
+            currentPage = new (arena) RestartPage<TSize, TRestartInterval>();
+            if (this->lastPage != nullptr) {
+              this->lastPage->nextPage = currentPage;
+            }
+
+            char* dataPtr = currentPage->data;
+            page::write<page::IndexEntriesType>(dataPtr, entries);
+            page::write<RestartCountType>(dataPtr, restarts);
+            page::OffsetType* restartPtr = reinterpret_cast<page::OffsetType*>(dataPtr);
+            // Reserve space for the restart directory
+            page::advance<page::OffsetType>(dataPtr, restarts);
+            char* startOfEntries = dataPtr;
+
+            for (page::IndexEntriesType entry = 0; entry < entries; entry++, ++pairIt) {
+              if (entry % TRestartInterval == 0) {
+                restartPtr[entry / TRestartInterval] = static_cast<page::OffsetType>(dataPtr - startOfEntries);
+              }
+
+              const std::string& value = pairIt->second;
+              page::PrefixSizeType prefixSize = prefixSizes[entry];
+              uint64_t restSize = value.size() - prefixSize;
+              uint64_t valueAddress = reinterpret_cast<uint64_t>(dataPtr);
+              page::write<page::IdType>(dataPtr, pairIt->first);
+              page::write<page::PrefixSizeType>(dataPtr, prefixSize);
+              if (restSize > overflowSize) {
+                // Store the rest in the blob store, and a reference to it here
+                page::write<page::StringSizeType>(dataPtr, page::overflowMarker);
+                page::write<const char*>(dataPtr, arena.blobs.store(value.c_str() + prefixSize, restSize));
+              }
+              else {
+                page::write<page::StringSizeType>(dataPtr, static_cast<page::StringSizeType>(restSize));
+                memcpy(dataPtr, value.c_str() + prefixSize, restSize);
+                page::advance(dataPtr, restSize);
+              }
+
+              page::Loader<RestartPage<TSize, TRestartInterval>>::call(callback, currentPage, entry, valueAddress, pairIt->first, value);
+            }
+
+            this->lastPage = currentPage;
+          }
+          return values.size();
+        }
+    };
+
+  public:
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<RestartPage<TSize, TRestartInterval>>::CallbackType callback, PageArena<RestartPage<TSize, TRestartInterval>>& arena) {
+      Loader(arena).load(values, callback);
+    }
+
+    static std::string description() {
+      return std::to_string(TSize);
+    }
+};
+
+template<uint64_t TSize, uint16_t TRestartInterval>
+const uint64_t RestartPage<TSize, TRestartInterval>::headerSize;
+
+template<uint64_t TSize, uint16_t TRestartInterval>
+const uint64_t RestartPage<TSize, TRestartInterval>::entryHeaderSize;
+
+template<uint64_t TSize, uint16_t TRestartInterval>
+const uint64_t RestartPage<TSize, TRestartInterval>::overflowSize;
+
+template<uint64_t TSize, uint16_t TRestartInterval>
+uint64_t RestartPage<TSize, TRestartInterval>::counter = 0;
+
+#endif
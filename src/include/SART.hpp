@@ -6,13 +6,11 @@
 
 template<class TKey>
 class SART : public ART<TKey> {
-  protected:
-    ARTBase::Node* lookupPrefix(ARTBase::Node* node, uint8_t prefix[], unsigned prefixLength, unsigned depth) const {
-      return ARTBase::sartLookupPrefix(node, prefix, prefixLength, depth);
-    }
   public:
     SART(LeafStore* leafStore);
+    // Hide the ART lookups; indexes are used by their concrete type
     bool lookup(TKey key, uintptr_t& value) const;
+    std::pair<uintptr_t, uintptr_t> rangeLookup(TKey prefix) const;
     static std::string description();
     void debug();
 };
@@ -0,0 +1,61 @@
+#ifndef H_Semaphore
+#define H_Semaphore
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * Counting semaphore, for limiting the work in flight between pipeline stages.
+ *
+ * Closing the semaphore wakes everyone up; acquiring then fails.
+ */
+class Semaphore {
+  private:
+    size_t count;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable available;
+
+  public:
+    Semaphore(size_t count) : count(count), closed(false) {
+    }
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    /**
+     * Takes one unit, waiting for one to be released if necessary.
+     *
+     * @return True if a unit was taken, false if the semaphore is closed
+     */
+    bool acquire() {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this] { return closed || count > 0; });
+      if (closed) {
+        return false;
+      }
+      count--;
+      return true;
+    }
+
+    /**
+     * Returns one unit.
+     */
+    void release() {
+      std::lock_guard<std::mutex> lock(mutex);
+      count++;
+      available.notify_one();
+    }
+
+    /**
+     * Closes the semaphore; no more units can be taken.
+     */
+    void close() {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed = true;
+      available.notify_all();
+    }
+};
+
+#endif
@@ -33,12 +33,17 @@ class SingleUncompressedPage : public Page<TSize, SingleUncompressedPage<TSize>>
       return PageIterator<SingleUncompressedPage<TSize>>(this).gotoOffset(offset);
     }
 
-  private:
+  public:
     class Loader : public page::Loader<SingleUncompressedPage<TSize>> {
+      private:
+        PageArena<SingleUncompressedPage<TSize>>& arena;
+
       public:
-        void load(std::vector<std::pair<page::IdType, std::string>> values, typename page::Loader<SingleUncompressedPage<TSize>>::CallbackType callback) {
+        Loader(PageArena<SingleUncompressedPage<TSize>>& arena) : arena(arena) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename page::Loader<SingleUncompressedPage<TSize>>::CallbackType callback) {
           SingleUncompressedPage<TSize>* currentPage = nullptr;
-          SingleUncompressedPage<TSize>* lastPage = nullptr;
           const char* endOfPage = nullptr;
           char* dataPtr = nullptr;
           uint16_t deltaNumber = 0;
@@ -47,24 +52,45 @@ class SingleUncompressedPage : public Page<TSize, SingleUncompressedPage<TSize>>
 
           const std::string* deltaRef = nullptr;
           uintptr_t valuePtr;
+          auto pageEnd = values.cend();
+
+          // End of the values that fit on a page starting at start
+          auto reach = [&](decltype(values.cbegin()) start) {
+            uint64_t pageSize = prefixHeaderSize + this->storedSize(start->second);
+            auto endIt = start + 1;
+            for (; endIt != values.cend(); ++endIt) {
+              uint64_t deltaSize = deltaHeaderSize + this->deltaLength(start->second, endIt->second);
+              if (pageSize + deltaSize > TSize - sizeof(uint8_t)) {
+                break;
+              }
+              pageSize += deltaSize;
+            }
+            return endIt;
+          };
 
-          for (const auto& pair : values) {
+          for (auto pairIt = values.cbegin(); pairIt != values.cend(); ++pairIt) {
+            const auto& pair = *pairIt;
             if (deltaRef != nullptr) {
               // Will insert delta
-              auto deltaSize = this->deltaLength(*deltaRef, pair.second);
-              if (dataPtr != nullptr && dataPtr + deltaHeaderSize + deltaSize > endOfPage) {
+              if (pairIt == pageEnd) {
                 // "Finish" page
                 this->endPage(dataPtr);
-                lastPage = currentPage;
+                this->lastPage = currentPage;
                 currentPage = nullptr;
               }
             }
 
             if (currentPage == nullptr) {
+              pageEnd = this->pageEnd(pairIt, values.cend(), reach);
+              if (pageEnd == pairIt) {
+                // Leave the values to the next chunk
+                return static_cast<size_t>(pairIt - values.cbegin());
+              }
+
               // Create new page
-              currentPage = new SingleUncompressedPage<TSize>();
-              if (lastPage != nullptr) {
-                lastPage->nextPage = currentPage;
+              currentPage = new (arena) SingleUncompressedPage<TSize>();
+              if (this->lastPage != nullptr) {
+                this->lastPage->nextPage = currentPage;
               }
               dataPtr = currentPage->data;
               endOfPage = currentPage->data + currentPage->size - sizeof(uint8_t);
@@ -72,7 +98,7 @@ class SingleUncompressedPage : public Page<TSize, SingleUncompressedPage<TSize>>
 
               deltaRef = &pair.second;
 
-              if (dataPtr + prefixHeaderSize + pair.second.size() > endOfPage) {
+              if (dataPtr + prefixHeaderSize + this->storedSize(pair.second) > endOfPage) {
                 // We can't fit one string on this page!?
                 throw Exception("Can't fit on page: " + pair.second);
               }
@@ -81,7 +107,7 @@ class SingleUncompressedPage : public Page<TSize, SingleUncompressedPage<TSize>>
 
               // Write uncompressed value
               this->writeId(dataPtr, pair.first);
-              this->writeValue(dataPtr, pair.second);
+              this->writeValue(dataPtr, pair.second, arena.blobs);
 
               page::Loader<SingleUncompressedPage<TSize>>::call(callback, currentPage, deltaNumber++, valuePtr, pair.first, pair.second);
               continue;
@@ -98,13 +124,14 @@ class SingleUncompressedPage : public Page<TSize, SingleUncompressedPage<TSize>>
           }
 
           this->endPage(dataPtr);
-          lastPage = currentPage;
+          this->lastPage = currentPage;
+          return values.size();
         }
     };
 
   public:
-    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<SingleUncompressedPage<TSize>>::CallbackType callback) {
-      Loader().load(values, callback);
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<SingleUncompressedPage<TSize>>::CallbackType callback, PageArena<SingleUncompressedPage<TSize>>& arena) {
+      Loader(arena).load(values, callback);
     }
 
     static std::string description() {
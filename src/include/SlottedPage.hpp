@@ -5,34 +5,41 @@
 
 /**
  * Fixed-size page implementation that holds a single uncompressed string per page.
+ *
+ * TLayout selects the layout of the entry headers, see page::FixedLayout
+ * and page::PackedLayout.
  */
-template<uint64_t TSize>
-class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
+template<uint64_t TSize, class TLayout = page::FixedLayout>
+class SlottedPage : public Page<TSize, SlottedPage<TSize, TLayout>> {
   public:
+    typedef TLayout Layout;
     static uint64_t counter;
 
-    SlottedPage() : Page<TSize, SlottedPage<TSize>>() {
+    SlottedPage() : Page<TSize, SlottedPage<TSize, TLayout>>() {
       counter++;
     }
 
     SlottedPage(const SlottedPage&) = delete;
     SlottedPage& operator=(const SlottedPage&) = delete;
 
-    PageIterator<SlottedPage<TSize>> getIndexEntry(page::IndexEntriesType indexEntry) {
-      return PageIterator<SlottedPage<TSize>>(this).getIndexEntry(indexEntry);
+    PageIterator<SlottedPage<TSize, TLayout>> getIndexEntry(page::IndexEntriesType indexEntry) {
+      return PageIterator<SlottedPage<TSize, TLayout>>(this).getIndexEntry(indexEntry);
     }
 
-  private:
-    class Loader : public page::Loader<SlottedPage<TSize>> {
+  public:
+    class Loader : public page::Loader<SlottedPage<TSize, TLayout>> {
+      private:
+        PageArena<SlottedPage<TSize, TLayout>>& arena;
+
       public:
-        void load(std::vector<std::pair<page::IdType, std::string>> values, typename page::Loader<SlottedPage<TSize>>::CallbackType callback) {
-          SlottedPage<TSize>* currentPage = nullptr;
-          SlottedPage<TSize>* lastPage = nullptr;
+        Loader(PageArena<SlottedPage<TSize, TLayout>>& arena) : arena(arena) {
+        }
+
+        size_t load(const std::vector<std::pair<page::IdType, std::string>>& values, typename page::Loader<SlottedPage<TSize, TLayout>>::CallbackType callback) {
+          SlottedPage<TSize, TLayout>* currentPage = nullptr;
           const char* endOfPage = nullptr;
           char* dataPtr = nullptr;
           page::IndexEntriesType deltaNumber = 0;
-          const uint64_t prefixHeaderSize = sizeof(page::HeaderType) + sizeof(page::IdType) + sizeof(page::StringSizeType);
-          const uint64_t deltaHeaderSize = sizeof(page::HeaderType) + sizeof(page::IdType) + sizeof(page::StringSizeType) + sizeof(page::PrefixSizeType);
           const uint64_t indexHeaderSize = sizeof(page::HeaderType) + sizeof(page::IndexEntriesType);
 
           const std::string* deltaRef = nullptr;
@@ -40,6 +47,20 @@ class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
           uintptr_t valuePtr = 0;
           page::IndexEntriesType numberOfDeltas = 0;
 
+          // End of the values that fit on a page starting at start
+          auto reach = [&](decltype(values.cbegin()) start) {
+            uint64_t pageSize = sizeof(page::IdType) + this->valueEntrySize(start->second) + indexHeaderSize;
+            auto endIt = start + 1;
+            for (; endIt != values.cend(); ++endIt) {
+              uint64_t deltaSize = sizeof(page::OffsetType) + sizeof(page::IdType) + this->deltaEntrySize(start->second, endIt->second);
+              if (pageSize + deltaSize > TSize - sizeof(uint8_t)) {
+                break;
+              }
+              pageSize += deltaSize;
+            }
+            return endIt;
+          };
+
           for (auto pairIt = values.cbegin(); pairIt != values.cend(); ++pairIt) {
             const auto& pair = *pairIt;
             if (deltaRef != nullptr) {
@@ -47,16 +68,22 @@ class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
               if (deltaNumber == numberOfDeltas+1) {
                 // Can't fit delta; "finish" page
                 this->endPage(dataPtr);
-                lastPage = currentPage;
+                this->lastPage = currentPage;
                 currentPage = nullptr;
               }
             }
 
             if (currentPage == nullptr) {
+              auto pageEnd = this->pageEnd(pairIt, values.cend(), reach);
+              if (pageEnd == pairIt) {
+                // Leave the values to the next chunk
+                return static_cast<size_t>(pairIt - values.cbegin());
+              }
+
               // Create new page
-              currentPage = new SlottedPage<TSize>();
-              if (lastPage != nullptr) {
-                lastPage->nextPage = currentPage;
+              currentPage = new (arena) SlottedPage<TSize, TLayout>();
+              if (this->lastPage != nullptr) {
+                this->lastPage->nextPage = currentPage;
               }
               dataPtr = currentPage->data;
               endOfPage = currentPage->data + currentPage->size - sizeof(uint8_t);
@@ -64,26 +91,13 @@ class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
 
               deltaRef = &pair.second;
 
-              if (dataPtr + prefixHeaderSize+indexHeaderSize + pair.second.size() > endOfPage) {
+              if (dataPtr + sizeof(page::IdType) + this->valueEntrySize(pair.second) + indexHeaderSize > endOfPage) {
                 // We can't fit one string on this page!?
                 throw Exception("Can't fit on page: " + pair.second);
               }
 
               // Count how many deltas will fit on this page
-              auto pageSize = dataPtr+prefixHeaderSize+pair.second.size()+indexHeaderSize;
-              auto deltaIt = pairIt;
-              ++deltaIt;
-              numberOfDeltas = 0;
-              if (deltaIt != values.cend()) {
-                auto deltaSize = this->deltaLength(*deltaRef, deltaIt->second);
-                pageSize += sizeof(page::OffsetType)+deltaHeaderSize+deltaSize;
-                while (pageSize <= endOfPage && ++deltaIt != values.cend()) {
-                  numberOfDeltas++;
-
-                  deltaSize = this->deltaLength(*deltaRef, deltaIt->second);
-                  pageSize += sizeof(page::OffsetType)+deltaHeaderSize+deltaSize;
-                }
-              }
+              numberOfDeltas = static_cast<page::IndexEntriesType>(pageEnd - pairIt - 1);
 
               this->startIndex(dataPtr);
 
@@ -96,7 +110,7 @@ class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
 
               // Write uncompressed value
               this->writeId(dataPtr, pair.first);
-              this->writeValue(dataPtr, pair.second);
+              this->writeValue(dataPtr, pair.second, arena.blobs);
 
               callback(currentPage, deltaNumber++, 0, pair.first, pair.second);
               continue;
@@ -126,13 +140,14 @@ class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
           }
 
           this->endPage(dataPtr);
-          lastPage = currentPage;
+          this->lastPage = currentPage;
+          return values.size();
         }
     };
 
   public:
-    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<SlottedPage<TSize>>::CallbackType callback) {
-      Loader().load(values, callback);
+    static inline void load(std::vector<std::pair<page::IdType, std::string>> values, typename PageLoader<SlottedPage<TSize, TLayout>>::CallbackType callback, PageArena<SlottedPage<TSize, TLayout>>& arena) {
+      Loader(arena).load(values, callback);
     }
 
     static std::string description() {
@@ -141,7 +156,7 @@ class SlottedPage : public Page<TSize, SlottedPage<TSize>> {
     }
 };
 
-template<uint64_t TSize>
-uint64_t SlottedPage<TSize>::counter = 0;
+template<uint64_t TSize, class TLayout>
+uint64_t SlottedPage<TSize, TLayout>::counter = 0;
 
 #endif
@@ -4,76 +4,157 @@
 #include <string>
 #include "boost/algorithm/string.hpp"
 #include <cstdint>
+#include <type_traits>
 #include "Page.hpp"
 #ifdef DEBUG
 #undef NDEBUG
 #include <cassert>
 #endif
 
-template<class TIdIndex, class TStringIndex, class TLeaf>
+/**
+ * Encodes a leaf and an additional value (offset, delta number, etc.) as leaf value.
+ *
+ * Pages allocated from a page arena are referenced by page number,
+ * which gives leaf values of 32 bits for up to about 4 GB of pages.
+ */
+template<class TLeaf, class TArena = typename page::ArenaOf<TLeaf>::type>
+class LeafReference {
+  private:
+    static constexpr unsigned bitsFor(uint64_t value) {
+      return value <= 1 ? 0 : 1 + bitsFor((value + 1) / 2);
+    }
+
+    // Enough bits for any position inside a page
+    static const unsigned valueBits = bitsFor(TLeaf::size);
+
+    const TArena& arena;
+
+  public:
+    LeafReference(const TArena& arena) : arena(arena) {
+    }
+
+    inline uint64_t encode(TLeaf* leaf, uint16_t value) const {
+#ifdef DEBUG
+      assert(value < (1ull << valueBits));
+#endif
+      return (arena.numberOf(leaf) << valueBits) | value;
+    }
+
+    inline TLeaf* leaf(uint64_t leafValue) const {
+      return arena.get(leafValue >> valueBits);
+    }
+
+    inline uint16_t value(uint64_t leafValue) const {
+      return static_cast<uint16_t>(leafValue & ((1ull << valueBits) - 1));
+    }
+};
+
+template<class TLeaf, class TArena>
+const unsigned LeafReference<TLeaf, TArena>::valueBits;
+
+/**
+ * Pages that are not allocated from an arena are referenced by pointer.
+ */
+template<class TLeaf>
+class LeafReference<TLeaf, page::NoArena> {
+  public:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+    LeafReference(const page::NoArena& arena) {
+    }
+#pragma GCC diagnostic pop
+
+    inline uint64_t encode(TLeaf* leaf, uint16_t value) const {
+      return (reinterpret_cast<uint64_t>(leaf) << 16) | value;
+    }
+
+    inline TLeaf* leaf(uint64_t leafValue) const {
+      return reinterpret_cast<TLeaf*>(leafValue >> 16);
+    }
+
+    inline uint16_t value(uint64_t leafValue) const {
+      return leafValue & 0xFFFF;
+    }
+};
+
+/**
+ * Base class for construction strategies.
+ *
+ * The concrete strategy is passed as TStrategy (CRTP), so decoding a leaf
+ * is resolved at compile time and can be inlined into the lookup path.
+ * Strategies provide decodeLeaf(uint64_t) and leafCallback(...).
+ */
+template<class TIdIndex, class TStringIndex, class TLeaf, class TStrategy>
 class StrategyBase {
+  private:
+    inline const TStrategy& strategy() const {
+      return static_cast<const TStrategy&>(*this);
+    }
+
   protected:
     TIdIndex& index;
     TStringIndex& reverseIndex;
+    LeafReference<TLeaf> leafReference;
 
     uint64_t encodeLeaf(TLeaf* leaf, uint16_t additionalValue) const {
-      uint64_t leafValue = reinterpret_cast<uint64_t>(leaf);
-      leafValue = leafValue <<16;
-      leafValue |= static_cast<uint64_t>(additionalValue);
+      return leafReference.encode(leaf, additionalValue);
+    }
 
-      return leafValue;
+    TLeaf* decodeLeafPointer(uint64_t leafValue) const {
+      return leafReference.leaf(leafValue);
     }
 
-    virtual PageIterator<TLeaf> decodeLeaf(uint64_t leafValue) const = 0;
-    virtual void leafCallback(TLeaf* leaf, uint16_t deltaNumber, uint16_t offset, uint64_t id, std::string value) = 0;
+    uint16_t decodeAdditionalValue(uint64_t leafValue) const {
+      return leafReference.value(leafValue);
+    }
 
   public:
-    StrategyBase(TIdIndex& idIndex, TStringIndex& strIndex) : index(idIndex), reverseIndex(strIndex) {
+    typedef typename page::ArenaOf<TLeaf>::type ArenaType;
+
+    StrategyBase(TIdIndex& idIndex, TStringIndex& strIndex, const ArenaType& arena) : index(idIndex), reverseIndex(strIndex), leafReference(arena) {
     }
-    virtual ~StrategyBase() { }
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
-    virtual PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, uint64_t lookupId) const {
+    PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, uint64_t lookupId) const {
       // We can get the offset value from the leafValue
       // and just go to the corresponding entry
 #ifdef DEBUG
-      auto leafIt = decodeLeaf(leafValue);
+      auto leafIt = strategy().decodeLeaf(leafValue);
       assert(leafIt);
       if ((*leafIt).first != lookupId) {
         std::cout << "Looked for " << lookupId << ", got " << (*leafIt).first << ": " << (*leafIt).second << std::endl;
         std::cout << leafValue << std::endl;
-        std::cout << (leafValue>>16 ) << std::endl;
-        std::cout << (leafValue & 0xFFFF ) << std::endl;
+        std::cout << decodeLeafPointer(leafValue) << std::endl;
+        std::cout << decodeAdditionalValue(leafValue) << std::endl;
         leafIt.debug();
       }
       assert((*leafIt).first == lookupId);
       return leafIt;
 #else
-      return decodeLeaf(leafValue);
+      return strategy().decodeLeaf(leafValue);
 #endif
     }
 #pragma GCC diagnostic pop
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
-    virtual PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, std::string lookupValue) const {
+    PageIterator<TLeaf> decodeLeaf(uint64_t leafValue, std::string lookupValue) const {
       // We can get the offset value from the leafValue
       // and just go to the corresponding entry
 #ifdef DEBUG
-      auto leafIt = decodeLeaf(leafValue);
+      auto leafIt = strategy().decodeLeaf(leafValue);
       assert(leafIt);
       // Might be a range lookup, so check only prefix
       assert(boost::starts_with((*leafIt).second, lookupValue));
       return leafIt;
 #else
-      return decodeLeaf(leafValue);
+      return strategy().decodeLeaf(leafValue);
 #endif
     }
 #pragma GCC diagnostic pop
 
-
-    virtual bool rangeLookup(std::string prefix, PageIterator<TLeaf>& start, PageIterator<TLeaf>& end) const {
+    bool rangeLookup(std::string prefix, PageIterator<TLeaf>& start, PageIterator<TLeaf>& end) const {
       std::pair<uint64_t, uint64_t> range = reverseIndex.rangeLookup(prefix);
 
       if (range.first == 0) {
@@ -84,8 +165,8 @@ class StrategyBase {
       assert(range.second != 0);
 #endif
 
-      start = decodeLeaf(range.first, prefix);
-      end = decodeLeaf(range.second, prefix);
+      start = strategy().decodeLeaf(range.first, prefix);
+      end = strategy().decodeLeaf(range.second, prefix);
 
 #ifdef DEBUG
       assert(start);
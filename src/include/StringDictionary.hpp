@@ -1,10 +1,13 @@
 #ifndef H_StringDictionary
 #define H_StringDictionary
 
+#include "BloomFilter.hpp"
 #include "Dictionary.hpp"
 #include "Page.hpp"
 #include "LeafStore.hpp"
 #include "ConstructionStrategies.hpp"
+#include "ExternalSorter.hpp"
+#include <utility>
 
 /**
  * Helper class for different constructors
@@ -34,20 +37,78 @@ class ConstructHelper<TIndex, true> {
     }
 };
 
+/**
+ * Helper for freezing indexes that support it after bulk loading
+ */
+template<class TIndex, class = void>
+class FreezeHelper {
+  public:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+    static void freeze(TIndex& index) {
+    }
+#pragma GCC diagnostic pop
+};
+
+template<class TIndex>
+class FreezeHelper<TIndex, decltype(std::declval<TIndex&>().freeze())> {
+  public:
+    static void freeze(TIndex& index) {
+      index.freeze();
+    }
+};
+
+/**
+ * Helper for lookups in indexes that verify their leaves with a given store,
+ * so the dictionary passes itself and the leaf store calls are static
+ */
+template<class TIndex, class TKey, class TStore, class = bool>
+class LookupHelper {
+  public:
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+    static bool lookup(const TIndex& index, TKey key, uint64_t& value, const TStore& store) {
+      return index.lookup(key, value);
+    }
+#pragma GCC diagnostic pop
+};
+
+template<class TIndex, class TKey, class TStore>
+class LookupHelper<TIndex, TKey, TStore, decltype(std::declval<const TIndex&>().lookup(std::declval<TKey>(), std::declval<uint64_t&>(), std::declval<const TStore&>()))> {
+  public:
+    static bool lookup(const TIndex& index, TKey key, uint64_t& value, const TStore& store) {
+      return index.lookup(key, value, store);
+    }
+};
+
 /**
  * Base class for dictionary implementations.
+ *
+ * Indexes and construction strategy are used by their concrete types, so
+ * lookups through a StringDictionary are resolved at compile time; the
+ * Dictionary interface is only a wrapper for choosing one at runtime.
+ *
+ * Value lookups first check TFilter, e.g. a BloomFilter, so most values that
+ * are not in the dictionary never reach the string index.
  */
-template<template<typename> class TIdIndex, template<typename> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy = OffsetStrategy>
-class StringDictionary : public Dictionary, public LeafStore {
+template<template<typename> class TIdIndex, template<typename> class TStringIndex, class TLeaf, template<typename, typename, typename> class TConstructionStrategy = OffsetStrategy, class TFilter = NoFilter>
+class StringDictionary final : public Dictionary, public LeafStore {
 #ifdef DEBUG
   public:
 #else
   private:
 #endif
+    // Owns the pages, so they are freed with the dictionary; declared first,
+    // as the other members reference it
+    typename page::ArenaOf<TLeaf>::type arena;
     TIdIndex<uint64_t> index;
     TStringIndex<std::string> reverseIndex;
     TConstructionStrategy<TIdIndex<uint64_t>, TStringIndex<std::string>, TLeaf> constructionStrategy;
+    TFilter filter;
 
+  public:
+    // Leaf store implementation; public, so that indexes can call it on
+    // the final type without virtual dispatch
     inline std::string getValue(uint64_t leafValue) const {
 #ifdef DEBUG
       auto it = constructionStrategy.decodeLeaf(leafValue);
@@ -68,8 +129,11 @@ class StringDictionary : public Dictionary, public LeafStore {
 #endif
     }
 
-  public:
-    StringDictionary() : index(ConstructHelper<TIdIndex<uint64_t>>::create(this)), reverseIndex(ConstructHelper<TStringIndex<std::string>>::create(this)), constructionStrategy(TConstructionStrategy<TIdIndex<uint64_t>,  TStringIndex<std::string>, TLeaf>(index, reverseIndex)) {
+    inline unsigned valueMismatch(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const {
+      return constructionStrategy.decodeLeaf(leafValue).valueMismatch(key, from, to);
+    }
+
+    StringDictionary() : index(ConstructHelper<TIdIndex<uint64_t>>::create(this)), reverseIndex(ConstructHelper<TStringIndex<std::string>>::create(this)), constructionStrategy(TConstructionStrategy<TIdIndex<uint64_t>,  TStringIndex<std::string>, TLeaf>(index, reverseIndex, arena)) {
       TLeaf::counter = 0;
     }
 
@@ -88,11 +152,12 @@ class StringDictionary : public Dictionary, public LeafStore {
 #ifdef DEBUG
     void debug() const {
       std::cout << "Debug dict" << std::endl;
-      const_cast<StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy>*>(this)->reverseIndex.debug();
+      const_cast<StringDictionary<TIdIndex, TStringIndex, TLeaf, TConstructionStrategy, TFilter>*>(this)->reverseIndex.debug();
     }
 #endif
 
     void bulkInsert(size_t size, std::string* values);
+    void bulkInsert(ExternalSorter& values, size_t chunkSize);
     uint64_t insert(std::string value);
     bool lookup(std::string value, uint64_t& id) const;
     bool lookup(uint64_t id, std::string& value) const;
@@ -1,33 +1,30 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <vector>
-#include "TurtleParser.hpp"
-#include "Dictionaries.hpp"
+#include <thread>
+#include "LoadPipeline.hpp"
+#include "StringDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
 
 /**
  * @file
  * Load data from a turtle file into a string dictionary
+ * and encode the triples as ID triples.
  *
- * Allows for different string dictionary implementations
- * and pauses after loading to allow for memory usage
- * measurements.
+ * Allows for different string dictionary implementations.
+ * The ID triples are written as three 64-bit IDs
+ * (subject, predicate, object) per triple.
  */
 
 static constexpr const char* typeStrings[] = {
-  "dummy",
-  "uncompressed",
-  "simple",
-  "art",
-  "hash-art",
-  "btree",
-  "b+tree",
-  "hat",
-//  "c-art",
+  "bottom-up",
+  "single-uncompressed",
+  "slotted",
 };
 
 inline int usageMessage(const char* argv0) {
-  std::cerr << "Usage: " << argv0 << " [dictionary implementation] [turtle file]" << std::endl;
+  std::cerr << "Usage: " << argv0 << " [dictionary implementation] [turtle file] [triple file]" << std::endl;
   std::cerr << std::endl;
   std::cerr << "Available dictionary implementations:" << std::endl;
   for (auto type : typeStrings) {
@@ -37,21 +34,15 @@ inline int usageMessage(const char* argv0) {
 }
 
 inline Dictionary* getDictionary(std::string name) {
-  if (name == typeStrings[0]) return new DummyDictionary();
-  if (name == typeStrings[1]) return new UncompressedDictionary();
-  if (name == typeStrings[2]) return new SimpleDictionary();
-  if (name == typeStrings[3]) return new ARTDictionary();
-  if (name == typeStrings[4]) return new HashARTDictionary();
-  if (name == typeStrings[5]) return new BTreeDictionary();
-  if (name == typeStrings[6]) return new BPlusTreeDictionary();
-  if (name == typeStrings[7]) return new HATDictionary();
-  // if (name == typeStrings[8]) return new ARTcDictionary();
+  if (name == typeStrings[0]) return new StringDictionary<ART, SART, BottomUpPage<(1024<<4)>, BottomUpStrategy>();
+  if (name == typeStrings[1]) return new StringDictionary<ART, HAT, SingleUncompressedPage<(1024<<4)>>();
+  if (name == typeStrings[2]) return new StringDictionary<ART, HAT, SlottedPage<(1024<<4)>, IndirectStrategy>();
 
   return nullptr;
 }
 
 int main(int argc, const char** argv) {
-  if (argc != 3) {
+  if (argc != 4) {
     return usageMessage(argv[0]);
   }
 
@@ -64,20 +55,36 @@ int main(int argc, const char** argv) {
   // Verify that file name is valid
   std::ifstream file(argv[2]);
   if (!file.good()) {
+    delete dict;
     return usageMessage(argv[0]);
   }
 
   std::cout << "Reading Turtle data from '" << argv[2] << "' into " << argv[1] << " dictionary." << std::endl;
 
-  TurtleParser parser(file);
-  parser.loadInto(dict);
+  // Leave one core each for parsing and writing
+  unsigned numberOfCores = std::thread::hardware_concurrency();
+  LoadPipeline pipeline(dict, numberOfCores > 3 ? numberOfCores - 2 : 1);
+  LoadPipeline::Statistics statistics;
+  try {
+    statistics = pipeline.run(file, argv[3]);
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    delete dict;
+    return 1;
+  }
   file.close();
 
+  std::cout << "Triples: " << statistics.triples << std::endl;
+  std::cout << "Distinct terms: " << statistics.terms << std::endl;
+  std::cout << "Term cache hits: " << statistics.cacheHits << std::endl;
+  std::cout << "Parse errors: " << statistics.parseErrors << std::endl;
+  std::cout << "Sort runs: " << statistics.sortRuns << std::endl;
+  std::cout << "Leaves: " << dict->numberOfLeaves() << std::endl;
+
   delete dict;
 
-  std::cout << "Done." << std::endl;
-  std::cout << "Press Enter to exit...";
-  std::cin.get();
+  std::cout << "Done. ID triples written to '" << argv[3] << "'." << std::endl;
 
   return 0;
 }
@@ -1,6 +1,9 @@
 src_sources = Exception.cpp TurtleParser.cpp Dictionary.cpp \
 							ARTBase.cpp PerformanceTestRunner.cpp LeafStore.cpp \
 							ART.cpp HAT.cpp B+Tree.cpp BTree.cpp Hash.cpp \
-							RedBlack.cpp SART.cpp SimpleDictionary.cpp
-src_executables = perftest microtest indeptest
+							RedBlack.cpp SART.cpp SimpleDictionary.cpp NodeArena.cpp NodeSearch.cpp \
+							DenseIndex.cpp FrozenART.cpp FingerprintART.cpp FingerprintHash.cpp PerfectHash.cpp BloomFilter.cpp \
+							ExternalSorter.cpp ConcurrentEncoder.cpp LoadPipeline.cpp
+src_executables = perftest microtest indeptest load
 src_libraries = btree b+tree boost hat
+src_ldflags = -pthread
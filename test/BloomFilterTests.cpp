@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "BloomFilter.hpp"
+#include "StringDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(BloomFilter, MayContain) {
+  BloomFilter filter;
+  for (uint64_t i = 0; i < 100000; i++) {
+    filter.insert("http://example.org/" + to_string(i));
+  }
+  ASSERT_TRUE(filter.mayContain("missing"));
+  filter.freeze();
+  ASSERT_TRUE(filter.isFrozen());
+  ASSERT_LE(filter.size(), 100000u * 10 / 8 + 32);
+
+  // No false negatives
+  for (uint64_t i = 0; i < 100000; i++) {
+    ASSERT_TRUE(filter.mayContain("http://example.org/" + to_string(i)));
+  }
+
+  // About 1% false positives at 10 bits per value
+  uint64_t falsePositives = 0;
+  for (uint64_t i = 100000; i < 200000; i++) {
+    falsePositives += filter.mayContain("http://example.org/" + to_string(i));
+  }
+  ASSERT_LT(falsePositives, 2000u);
+}
+
+TEST(BloomFilter, Empty) {
+  BloomFilter filter;
+  filter.freeze();
+  ASSERT_FALSE(filter.mayContain(""));
+  ASSERT_FALSE(filter.mayContain("value"));
+}
+
+TEST(BloomFilter, Dictionary) {
+  StringDictionary<ART, HAT, SlottedPage<48>, IndirectStrategy, BloomFilter> dict;
+  vector<string> values;
+  for (uint64_t i = 0; i < 5000; i++) {
+    values.push_back("value" + to_string(i * 7));
+  }
+  dict.bulkInsert(values.size(), values.data());
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i + 1, id);
+    ASSERT_FALSE(dict.lookup(values[i] + "x", id));
+  }
+}
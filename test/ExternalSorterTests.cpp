@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+#include "ExternalSorter.hpp"
+#include "StringDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(ExternalSorter, InMemory) {
+  ExternalSorter sorter(1 << 20);
+  sorter.add("c");
+  sorter.add("a");
+  sorter.add("b");
+  sorter.add("a");
+
+  vector<string> sorted;
+  string value;
+  while (sorter.next(value)) {
+    sorted.push_back(value);
+  }
+
+  ASSERT_EQ(0, sorter.numberOfRuns());
+  ASSERT_EQ((vector<string> { "a", "b", "c" }), sorted);
+}
+
+TEST(ExternalSorter, MergeRuns) {
+  // Budget fits only a few values, so every couple of values is spilled
+  ExternalSorter sorter(3 * ExternalSorter::entryOverhead);
+
+  vector<string> values;
+  for (uint64_t i = 0; i < 100; i++) {
+    values.push_back("value" + to_string(i * 7919 % 100));
+  }
+  // Duplicates across runs
+  for (uint64_t i = 0; i < 100; i += 3) {
+    values.push_back("value" + to_string(i));
+  }
+  values.push_back("");
+
+  for (const auto& value : values) {
+    sorter.add(value);
+  }
+
+  vector<string> sorted;
+  string value;
+  while (sorter.next(value)) {
+    sorted.push_back(value);
+  }
+
+  sort(values.begin(), values.end());
+  values.erase(unique(values.begin(), values.end()), values.end());
+
+  ASSERT_LT(1, sorter.numberOfRuns());
+  ASSERT_EQ(values, sorted);
+}
+
+TEST(ExternalSorter, AddAfterFinish) {
+  ExternalSorter sorter(1 << 20);
+  sorter.finish();
+  ASSERT_THROW(sorter.add("a"), Exception);
+}
+
+TEST(ExternalSorter, ChunkedBulkInsert) {
+  vector<string> values {
+    "aabc",
+    "aabd",
+    "baa",
+    "bba",
+    "ccc",
+    "d",
+    "db",
+  };
+  vector<pair<uint64_t, string>> lookupValues;
+
+  ExternalSorter sorter(2 * ExternalSorter::entryOverhead);
+  for (auto it = values.rbegin(); it != values.rend(); ++it) {
+    sorter.add(*it);
+  }
+
+  StringDictionary<ART, HAT, SlottedPage<48>, IndirectStrategy> dict;
+  dict.bulkInsert(sorter, 3);
+
+  ASSERT_EQ(values.size(), dict.size());
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  auto callback = [&](uint64_t id, string value) {
+    lookupValues.push_back(make_pair(id, value));
+  };
+
+  // Range spans the boundary between the first and second chunk
+  dict.rangeLookup("b", callback);
+  ASSERT_EQ(2, lookupValues.size());
+  ASSERT_EQ("baa", lookupValues.front().second);
+  ASSERT_EQ("bba", lookupValues.back().second);
+}
+
+TEST(ExternalSorter, ChunkedBulkInsertBottomUp) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 200; i++) {
+    values.push_back("http://example.org/resource" + to_string(1000 + i));
+  }
+
+  ExternalSorter sorter(16 * ExternalSorter::entryOverhead);
+  for (const auto& value : values) {
+    sorter.add(value);
+  }
+
+  StringDictionary<ART, SART, BottomUpPage<256>, BottomUpStrategy> dict;
+  dict.bulkInsert(sorter, 7);
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+}
+
+TEST(ExternalSorter, ChunkedBulkInsertMatchesBulkInsert) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 300; i++) {
+    values.push_back(string(1, static_cast<char>('a' + i / 40)) + "/resource" + to_string(1000 + i * 7));
+  }
+
+  StringDictionary<ART, SART, BottomUpPage<256>, BottomUpStrategy> single;
+  single.bulkInsert(values.size(), values.data());
+  uint64_t pages = single.arena.size();
+
+  ExternalSorter sorter(16 * ExternalSorter::entryOverhead);
+  for (const auto& value : values) {
+    sorter.add(value);
+  }
+
+  StringDictionary<ART, SART, BottomUpPage<256>, BottomUpStrategy> chunked;
+  chunked.bulkInsert(sorter, 5);
+
+  // Chunks continue the open page, so the pages are the same
+  ASSERT_EQ(pages, chunked.arena.size());
+  for (uint64_t number = 1; number <= pages; number++) {
+    ASSERT_EQ(0, memcmp(single.arena.get(number)->data, chunked.arena.get(number)->data, BottomUpPage<256>::size));
+  }
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t id;
+    ASSERT_TRUE(chunked.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+
+    string value;
+    ASSERT_TRUE(chunked.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+  }
+}
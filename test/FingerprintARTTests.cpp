@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+#include "FingerprintART.hpp"
+#include "Exception.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+  class CountingLeafStore : public LeafStore {
+    private:
+      const vector<string>& values;
+    public:
+      mutable uint64_t loads;
+      CountingLeafStore(const vector<string>& values) : values(values), loads(0) { }
+      string getValue(uint64_t leafValue) const { loads++; return values[leafValue]; }
+      uint64_t getId(uint64_t leafValue) const { loads++; return leafValue * 3; }
+  };
+
+  // Not a LeafStore, so it can only be called statically
+  class StaticLeafStore {
+    private:
+      const vector<string>& values;
+    public:
+      mutable uint64_t loads;
+      StaticLeafStore(const vector<string>& values) : values(values), loads(0) { }
+      string getValue(uint64_t leafValue) const { loads++; return values[leafValue]; }
+      uint64_t getId(uint64_t leafValue) const { loads++; return leafValue * 3; }
+      unsigned valueMismatch(uint64_t leafValue, const uint8_t* key, unsigned from, unsigned to) const {
+        loads++;
+        const string& value = values[leafValue];
+        unsigned pos;
+        for (pos = from; pos < to; pos++) {
+          uint8_t byte = pos < value.size() ? static_cast<uint8_t>(value[pos]) : 0;
+          if (byte != key[pos]) {
+            break;
+          }
+        }
+        return pos;
+      }
+  };
+}
+
+TEST(FingerprintART, Lookup) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 20000; i++) {
+    values.push_back("http://example.org/resource/" + to_string(i));
+  }
+  CountingLeafStore store(values);
+
+  FingerprintART<string> index(&store);
+  FingerprintART<uint64_t> idIndex(&store);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    index.insert(values[i], i);
+    idIndex.insert(i * 3, i);
+  }
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t value;
+    ASSERT_TRUE(index.lookup(values[i], value));
+    ASSERT_EQ(i, value);
+    ASSERT_TRUE(idIndex.lookup(i * 3, value));
+    ASSERT_EQ(i, value);
+  }
+
+  auto range = index.rangeLookup("http://example.org/resource/");
+  ASSERT_EQ(0u, range.first);
+  ASSERT_EQ(9999u, range.second);
+  ASSERT_THROW(idIndex.rangeLookup(3), Exception);
+}
+
+TEST(FingerprintART, RejectsWithoutLoading) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 20000; i++) {
+    values.push_back("http://example.org/resource/" + to_string(i));
+  }
+  CountingLeafStore store(values);
+  CountingLeafStore artStore(values);
+
+  FingerprintART<string> index(&store);
+  ART<string> art(&artStore);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    index.insert(values[i], i);
+    art.insert(values[i], i);
+  }
+
+  // The mismatch is in the long root prefix, which lookups skip
+  store.loads = 0;
+  artStore.loads = 0;
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t value;
+    string missing = "http://example.org/RESOURCE/" + to_string(i);
+    ASSERT_FALSE(index.lookup(missing, value));
+    ASSERT_FALSE(art.lookup(missing, value));
+  }
+  ASSERT_EQ(values.size(), artStore.loads);
+  ASSERT_LT(store.loads, values.size() / 100);
+}
+
+TEST(FingerprintART, LookupWithStore) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 2000; i++) {
+    values.push_back("http://example.org/resource/" + to_string(i));
+  }
+  CountingLeafStore store(values);
+  StaticLeafStore staticStore(values);
+
+  ART<string> art(&store);
+  FingerprintART<string> index(&store);
+  FingerprintART<uint64_t> idIndex(&store);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    art.insert(values[i], i);
+    index.insert(values[i], i);
+    idIndex.insert(i * 3, i);
+  }
+
+  store.loads = 0;
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t value;
+    ASSERT_TRUE(art.lookup(values[i], value, staticStore));
+    ASSERT_EQ(i, value);
+    ASSERT_TRUE(index.lookup(values[i], value, staticStore));
+    ASSERT_EQ(i, value);
+    ASSERT_TRUE(idIndex.lookup(i * 3, value, staticStore));
+    ASSERT_EQ(i, value);
+    ASSERT_FALSE(art.lookup("http://example.org/RESOURCE/" + to_string(i), value, staticStore));
+    ASSERT_FALSE(idIndex.lookup(i * 3 + 1, value, staticStore));
+  }
+  ASSERT_EQ(0u, store.loads);
+  ASSERT_LT(0u, staticStore.loads);
+}
+
+TEST(FingerprintART, LargeLeafValue) {
+  vector<string> values;
+  CountingLeafStore store(values);
+  FingerprintART<string> index(&store);
+  ASSERT_THROW(index.insert("value", 1ull << 47), Exception);
+}
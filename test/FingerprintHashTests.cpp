@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "FingerprintHash.hpp"
+#include "StringDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+  class VectorLeafStore : public LeafStore {
+    private:
+      const vector<string>& values;
+    public:
+      VectorLeafStore(const vector<string>& values) : values(values) { }
+      string getValue(uint64_t leafValue) const { return values[leafValue]; }
+      uint64_t getId(uint64_t leafValue) const { return leafValue * 3; }
+  };
+}
+
+TEST(FingerprintHash, Lookup) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 50000; i++) {
+    values.push_back("http://example.org/" + to_string(i));
+  }
+  VectorLeafStore store(values);
+
+  // Grows several times, re-hashing the values from the leaf store
+  FingerprintHash<string> index(&store);
+  FingerprintHash<uint64_t> idIndex(&store);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    index.insert(values[i], i);
+    idIndex.insert(i * 3, i);
+  }
+  ASSERT_LT(index.tableSize(), values.size() * 10);
+  ASSERT_THROW(index.insert("value", 1ull << 32), Exception);
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t value;
+    ASSERT_TRUE(index.lookup(values[i], value));
+    ASSERT_EQ(i, value);
+    ASSERT_TRUE(idIndex.lookup(i * 3, value));
+    ASSERT_EQ(i, value);
+  }
+
+  uint64_t value;
+  ASSERT_FALSE(index.lookup("http://example.org/", value));
+  ASSERT_FALSE(index.lookup("http://example.org/1234567", value));
+  ASSERT_FALSE(index.lookup("", value));
+  ASSERT_FALSE(idIndex.lookup(1, value));
+  ASSERT_THROW(index.rangeLookup("http://"), Exception);
+}
+
+TEST(FingerprintHash, StringIndex) {
+  StringDictionary<ART, FingerprintHash, SlottedPage<48>, IndirectStrategy> dict;
+  vector<string> values;
+  for (uint64_t i = 0; i < 5000; i++) {
+    values.push_back("value" + to_string(i * 7));
+  }
+  dict.bulkInsert(values.size(), values.data());
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    string value;
+    ASSERT_TRUE(dict.lookup(id, value));
+    ASSERT_EQ(values[i], value);
+  }
+  uint64_t id;
+  ASSERT_FALSE(dict.lookup("value1", id));
+}
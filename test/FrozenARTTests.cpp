@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "FrozenART.hpp"
+#include "Exception.hpp"
+#include "StringDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+  class VectorLeafStore : public LeafStore {
+    private:
+      const vector<string>& values;
+    public:
+      VectorLeafStore(const vector<string>& values) : values(values) { }
+      string getValue(uint64_t leafValue) const { return values[leafValue]; }
+      uint64_t getId(uint64_t leafValue) const { return leafValue; }
+  };
+}
+
+TEST(FrozenART, LookupAndSave) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 2000; i++) {
+    // Long shared prefixes, and dense nodes below "item"
+    values.push_back("http://example.org/resource/with/a/long/prefix/" + to_string(i * 7));
+    values.push_back("item" + string(1, static_cast<char>(i % 200 + 32)) + to_string(i));
+  }
+  VectorLeafStore store(values);
+
+  FrozenART<string> index(&store);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    index.insert(values[i], i);
+  }
+  index.freeze();
+  ASSERT_TRUE(index.isFrozen());
+  ASSERT_THROW(index.insert("x", 0), Exception);
+
+  stringstream stream;
+  index.save(stream);
+  FrozenART<string> loaded(&store);
+  loaded.load(stream);
+
+  string saved = stream.str();
+  vector<uint64_t> buffer(saved.size() / sizeof(uint64_t) + 1);
+  memcpy(buffer.data(), saved.data(), saved.size());
+  FrozenART<string> attached(&store);
+  attached.attach(buffer.data(), saved.size());
+
+  for (const FrozenART<string>* frozen : { &index, &loaded, &attached }) {
+    for (uint64_t i = 0; i < values.size(); i++) {
+      uintptr_t value;
+      ASSERT_TRUE(frozen->lookup(values[i], value));
+      ASSERT_EQ(i, value);
+    }
+    uintptr_t value;
+    ASSERT_FALSE(frozen->lookup("http://example.org/resource/with/a/long/prefix/1", value));
+    ASSERT_FALSE(frozen->lookup("http://example.org/resource/with/a/long/prefix/", value));
+    ASSERT_FALSE(frozen->lookup("", value));
+
+    auto range = frozen->rangeLookup("http://example.org/resource/with/a/long/prefix/1");
+    ASSERT_EQ("http://example.org/resource/with/a/long/prefix/10003", values[range.first]);
+    ASSERT_EQ("http://example.org/resource/with/a/long/prefix/1995", values[range.second]);
+    ASSERT_EQ(0, frozen->rangeLookup("http://example.org/x").first);
+  }
+}
+
+TEST(FrozenART, SplitPrefixOfLongerKey) {
+  // Inserting the short key splits a compressed path, whose remaining prefix
+  // is read from the longer keys below it
+  vector<string> values {
+    "<http://xmlns.com/foaf/0.1/ztrmhtr>0",
+    "<http://xmlns.com/foaf/0.1/ztrmhtr>1",
+    "<http://xmlns.com/foaf/0.1/ztrt>1"
+  };
+  VectorLeafStore store(values);
+
+  FrozenART<string> index(&store);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    index.insert(values[i], i);
+  }
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uintptr_t value;
+    ASSERT_TRUE(index.lookup(values[i], value));
+    ASSERT_EQ(i, value);
+  }
+
+  index.freeze();
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uintptr_t value;
+    ASSERT_TRUE(index.lookup(values[i], value));
+    ASSERT_EQ(i, value);
+  }
+}
+
+TEST(FrozenART, Ids) {
+  vector<string> values;
+  VectorLeafStore store(values);
+
+  FrozenART<uint64_t> index(&store);
+  for (uint64_t i = 1; i < 100000; i += 3) {
+    index.insert(i, i);
+  }
+  index.freeze();
+
+  for (uint64_t i = 1; i < 100000; i++) {
+    uintptr_t value;
+    ASSERT_EQ(i % 3 == 1, index.lookup(i, value));
+    if (i % 3 == 1) {
+      ASSERT_EQ(i, value);
+    }
+  }
+  ASSERT_THROW(index.rangeLookup(1), Exception);
+}
+
+TEST(FrozenART, StringDictionary) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 500; i++) {
+    values.push_back("http://example.org/" + to_string(1000 + i));
+  }
+
+  StringDictionary<FrozenART, FrozenART, SlottedPage<256>, IndirectStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  vector<string> rangeValues;
+  dict.rangeLookup("http://example.org/11", [&](uint64_t, string value) {
+    rangeValues.push_back(value);
+  });
+  ASSERT_EQ(100, rangeValues.size());
+  ASSERT_EQ("http://example.org/1100", rangeValues.front());
+  ASSERT_EQ("http://example.org/1199", rangeValues.back());
+}
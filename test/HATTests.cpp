@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include "Indexes.hpp"
+#include "ahtable.h"
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(HAT, RangeLookup) {
+  // Enough keys to burst buckets into pure and hybrid buckets below the trie
+  set<string> keys;
+  for (uint64_t i = 0; i < 60000; i++) {
+    keys.insert("http://example.org/" + to_string(i % 7) + "/" + to_string(i * 13));
+    keys.insert(string(1, static_cast<char>(i % 250 + 1)) + to_string(i % 300));
+  }
+  keys.insert("http://example.org/1");
+
+  // Values are the ranks, so range endpoints are known from the sorted keys
+  vector<string> sorted(keys.begin(), keys.end());
+  HAT<string> index;
+  for (uint64_t i = 0; i < sorted.size(); i++) {
+    index.insert(sorted[i], i + 1);
+  }
+
+  const vector<string> prefixes { "", "h", "http://example.org/", "http://example.org/1",
+    "http://example.org/3/1", "http://example.org/6/77", "\xFA", "a", "a1", "a12", "a123" };
+  for (const string& prefix : prefixes) {
+    uint64_t start = 0, end = 0;
+    for (uint64_t i = static_cast<uint64_t>(lower_bound(sorted.begin(), sorted.end(), prefix) - sorted.begin()); i < sorted.size() && sorted[i].compare(0, prefix.size(), prefix) == 0; i++) {
+      end = i + 1;
+      if (start == 0) {
+        start = end;
+      }
+    }
+    ASSERT_EQ(make_pair(start, end), index.rangeLookup(prefix)) << prefix;
+  }
+
+  ASSERT_EQ(make_pair(0ul, 0ul), index.rangeLookup("http://example.org/9"));
+  ASSERT_EQ(make_pair(0ul, 0ul), index.rangeLookup("a1234"));
+}
+
+TEST(HAT, BucketRangeAfterDelete) {
+  // The bucket keeps its smallest and largest key up to date, also when
+  // resizing or deleting moves them
+  ahtable_t* table = ahtable_create();
+  set<string> keys;
+  for (uint64_t i = 0; i < 2000; i++) {
+    string key = to_string(i * 7919 % 2003);
+    *ahtable_get(table, key.c_str(), key.size(), nullptr) = i * 7919 % 2003;
+    keys.insert(key);
+  }
+
+  value_t* min;
+  value_t* max;
+  while (keys.size() > 1) {
+    ASSERT_TRUE(ahtable_prefix_range(table, nullptr, 0, &min, &max));
+    ASSERT_EQ(stoull(*keys.begin()), *min);
+    ASSERT_EQ(stoull(*keys.rbegin()), *max);
+
+    // Alternate between the smallest, the largest and another key
+    auto it = keys.size() % 3 == 0 ? keys.begin() : keys.size() % 3 == 1 ? prev(keys.end()) : next(keys.begin(), keys.size() / 2);
+    ASSERT_EQ(0, ahtable_del(table, it->c_str(), it->size()));
+    keys.erase(it);
+  }
+
+  const string& last = *keys.begin();
+  ASSERT_EQ(0, ahtable_del(table, last.c_str(), last.size()));
+  ASSERT_FALSE(ahtable_prefix_range(table, nullptr, 0, &min, &max));
+  ahtable_free(table);
+}
+
+namespace {
+  void assertBucket(ahtable_t* table, const vector<string>& keys, const vector<bool>& stored, uint64_t offset) {
+    for (uint64_t i = 0; i < keys.size(); i++) {
+      value_t* value = ahtable_tryget(table, keys[i].c_str(), keys[i].size());
+      if (stored[i]) {
+        ASSERT_NE(nullptr, value) << keys[i];
+        ASSERT_EQ(i + offset, *value) << keys[i];
+      }
+      else {
+        ASSERT_EQ(nullptr, value) << keys[i];
+      }
+    }
+  }
+}
+
+TEST(HAT, BucketTags) {
+  // All keys share one slot, so its tags fill many blocks and collide;
+  // short, long and two byte length keys take different hash paths
+  ahtable_t* table = ahtable_create_n(1);
+  vector<string> keys;
+  for (uint64_t i = 0; i < 600; i++) {
+    if (i % 3 == 0) {
+      keys.push_back(to_string(i));
+    }
+    else if (i % 3 == 1) {
+      keys.push_back("http://example.org/" + to_string(i));
+    }
+    else {
+      keys.push_back(string(130 + i % 5, 'x') + to_string(i));
+    }
+  }
+  vector<bool> stored(keys.size(), false);
+
+  for (uint64_t i = 0; i < keys.size(); i++) {
+    bool inserted;
+    *ahtable_get(table, keys[i].c_str(), keys[i].size(), &inserted) = i;
+    ASSERT_TRUE(inserted);
+    stored[i] = true;
+
+    // Around the ends of the first tag blocks
+    if (i < 50 && (i + 2) % 16 <= 2) {
+      assertBucket(table, keys, stored, 0);
+    }
+  }
+  assertBucket(table, keys, stored, 0);
+  ASSERT_EQ(keys.size(), table->slot_counts[0]);
+  set<unsigned char> tags(table->slots[0], table->slots[0] + table->slot_counts[0]);
+  ASSERT_LT(tags.size(), keys.size());
+
+  // Deleting moves the tags behind the key and frees blocks
+  for (uint64_t i = 0; i < keys.size(); i += 2) {
+    ASSERT_EQ(0, ahtable_del(table, keys[i].c_str(), keys[i].size()));
+    ASSERT_EQ(-1, ahtable_del(table, keys[i].c_str(), keys[i].size()));
+    stored[i] = false;
+  }
+  assertBucket(table, keys, stored, 0);
+  for (uint64_t i = 1; ahtable_size(table) > 15; i += 2) {
+    ASSERT_EQ(0, ahtable_del(table, keys[i].c_str(), keys[i].size()));
+    stored[i] = false;
+    if (ahtable_size(table) <= 17) {
+      assertBucket(table, keys, stored, 0);
+    }
+  }
+
+  // Reinserted keys take the freed tags
+  for (uint64_t i = 0; i < keys.size(); i++) {
+    bool inserted;
+    *ahtable_get(table, keys[i].c_str(), keys[i].size(), &inserted) = i + keys.size();
+    ASSERT_EQ(!stored[i], inserted);
+    stored[i] = true;
+  }
+  assertBucket(table, keys, stored, keys.size());
+  ASSERT_EQ(keys.size(), ahtable_size(table));
+  ahtable_free(table);
+}
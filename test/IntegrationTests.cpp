@@ -1,8 +1,14 @@
 #include "gtest/gtest.h"
 #include "StringDictionary.hpp"
+#include "NamespaceDictionary.hpp"
+#include "InlineIdDictionary.hpp"
+#include "PartitionedDictionary.hpp"
 #include "ConstructionStrategies.hpp"
 #include "Indexes.hpp"
 #include "Pages.hpp"
+#include <algorithm>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -226,3 +232,561 @@ TEST(Integration, BottomUpStrategy) {
     ASSERT_EQ(i+1, id);
   }
 }
+
+TEST(Integration, PaxPage) {
+  std::vector<std::string> values;
+  for (uint64_t i = 0; i < 2000; i++) {
+    values.push_back("http://example.org/" + std::to_string(100 + i / 100) + "/" + std::to_string(1000 + i));
+  }
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+
+  StringDictionary<ART, SART, PaxPage<512>, BottomUpStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  auto callback = [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  };
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+  }
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+    ASSERT_FALSE(dict.lookup(values[i] + "/", id));
+  }
+
+  // SART only resolves prefixes down to the first branching node
+  dict.rangeLookup("http://example.org/", callback);
+  ASSERT_EQ(values.size(), lookupValues.size());
+  for (uint64_t i = 0; i < values.size(); i++) {
+    ASSERT_EQ(i+1, lookupValues[i].first);
+    ASSERT_EQ(values[i], lookupValues[i].second);
+  }
+}
+
+TEST(Integration, DenseIndex) {
+  std::vector<std::string> values {
+    "aabc",
+    "aabd",
+    "baa",
+    "bba",
+    "ccc",
+    "d",
+    "db",
+  };
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+
+  StringDictionary<DenseIndex, HAT, SlottedPage<48>, IndirectStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  auto callback = [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  };
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+  }
+
+  std::string value;
+  ASSERT_FALSE(dict.lookup(values.size()+1, value));
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  lookupValues.clear();
+  dict.rangeLookup("b", callback);
+  ASSERT_EQ(2, lookupValues.size());
+  ASSERT_EQ("baa", lookupValues.front().second);
+  ASSERT_EQ("bba", lookupValues.back().second);
+}
+
+TEST(Integration, ImplicitIdPage) {
+  std::vector<std::string> values {
+    "aabc",
+    "aabd",
+    "baa",
+    "bba",
+    "ccc",
+    "d",
+    "db",
+  };
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+
+  StringDictionary<ART, HAT, ImplicitIdPage<32>, IndirectStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  auto callback = [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  };
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  dict.rangeLookup("b", callback);
+  ASSERT_EQ(2, lookupValues.size());
+  ASSERT_EQ(std::make_pair(3ul, std::string("baa")), lookupValues.front());
+  ASSERT_EQ(std::make_pair(4ul, std::string("bba")), lookupValues.back());
+}
+
+TEST(Integration, PackedLayout) {
+  std::vector<std::string> values;
+  for (uint64_t i = 0; i < 2000; i++) {
+    values.push_back("http://example.org/" + std::to_string(10000 + i) + (i % 5 == 0 ? std::string(100, 'x') : ""));
+  }
+
+  StringDictionary<ART, HAT, ImplicitIdPage<1024, page::PackedLayout>, IndirectStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+  dict.rangeLookup("http://example.org/115", [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  });
+  ASSERT_EQ(100, lookupValues.size());
+  ASSERT_EQ(1501u, lookupValues.front().first);
+  ASSERT_EQ(1600u, lookupValues.back().first);
+}
+
+TEST(Integration, RestartPage) {
+  std::vector<std::string> values;
+  for (uint64_t i = 0; i < 2000; i++) {
+    values.push_back("http://example.org/" + std::to_string(100 + i / 100) + "/" + std::to_string(1000 + i));
+  }
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+
+  StringDictionary<ART, HAT, RestartPage<1024, 4>, DeltaStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  auto callback = [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  };
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  dict.rangeLookup("http://example.org/115/", callback);
+  ASSERT_EQ(100, lookupValues.size());
+  ASSERT_EQ(1501, lookupValues.front().first);
+  ASSERT_EQ(1600, lookupValues.back().first);
+}
+
+TEST(Integration, Overflow) {
+  std::vector<std::string> values;
+  for (uint64_t i = 0; i < 500; i++) {
+    values.push_back("http://example.org/" + std::to_string(10000 + i) + (i % 50 == 0 ? std::string(100000, 'x') : ""));
+  }
+
+  StringDictionary<ART, FingerprintART, RestartPage<1024>, IndirectStrategy> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  uint64_t id;
+  ASSERT_FALSE(dict.lookup(values[0] + "x", id));
+}
+
+/**
+ * Bulk loads values of which some are longer than a page, and looks all of
+ * them up.
+ */
+template<class TDictionary>
+static void checkOverflow() {
+  std::vector<std::string> values;
+  for (uint64_t i = 0; i < 300; i++) {
+    values.push_back("http://example.org/" + std::to_string(10000 + i) + (i % 30 == 0 ? std::string(1000 + i, 'x') : ""));
+  }
+
+  TDictionary dict;
+  dict.bulkInsert(values.size(), &values[0]);
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(dict.lookup(i+1, value));
+    ASSERT_EQ(values[i], value);
+
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    ASSERT_EQ(i+1, id);
+  }
+
+  uint64_t id;
+  ASSERT_FALSE(dict.lookup(values[0] + "x", id));
+  ASSERT_FALSE(dict.lookup(values[0].substr(0, 600), id));
+}
+
+TEST(Integration, OverflowSlottedPage) {
+  checkOverflow<StringDictionary<ART, HAT, SlottedPage<256>, IndirectStrategy>>();
+  checkOverflow<StringDictionary<ART, HAT, SlottedPage<256, page::PackedLayout>, IndirectStrategy>>();
+}
+
+TEST(Integration, OverflowBottomUpPage) {
+  checkOverflow<StringDictionary<ART, SART, BottomUpPage<256>, BottomUpStrategy>>();
+}
+
+TEST(Integration, OverflowSingleUncompressedPage) {
+  checkOverflow<StringDictionary<ART, HAT, SingleUncompressedPage<256>>>();
+}
+
+TEST(Integration, OverflowImplicitIdPage) {
+  checkOverflow<StringDictionary<ART, HAT, ImplicitIdPage<256>, IndirectStrategy>>();
+  checkOverflow<StringDictionary<ART, HAT, ImplicitIdPage<256, page::PackedLayout>, IndirectStrategy>>();
+}
+
+TEST(Integration, OverflowPaxPage) {
+  checkOverflow<StringDictionary<ART, SART, PaxPage<256>, BottomUpStrategy>>();
+}
+
+TEST(Integration, OverflowRestartPage) {
+  checkOverflow<StringDictionary<ART, HAT, RestartPage<256, 4>, DeltaStrategy>>();
+}
+
+TEST(Integration, CantFitOnPage) {
+  // Too small even for a reference to a value in the blob store
+  std::vector<std::string> values { "a", std::string(100, 'b') };
+
+  StringDictionary<ART, SART, BottomUpPage<16>, BottomUpStrategy> dict;
+  ASSERT_THROW(dict.bulkInsert(values.size(), &values[0]), Exception);
+}
+
+TEST(Integration, NamespaceDictionary) {
+  std::vector<std::string> values;
+  for (uint64_t i = 0; i < 500; i++) {
+    values.push_back("http://example.org/resource/" + std::to_string(1000 + i));
+    values.push_back("http://example.org/" + std::to_string(1000 + i));
+  }
+  for (uint64_t i = 0; i < 20; i++) {
+    values.push_back("http://www.w3.org/1999/02/22-rdf-syntax-ns#type" + std::to_string(i));
+  }
+  // Without a namespace, and with one used only once
+  values.push_back("literal value");
+  values.push_back("http://example.com/single");
+  std::sort(values.begin(), values.end());
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+
+  NamespaceDictionary<StringDictionary<ART, HAT, SingleUncompressedPage<256>>> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+  ASSERT_EQ(values.size(), dict.size());
+  // The empty namespace and three shared ones
+  ASSERT_EQ(4u, dict.numberOfNamespaces());
+
+  auto callback = [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  };
+
+  std::set<uint64_t> ids;
+  for (const auto& value : values) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(value, id));
+    ids.insert(id);
+
+    std::string idValue;
+    ASSERT_TRUE(dict.lookup(id, idValue));
+    ASSERT_EQ(value, idValue);
+  }
+  ASSERT_EQ(values.size(), ids.size());
+
+  uint64_t id;
+  ASSERT_FALSE(dict.lookup("http://example.org/resource/", id));
+  ASSERT_FALSE(dict.lookup("http://example.org/resource/1000x", id));
+  ASSERT_FALSE(dict.lookup("http://example.net/resource/1000", id));
+
+  // Prefix of namespaces
+  dict.rangeLookup("http://example.", callback);
+  ASSERT_EQ(1001, lookupValues.size());
+
+  // Prefix within the local names of a namespace
+  lookupValues.clear();
+  dict.rangeLookup("http://example.org/resource/11", callback);
+  ASSERT_EQ(100, lookupValues.size());
+  for (const auto& pair : lookupValues) {
+    ASSERT_EQ(0, pair.second.compare(0, 30, "http://example.org/resource/11"));
+  }
+
+  lookupValues.clear();
+  dict.rangeLookup("http://www.w3.org/1999/02/22-rdf-syntax-ns#type1", callback);
+  ASSERT_EQ(11, lookupValues.size());
+
+  // Without a namespace
+  lookupValues.clear();
+  dict.rangeLookup("lit", callback);
+  ASSERT_EQ(1, lookupValues.size());
+  ASSERT_EQ("literal value", lookupValues.front().second);
+}
+
+namespace {
+  /**
+   * Dictionary that accepts any number of bulk loads, numbering values in
+   * the order they arrive.
+   */
+  class MapDictionary final : public Dictionary {
+    private:
+      std::map<std::string, uint64_t> ids;
+      std::vector<std::string> values;
+
+    public:
+      void bulkInsert(size_t size, std::string* newValues) {
+        for (size_t i = 0; i < size; i++) {
+          insert(newValues[i]);
+        }
+      }
+
+      uint64_t insert(std::string value) {
+        auto it = ids.insert(std::make_pair(value, values.size() + 1));
+        if (it.second) {
+          values.push_back(value);
+          nextId++;
+        }
+        return it.first->second;
+      }
+
+      bool lookup(std::string value, uint64_t& id) const {
+        auto it = ids.find(value);
+        if (it == ids.cend()) {
+          return false;
+        }
+        id = it->second;
+        return true;
+      }
+
+      bool lookup(uint64_t id, std::string& value) const {
+        if (id == 0 || id > values.size()) {
+          return false;
+        }
+        value = values[id - 1];
+        return true;
+      }
+
+      void rangeLookup(std::string prefix, RangeLookupCallbackType callback) const {
+        for (auto it = ids.lower_bound(prefix); it != ids.cend() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+          callback(it->second, it->first);
+        }
+      }
+
+      std::string description() const {
+        return "Map";
+      }
+
+      std::string numberOfLeaves() const {
+        return "0";
+      }
+  };
+}
+
+TEST(Integration, NamespaceDictionaryBulkLoads) {
+  // The first load uses the namespace once, so its value is stored without
+  // it; the second load would make it shared
+  std::vector<std::string> first { "http://example.org/a", "literal" };
+  std::vector<std::string> second { "http://example.org/b", "http://example.org/c" };
+
+  NamespaceDictionary<MapDictionary> dict;
+  dict.bulkInsert(first.size(), &first[0]);
+  dict.bulkInsert(second.size(), &second[0]);
+  ASSERT_EQ(1u, dict.numberOfNamespaces());
+  ASSERT_EQ(4u, dict.size());
+
+  for (const auto& values : { first, second }) {
+    for (const auto& value : values) {
+      uint64_t id;
+      ASSERT_TRUE(dict.lookup(value, id)) << value;
+      std::string idValue;
+      ASSERT_TRUE(dict.lookup(id, idValue));
+      ASSERT_EQ(value, idValue);
+    }
+  }
+
+  uint64_t matches = 0;
+  dict.rangeLookup("http://example.org/", [&](uint64_t, std::string) {
+    matches++;
+  });
+  ASSERT_EQ(3u, matches);
+}
+
+TEST(Integration, InlineIdDictionary) {
+  std::vector<std::string> inlineValues {
+    "-17",
+    "0",
+    "1.5",
+    "123456789012",
+    "2016-02-29",
+    "true",
+    "",
+    // Not canonical integers, but short strings
+    "-0",
+    "007",
+  };
+  std::vector<std::string> storedValues {
+    "2016-13-01",
+    "72057594037927936",
+    "http://example.org/a",
+    "http://example.org/b",
+    "truetrue!",
+  };
+  std::vector<std::string> values(inlineValues);
+  values.insert(values.end(), storedValues.begin(), storedValues.end());
+  std::sort(values.begin(), values.end());
+
+  InlineIdDictionary<StringDictionary<ART, HAT, SlottedPage<256>, IndirectStrategy>> dict;
+  dict.bulkInsert(values.size(), &values[0]);
+  ASSERT_EQ(storedValues.size(), dict.size());
+
+  for (const auto& value : values) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(value, id));
+    bool isInline = std::find(inlineValues.begin(), inlineValues.end(), value) != inlineValues.end();
+    ASSERT_EQ(isInline, dict.isInline(id));
+
+    std::string idValue;
+    ASSERT_TRUE(dict.lookup(id, idValue));
+    ASSERT_EQ(value, idValue);
+  }
+
+  // Inline values are known without being inserted
+  uint64_t id;
+  ASSERT_TRUE(dict.lookup("42", id));
+  std::string value;
+  ASSERT_TRUE(dict.lookup(id, value));
+  ASSERT_EQ("42", value);
+  ASSERT_FALSE(dict.lookup("http://example.org/c", id));
+
+  // Inline IDs only have one encoding
+  uint64_t stringId;
+  ASSERT_TRUE(dict.lookup("true", stringId));
+  ASSERT_FALSE(dict.lookup(stringId | (1ull << 40), value));
+
+  // Range lookups include the loaded inline values, but not the ones that
+  // are only known
+  std::set<std::string> rangeValues;
+  auto callback = [&](uint64_t rangeId, std::string rangeValue) {
+    std::string idValue;
+    ASSERT_TRUE(dict.lookup(rangeId, idValue));
+    ASSERT_EQ(rangeValue, idValue);
+    rangeValues.insert(rangeValue);
+  };
+  dict.rangeLookup("t", callback);
+  ASSERT_EQ((std::set<std::string> { "true", "truetrue!" }), rangeValues);
+
+  rangeValues.clear();
+  dict.rangeLookup("", callback);
+  ASSERT_EQ(std::set<std::string>(values.begin(), values.end()), rangeValues);
+
+  rangeValues.clear();
+  dict.rangeLookup("4", callback);
+  ASSERT_TRUE(rangeValues.empty());
+  dict.insert("42");
+  dict.rangeLookup("4", callback);
+  ASSERT_EQ((std::set<std::string> { "42" }), rangeValues);
+}
+
+TEST(Integration, PartitionedDictionary) {
+  std::vector<std::pair<std::string, uint8_t>> terms;
+  for (uint64_t i = 0; i < 300; i++) {
+    // Every third subject is also an object
+    terms.push_back(make_pair("http://example.org/s" + std::to_string(1000 + i), i % 3 == 0 ? partition::Subject | partition::Object : partition::Subject));
+    terms.push_back(make_pair("http://example.org/o" + std::to_string(1000 + i), partition::Object));
+    terms.push_back(make_pair("literal " + std::to_string(1000 + i) + std::string(i % 50, 'x'), partition::Object | partition::Literal));
+  }
+  for (uint64_t i = 0; i < 5; i++) {
+    terms.push_back(make_pair("http://example.org/p" + std::to_string(i), partition::Predicate));
+  }
+  // Described by triples of its own, like rdf:type
+  terms.push_back(std::make_pair("http://example.org/pdescribed", partition::Predicate | partition::Subject));
+  std::sort(terms.begin(), terms.end());
+  std::vector<std::string> values;
+  std::vector<uint8_t> roles;
+  for (const auto& term : terms) {
+    values.push_back(term.first);
+    roles.push_back(term.second);
+  }
+
+  typedef StringDictionary<ART, HAT, SlottedPage<256>, IndirectStrategy> termSection;
+  PartitionedDictionary<termSection, termSection, termSection, StringDictionary<ART, HAT, SingleUncompressedPage<256>>, StringDictionary<ART, HAT, RestartPage<1024>, DeltaStrategy>> dict;
+  dict.bulkInsert(values.size(), &values[0], &roles[0]);
+  ASSERT_EQ(values.size(), dict.size());
+
+  std::set<uint64_t> ids;
+  for (const auto& term : terms) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(term.first, id));
+    ASSERT_EQ(partition::sectionOf(term.second), dict.sectionOfId(id));
+    ids.insert(id);
+
+    std::string value;
+    ASSERT_TRUE(dict.lookup(id, value));
+    ASSERT_EQ(term.first, value);
+
+    // Role lookups only search the sections of the role
+    uint64_t roleId;
+    if (term.second & partition::Literal) {
+      ASSERT_TRUE(dict.lookup(term.first, partition::Literal, roleId));
+      ASSERT_FALSE(dict.lookup(term.first, partition::Object, roleId));
+    }
+    else if (term.second & partition::Predicate) {
+      ASSERT_TRUE(dict.lookup(term.first, partition::Predicate, roleId));
+      ASSERT_EQ(id, roleId);
+      // Also found in the role of a subject, as for the described predicate
+      ASSERT_TRUE(dict.lookup(term.first, partition::Subject, roleId));
+      ASSERT_EQ(id, roleId);
+      ASSERT_FALSE(dict.lookup(term.first, partition::Literal, roleId));
+    }
+    else {
+      ASSERT_EQ((term.second & partition::Subject) != 0, dict.lookup(term.first, partition::Subject, roleId));
+      ASSERT_EQ((term.second & partition::Object) != 0, dict.lookup(term.first, partition::Object, roleId));
+    }
+    if (dict.lookup(term.first, partition::Subject, roleId) || dict.lookup(term.first, partition::Object, roleId)) {
+      ASSERT_EQ(id, roleId);
+    }
+  }
+  ASSERT_EQ(values.size(), ids.size());
+
+  uint64_t id;
+  ASSERT_FALSE(dict.lookup("http://example.org/x", id));
+  std::string value;
+  ASSERT_FALSE(dict.lookup(uint64_t(7) << 60 | 1, value));
+
+  std::vector<std::pair<uint64_t, std::string>> lookupValues;
+  dict.rangeLookup("http://example.org/", [&](uint64_t id, std::string value) {
+    lookupValues.push_back(make_pair(id, value));
+  });
+  ASSERT_EQ(606, lookupValues.size());
+}
@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "LoadPipeline.hpp"
+#include "ConcurrentEncoder.hpp"
+#include "ExternalSorter.hpp"
+#include "StringDictionary.hpp"
+#include "NamespaceDictionary.hpp"
+#include "InlineIdDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+void runPipeline(size_t numberOfEncoders, bool checkCache) {
+  stringstream turtle;
+  turtle << "@prefix ex: <http://example.org/> ." << endl;
+  turtle << "ex:alice ex:knows ex:bob , ex:carol ;" << endl;
+  turtle << "  ex:name \"Alice\" ." << endl;
+  turtle << "ex:bob ex:knows ex:alice ." << endl;
+
+  vector<array<string, 3>> expected {
+    {{ "http://example.org/alice", "http://example.org/knows", "http://example.org/bob" }},
+    {{ "http://example.org/alice", "http://example.org/knows", "http://example.org/carol" }},
+    {{ "http://example.org/alice", "http://example.org/name", "Alice" }},
+    {{ "http://example.org/bob", "http://example.org/knows", "http://example.org/alice" }},
+  };
+
+  const string fileName = "/tmp/LoadPipelineTests-" + to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".triples";
+
+  StringDictionary<ART, HAT, SlottedPage<64>, IndirectStrategy> dict;
+  // Small batches and queues to exercise the hand-over between stages, and
+  // a small sort budget to spill the terms
+  ASSERT_TRUE(dict.numbersByRank());
+  LoadPipeline pipeline(&dict, numberOfEncoders, 1, 1, 2 * ExternalSorter::entryOverhead);
+  auto statistics = pipeline.run(turtle, fileName);
+
+  ASSERT_EQ(expected.size(), statistics.triples);
+  ASSERT_EQ(6, statistics.terms);
+  ASSERT_EQ(6, dict.size());
+  ASSERT_EQ(0, statistics.parseErrors);
+  ASSERT_LT(0, statistics.sortRuns);
+  if (checkCache) {
+    // Repeated subject and predicates of the predicate/object lists
+    ASSERT_LE(3, statistics.cacheHits);
+  }
+
+  ifstream file(fileName, ios::binary);
+  vector<array<uint64_t, 3>> triples(expected.size() + 1);
+  file.read(reinterpret_cast<char*>(triples.data()), triples.size() * sizeof(triples[0]));
+  ASSERT_EQ(expected.size() * sizeof(triples[0]), file.gcount());
+  file.close();
+  remove(fileName.c_str());
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    for (size_t j = 0; j < 3; j++) {
+      string value;
+      ASSERT_TRUE(dict.lookup(triples[i][j], value));
+      ASSERT_EQ(expected[i][j], value);
+    }
+  }
+}
+
+TEST(LoadPipeline, EncodeTriples) {
+  runPipeline(1, true);
+}
+
+TEST(LoadPipeline, ParallelEncoders) {
+  // Batches may finish out of order, the triple file must not
+  runPipeline(3, false);
+}
+
+TEST(ConcurrentEncoder, ParallelEncode) {
+  const uint64_t numberOfTerms = 10000;
+  const uint64_t numberOfThreads = 4;
+  ConcurrentEncoder encoder(2);
+
+  // Each thread encodes all terms, in a different order
+  const uint64_t strides[numberOfThreads] = { 1, 3, 7, 9 };
+  vector<vector<uint64_t>> ids(numberOfThreads, vector<uint64_t>(numberOfTerms));
+  vector<thread> threads;
+  for (uint64_t t = 0; t < numberOfThreads; t++) {
+    threads.push_back(thread([&, t] {
+      for (uint64_t i = 0; i < numberOfTerms; i++) {
+        uint64_t term = (i * strides[t]) % numberOfTerms;
+        ids[t][term] = encoder.encode("http://example.org/" + to_string(term));
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(numberOfTerms, encoder.size());
+  for (uint64_t t = 1; t < numberOfThreads; t++) {
+    ASSERT_EQ(ids[0], ids[t]);
+  }
+
+  vector<string> sortedTerms;
+  vector<uint64_t> finalIds;
+  encoder.finish(sortedTerms, finalIds);
+
+  ASSERT_EQ(numberOfTerms, sortedTerms.size());
+  ASSERT_TRUE(is_sorted(sortedTerms.begin(), sortedTerms.end()));
+  for (uint64_t term = 0; term < numberOfTerms; term++) {
+    ASSERT_EQ("http://example.org/" + to_string(term), sortedTerms[finalIds[ids[0][term]] - 1]);
+  }
+  ASSERT_EQ(0, encoder.size());
+}
+
+TEST(LoadPipeline, DictionaryIds) {
+  stringstream turtle;
+  turtle << "@prefix ex: <http://example.org/> ." << endl;
+  turtle << "ex:alice ex:age 42 ;" << endl;
+  turtle << "  ex:name \"Alice Liddell\" ." << endl;
+
+  vector<array<string, 3>> expected {
+    {{ "http://example.org/alice", "http://example.org/age", "42" }},
+    {{ "http://example.org/alice", "http://example.org/name", "Alice Liddell" }},
+  };
+
+  const string fileName = "/tmp/LoadPipelineTests-" + to_string(::testing::UnitTest::GetInstance()->random_seed()) + ".triples";
+
+  // Neither numbers the terms by their rank
+  InlineIdDictionary<NamespaceDictionary<StringDictionary<ART, HAT, SlottedPage<64>, IndirectStrategy>>> dict;
+  ASSERT_FALSE(dict.numbersByRank());
+  LoadPipeline pipeline(&dict, 1, 1, 1);
+  auto statistics = pipeline.run(turtle, fileName);
+  ASSERT_EQ(expected.size(), statistics.triples);
+  ASSERT_EQ(5, statistics.terms);
+  ASSERT_EQ(4, dict.size());
+
+  ifstream file(fileName, ios::binary);
+  vector<array<uint64_t, 3>> triples(expected.size());
+  file.read(reinterpret_cast<char*>(triples.data()), triples.size() * sizeof(triples[0]));
+  file.close();
+  remove(fileName.c_str());
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    for (size_t j = 0; j < 3; j++) {
+      string value;
+      ASSERT_TRUE(dict.lookup(triples[i][j], value));
+      ASSERT_EQ(expected[i][j], value);
+    }
+  }
+  ASSERT_TRUE(dict.isInline(triples[0][2]));
+}
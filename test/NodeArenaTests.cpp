@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "NodeArena.hpp"
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+TEST(NodeArena, ReuseFreedNodes) {
+  NodeArena arena;
+
+  void* small = arena.allocate(40);
+  void* large = arena.allocate(600);
+  ASSERT_NE(small, large);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(small) % NodeArena::granularity);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(large) % NodeArena::granularity);
+
+  arena.deallocate(small, 40);
+  // Other size classes don't get the freed node
+  ASSERT_NE(small, arena.allocate(600));
+  ASSERT_EQ(small, arena.allocate(40));
+}
+
+TEST(NodeArena, ManySlabs) {
+  for (bool hugePages : { false, true }) {
+    NodeArena arena(hugePages);
+    vector<char*> nodes;
+    for (size_t i = 0; i < 3 * NodeArena::slabSize / 2048; i++) {
+      char* node = static_cast<char*>(arena.allocate(2048));
+      memset(node, static_cast<int>(i), 2048);
+      nodes.push_back(node);
+    }
+
+    ASSERT_LE(3, arena.reservedMemory() / NodeArena::slabSize);
+    for (size_t i = 0; i < nodes.size(); i++) {
+      ASSERT_EQ(static_cast<char>(i), nodes[i][0]);
+      ASSERT_EQ(static_cast<char>(i), nodes[i][2047]);
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include "NodeSearch.hpp"
+#include <cstring>
+
+TEST(NodeSearch, SortedKeys) {
+  // Node16 keys are stored with flipped sign bit
+  uint8_t keys[16];
+  for (unsigned i = 0; i < 16; i++) {
+    keys[i] = static_cast<uint8_t>((i * 16 + 8) ^ 128);
+  }
+
+  for (unsigned count = 1; count <= 16; count++) {
+    for (unsigned keyByte = 0; keyByte < 256; keyByte++) {
+      uint8_t flipped = static_cast<uint8_t>(keyByte ^ 128);
+      unsigned expectedFind = count, expectedGreater = count, expectedLower = count;
+      for (unsigned i = 0; i < count; i++) {
+        unsigned key = keys[i] ^ 128u;
+        if (key == keyByte) expectedFind = i;
+        if (key > keyByte && expectedGreater == count) expectedGreater = i;
+        if (key < keyByte) expectedLower = i;
+      }
+      ASSERT_EQ(expectedFind, nodesearch::find16(keys, count, flipped));
+      ASSERT_EQ(expectedGreater, nodesearch::greater16(keys, count, flipped));
+      ASSERT_EQ(expectedLower, nodesearch::lower16(keys, count, flipped));
+    }
+  }
+
+  uint8_t keys4[4] = { 200, 0, 1, 17 };
+  for (unsigned count = 0; count <= 4; count++) {
+    for (unsigned keyByte = 0; keyByte < 256; keyByte++) {
+      unsigned expected = count;
+      for (unsigned i = 0; i < count && expected == count; i++) {
+        if (keys4[i] == keyByte) expected = i;
+      }
+      ASSERT_EQ(expected, nodesearch::find4(keys4, count, static_cast<uint8_t>(keyByte)));
+    }
+  }
+}
+
+TEST(NodeSearch, OccupancyKernels) {
+  const uint8_t emptyMarker = 48;
+  uint8_t childIndex[256];
+  memset(childIndex, emptyMarker, sizeof(childIndex));
+  for (unsigned i : { 0u, 15u, 16u, 63u, 64u, 100u, 200u, 255u }) {
+    childIndex[i] = 1;
+  }
+
+  ASSERT_LE(2, nodesearch::supportedKernels().size());
+  for (const auto& kernel : nodesearch::supportedKernels()) {
+    SCOPED_TRACE(kernel.name);
+    for (unsigned pos = 0; pos <= 256; pos++) {
+      unsigned next = 256, previous = 256;
+      for (unsigned i = pos; i < 256; i++) {
+        if (childIndex[i] != emptyMarker) { next = i; break; }
+      }
+      for (unsigned i = pos; i > 0; i--) {
+        if (childIndex[i-1] != emptyMarker) { previous = i-1; break; }
+      }
+      ASSERT_EQ(next, kernel.next(childIndex, pos, emptyMarker));
+      ASSERT_EQ(previous, kernel.previous(childIndex, pos, emptyMarker));
+    }
+  }
+}
@@ -1,6 +1,11 @@
 #include "gtest/gtest.h"
 #include "MultiUncompressedPage.hpp"
 #include "DynamicPage.hpp"
+#include "ImplicitIdPage.hpp"
+#include "PaxPage.hpp"
+#include "RestartPage.hpp"
+#include "SingleUncompressedPage.hpp"
+#include "SlottedPage.hpp"
 #include <vector>
 
 using namespace std;
@@ -27,9 +32,10 @@ TEST(MultipleUncompressedStringsPerPage, Create) {
   typedef MultiUncompressedPage<1024, 3> pageType;
 
   std::vector<pageType*> pages;
+  pageType::Arena arena;
   pageType::load(insertValues, [&pages](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
       pages.push_back(page);
-  });
+  }, arena);
 
   uint64_t i = 0;
   for (auto iterator = pages.front()->getId(0); iterator; ++iterator) {
@@ -41,6 +47,40 @@ TEST(MultipleUncompressedStringsPerPage, Create) {
   ASSERT_EQ(i, values.size());
 }
 
+TEST(MultipleUncompressedStringsPerPage, Overflow) {
+  vector<pair<uint64_t, string>> insertValues;
+  for (uint64_t i = 0; i < 100; i++) {
+    string value = "http://example.org/" + to_string(10000 + i);
+    if (i % 10 == 3) {
+      // Longer than a page
+      value += string(1000 + i, 'x');
+    }
+    insertValues.push_back(make_pair(i, value));
+  }
+
+  typedef MultiUncompressedPage<256, 4> pageType;
+
+  vector<pair<pageType*, uint16_t>> entries;
+  pageType::Arena arena;
+  pageType::load(insertValues, [&entries](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      entries.push_back(make_pair(page, offset));
+  }, arena);
+  ASSERT_EQ(insertValues.size(), entries.size());
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto leaf = *entries[i].first->getByOffset(entries[i].second);
+    ASSERT_EQ(insertValues[i].first, leaf.first);
+    ASSERT_EQ(insertValues[i].second, leaf.second);
+  }
+
+  uint64_t i = 0;
+  for (auto iterator = entries.front().first->getId(0); iterator; ++iterator) {
+    ASSERT_EQ(insertValues[i].second, (*iterator).second);
+    i++;
+  }
+  ASSERT_EQ(i, insertValues.size());
+}
+
 TEST(SingleUncompressedStringPerPage, Create) {
   vector<string> values {
     "aaa",
@@ -63,9 +103,10 @@ TEST(SingleUncompressedStringPerPage, Create) {
   typedef SingleUncompressedPage<1024> pageType;
 
   std::vector<pageType*> pages;
+  pageType::Arena arena;
   pageType::load(insertValues, [&pages](pageType* page, uint16_t delta, uint16_t offset, uint64_t id, std::string value) {
       pages.push_back(page);
-  });
+  }, arena);
 
   uint64_t i = 0;
   for (auto iterator = pages.front()->getId(0); iterator; ++iterator) {
@@ -99,11 +140,12 @@ TEST(DynamicPage, Create) {
   typedef DynamicPage<> pageType;
   pageType* firstPage = nullptr;
 
+  page::NoArena arena;
   pageType::load(insertValues, [&firstPage](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
     if (firstPage == nullptr) {
       firstPage = page;
     }
-  });
+  }, arena);
 
   uint64_t i = 0;
   for (auto iterator = firstPage->getId(0); iterator; ++iterator) {
@@ -114,3 +156,370 @@ TEST(DynamicPage, Create) {
   }
   ASSERT_EQ(i, values.size());
 }
+
+TEST(PageArena, PageNumbers) {
+  typedef SingleUncompressedPage<(1024<<6)> pageType;
+
+  pageType::Arena arena;
+  std::vector<pageType*> pages;
+  for (size_t i = 0; i < 100; i++) {
+    pages.push_back(new (arena) pageType());
+  }
+
+  for (size_t i = 0; i < pages.size(); i++) {
+    uint64_t number = arena.numberOf(pages[i]);
+    ASSERT_LT(0, number);
+    ASSERT_EQ(pages[i], arena.get(number));
+    if (i > 0) {
+      // Contiguous numbering
+      ASSERT_EQ(arena.numberOf(pages[i-1]) + 1, number);
+    }
+  }
+  ASSERT_EQ(pages.size(), arena.size());
+
+  // Arenas of different dictionaries number their pages independently
+  pageType::Arena otherArena;
+  pageType* otherPage = new (otherArena) pageType();
+  ASSERT_EQ(1u, otherArena.numberOf(otherPage));
+  ASSERT_EQ(pages.size(), arena.size());
+}
+
+TEST(DynamicPage, ValueMismatch) {
+  vector<pair<uint64_t, string>> insertValues {
+    make_pair(1, "abcd"),
+    make_pair(2, "abce"),
+    make_pair(3, "abcef"),
+  };
+
+  typedef DynamicPage<> pageType;
+  pageType* firstPage = nullptr;
+
+  page::NoArena arena;
+  pageType::load(insertValues, [&firstPage](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+    if (firstPage == nullptr) {
+      firstPage = page;
+    }
+  }, arena);
+
+  // Delta-encoded values compare against the key, including the terminator
+  auto iterator = firstPage->getId(1);
+  ASSERT_EQ("abcd", (*iterator).second);
+  ++iterator;
+  const uint8_t* key = reinterpret_cast<const uint8_t*>("abce");
+  ASSERT_EQ(5, iterator.valueMismatch(key, 0, 5));
+  ASSERT_EQ(5, iterator.valueMismatch(key, 3, 5));
+
+  key = reinterpret_cast<const uint8_t*>("abcf");
+  ASSERT_EQ(3, iterator.valueMismatch(key, 0, 5));
+  ASSERT_EQ(5, iterator.valueMismatch(key, 4, 5));
+
+  ++iterator;
+  key = reinterpret_cast<const uint8_t*>("abce");
+  ASSERT_EQ(4, iterator.valueMismatch(key, 0, 5));
+}
+
+TEST(ImplicitIdPage, Create) {
+  vector<pair<uint64_t, string>> insertValues;
+  uint64_t nextId = 1;
+  for (size_t i = 0; i < 2000; i++) {
+    // Gaps in the IDs, like after a merge
+    if (i % 150 == 0) {
+      nextId += 10;
+    }
+    insertValues.push_back(make_pair(nextId++, "http://example.org/" + to_string(10000 + i)));
+  }
+
+  typedef ImplicitIdPage<512> pageType;
+  typedef SlottedPage<512> slottedPageType;
+
+  vector<pair<pageType*, uint16_t>> entries;
+  pageType::Arena arena;
+  pageType::load(insertValues, [&entries](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      entries.push_back(make_pair(page, deltaValue));
+  }, arena);
+  ASSERT_EQ(insertValues.size(), entries.size());
+
+  uint64_t slottedPages = 0;
+  slottedPageType* lastSlottedPage = nullptr;
+  slottedPageType::Arena slottedArena;
+  slottedPageType::load(insertValues, [&](slottedPageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (page != lastSlottedPage) {
+        slottedPages++;
+        lastSlottedPage = page;
+      }
+  }, slottedArena);
+
+  uint64_t pages = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto iterator = entries[i].first->getIndexEntry(entries[i].second);
+    ASSERT_EQ(insertValues[i].second, iterator.getValue());
+    iterator = entries[i].first->getIndexEntry(entries[i].second);
+    ASSERT_EQ(insertValues[i].first, iterator.getId());
+    if (entries[i].second == 0) {
+      pages++;
+      // A run per gap at most, plus the first one
+      ASSERT_GE(2, entries[i].first->numberOfRuns());
+    }
+  }
+  ASSERT_LT(pages, slottedPages);
+
+  // Iterating across pages keeps track of the positions
+  uint64_t i = 0;
+  for (auto iterator = entries.front().first->getIndexEntry(0); iterator; ++iterator) {
+    auto leaf = *iterator;
+    ASSERT_EQ(insertValues[i].first, leaf.first);
+    ASSERT_EQ(insertValues[i].second, leaf.second);
+    i++;
+  }
+  ASSERT_EQ(i, insertValues.size());
+}
+
+TEST(PackedLayout, Create) {
+  vector<pair<uint64_t, string>> insertValues;
+  for (uint64_t i = 0; i < 3000; i++) {
+    // Mostly short deltas, some longer than fit into the header byte or one varint byte
+    string value = "http://example.org/" + to_string(10000 + i);
+    if (i % 7 == 0) {
+      value += string(i % 300, 'x');
+    }
+    insertValues.push_back(make_pair(i + 1, value));
+  }
+
+  typedef SlottedPage<1024, page::PackedLayout> pageType;
+  typedef SlottedPage<1024> fixedPageType;
+
+  vector<pair<pageType*, uint16_t>> entries;
+  pageType::Arena arena;
+  pageType::load(insertValues, [&entries](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      entries.push_back(make_pair(page, deltaValue));
+  }, arena);
+  ASSERT_EQ(insertValues.size(), entries.size());
+
+  uint64_t fixedPages = 0;
+  fixedPageType::Arena fixedArena;
+  fixedPageType::load(insertValues, [&fixedPages](fixedPageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (deltaValue == 0) {
+        fixedPages++;
+      }
+  }, fixedArena);
+
+  uint64_t pages = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto iterator = entries[i].first->getIndexEntry(entries[i].second);
+    auto leaf = *iterator;
+    ASSERT_EQ(insertValues[i].first, leaf.first);
+    ASSERT_EQ(insertValues[i].second, leaf.second);
+
+    const string& value = insertValues[i].second;
+    const uint8_t* key = reinterpret_cast<const uint8_t*>(value.c_str());
+    ASSERT_EQ(value.size()+1, iterator.valueMismatch(key, 0, static_cast<unsigned>(value.size()+1)));
+    if (entries[i].second == 0) {
+      pages++;
+    }
+  }
+  ASSERT_LT(pages, fixedPages);
+
+  uint64_t i = 0;
+  for (auto iterator = entries.front().first->getIndexEntry(0); iterator; ++iterator) {
+    ASSERT_EQ(insertValues[i].second, (*iterator).second);
+    i++;
+  }
+  ASSERT_EQ(i, insertValues.size());
+}
+
+TEST(PageLoader, PrefixBoundary) {
+  vector<pair<uint64_t, string>> insertValues;
+  for (uint64_t i = 0; i < 10; i++) {
+    insertValues.push_back(make_pair(insertValues.size(), "http://example.org/alpha/resource/" + to_string(100 + i)));
+  }
+  for (uint64_t i = 0; i < 6; i++) {
+    insertValues.push_back(make_pair(insertValues.size(), "http://example.org/beta/resource/" + to_string(100 + i)));
+  }
+
+  typedef SlottedPage<256> slottedPageType;
+  typedef SingleUncompressedPage<256> singlePageType;
+
+  // Both groups need two pages; the second one starts with the second group
+  vector<uint64_t> slottedStarts;
+  slottedPageType* lastSlottedPage = nullptr;
+  slottedPageType::Arena slottedArena;
+  slottedPageType::load(insertValues, [&](slottedPageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (page != lastSlottedPage) {
+        slottedStarts.push_back(id);
+        lastSlottedPage = page;
+      }
+  }, slottedArena);
+  ASSERT_EQ(vector<uint64_t>({0, 10}), slottedStarts);
+
+  vector<uint64_t> singleStarts;
+  singlePageType* lastSinglePage = nullptr;
+  singlePageType::Arena singleArena;
+  singlePageType::load(insertValues, [&](singlePageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (page != lastSinglePage) {
+        singleStarts.push_back(id);
+        lastSinglePage = page;
+      }
+  }, singleArena);
+  ASSERT_EQ(vector<uint64_t>({0, 10}), singleStarts);
+
+  uint64_t i = 0;
+  for (auto iterator = lastSinglePage->getId(10); iterator; ++iterator) {
+    ASSERT_EQ(insertValues[10 + i].second, (*iterator).second);
+    i++;
+  }
+  ASSERT_EQ(6u, i);
+}
+
+TEST(PaxPage, Search) {
+  vector<pair<uint64_t, string>> insertValues;
+  for (uint64_t i = 0; i < 3000; i++) {
+    // Groups of values with different prefixes, so all kinds of prefix lengths occur
+    string value = "http://example.org/" + to_string(10 + i / 100) + "/" + to_string(1000 + i);
+    if (i % 11 == 0) {
+      value += "/x";
+    }
+    insertValues.push_back(make_pair(i + 1, value));
+  }
+
+  typedef PaxPage<1024> pageType;
+
+  vector<pair<pageType*, uint16_t>> entries;
+  pageType::Arena arena;
+  pageType::load(insertValues, [&entries](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (deltaValue != 0) {
+        entries.push_back(make_pair(page, offset));
+      }
+  }, arena);
+  ASSERT_EQ(insertValues.size(), entries.size());
+
+  pageType* firstPage = entries.front().first;
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto iterator = entries[i].first->getByOffset(entries[i].second);
+    auto leaf = *iterator;
+    ASSERT_EQ(insertValues[i].first, leaf.first);
+    ASSERT_EQ(insertValues[i].second, leaf.second);
+
+    const string& value = insertValues[i].second;
+    const uint8_t* key = reinterpret_cast<const uint8_t*>(value.c_str());
+    ASSERT_EQ(value.size()+1, iterator.valueMismatch(key, 0, static_cast<unsigned>(value.size()+1)));
+
+    // Searches continue on the following pages
+    iterator = firstPage->find(value);
+    ASSERT_TRUE(iterator);
+    ASSERT_EQ(insertValues[i].first, iterator.getId());
+
+    ASSERT_FALSE(entries[i].first->find(value + "0"));
+    ASSERT_FALSE(entries[i].first->find(value.substr(0, value.size()-1)));
+  }
+  ASSERT_FALSE(firstPage->find("a"));
+  ASSERT_FALSE(firstPage->find("z"));
+
+  auto start = firstPage->firstPrefix("http://example.org/12/");
+  auto end = firstPage->lastPrefix("http://example.org/12/");
+  ASSERT_TRUE(start);
+  ASSERT_TRUE(end);
+  ASSERT_EQ(201u, start.getId());
+  ASSERT_EQ(300u, end.getId());
+  ASSERT_FALSE(firstPage->firstPrefix("http://example.org/9"));
+
+  uint64_t i = 0;
+  for (auto iterator = firstPage->getIndexEntry(0); iterator; ++iterator) {
+    ASSERT_EQ(insertValues[i].second, (*iterator).second);
+    i++;
+  }
+  ASSERT_EQ(i, insertValues.size());
+}
+
+TEST(RestartPage, Create) {
+  vector<pair<uint64_t, string>> insertValues;
+  for (uint64_t i = 0; i < 5000; i++) {
+    // The shared prefix with the first value of a page shrinks across large pages
+    insertValues.push_back(make_pair(i + 1, "http://example.org/resource/" + to_string(10 + i / 40) + "/item" + to_string(10000 + i)));
+  }
+
+  typedef RestartPage<(1024<<4), 16> pageType;
+  typedef RestartPage<(1024<<4), 1> uncodedPageType;
+  typedef SingleUncompressedPage<(1024<<4)> singlePageType;
+
+  vector<pair<pageType*, uint16_t>> entries;
+  pageType::Arena arena;
+  pageType::load(insertValues, [&entries](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      entries.push_back(make_pair(page, deltaValue));
+  }, arena);
+  ASSERT_EQ(insertValues.size(), entries.size());
+
+  uint64_t uncodedPages = 0;
+  uncodedPageType::Arena uncodedArena;
+  uncodedPageType::load(insertValues, [&uncodedPages](uncodedPageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (deltaValue == 0) {
+        uncodedPages++;
+      }
+  }, uncodedArena);
+
+  uint64_t singlePages = 0;
+  singlePageType::Arena singleArena;
+  singlePageType::load(insertValues, [&singlePages](singlePageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      if (deltaValue == 0) {
+        singlePages++;
+      }
+  }, singleArena);
+
+  uint64_t pages = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto iterator = entries[i].first->getByDelta(entries[i].second);
+    auto leaf = *iterator;
+    ASSERT_EQ(insertValues[i].first, leaf.first);
+    ASSERT_EQ(insertValues[i].second, leaf.second);
+
+    const string& value = insertValues[i].second;
+    const uint8_t* key = reinterpret_cast<const uint8_t*>(value.c_str());
+    ASSERT_EQ(value.size()+1, iterator.valueMismatch(key, 0, static_cast<unsigned>(value.size()+1)));
+    if (entries[i].second == 0) {
+      pages++;
+    }
+  }
+  ASSERT_LT(pages, singlePages);
+  ASSERT_LT(pages, uncodedPages);
+
+  uint64_t i = 0;
+  for (auto iterator = entries.front().first->getIndexEntry(0); iterator; ++iterator) {
+    ASSERT_EQ(insertValues[i].first, (*iterator).first);
+    ASSERT_EQ(insertValues[i].second, (*iterator).second);
+    i++;
+  }
+  ASSERT_EQ(i, insertValues.size());
+}
+
+TEST(RestartPage, Overflow) {
+  vector<pair<uint64_t, string>> insertValues;
+  for (uint64_t i = 0; i < 200; i++) {
+    string value = "http://example.org/" + to_string(10000 + i);
+    if (i % 10 == 0) {
+      // Much longer than a page, and some longer than a blob chunk
+      value += string(i == 100 ? (3 << 20) : 1000 + i * 100, 'x');
+    }
+    insertValues.push_back(make_pair(i + 1, value));
+  }
+
+  typedef RestartPage<512, 4> pageType;
+
+  vector<pair<pageType*, uint16_t>> entries;
+  pageType::Arena arena;
+  pageType::load(insertValues, [&entries](pageType* page, uint16_t deltaValue, uint16_t offset, uint64_t id, std::string value) {
+      entries.push_back(make_pair(page, deltaValue));
+  }, arena);
+  ASSERT_EQ(insertValues.size(), entries.size());
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    auto leaf = *entries[i].first->getIndexEntry(entries[i].second);
+    ASSERT_EQ(insertValues[i].first, leaf.first);
+    ASSERT_EQ(insertValues[i].second, leaf.second);
+  }
+
+  uint64_t i = 0;
+  for (auto iterator = entries.front().first->getIndexEntry(0); iterator; ++iterator) {
+    ASSERT_EQ(insertValues[i].second, (*iterator).second);
+    i++;
+  }
+  ASSERT_EQ(i, insertValues.size());
+}
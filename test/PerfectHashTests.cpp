@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "PerfectHash.hpp"
+#include "StringDictionary.hpp"
+#include "Indexes.hpp"
+#include "Pages.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+  class VectorLeafStore : public LeafStore {
+    private:
+      const vector<string>& values;
+    public:
+      VectorLeafStore(const vector<string>& values) : values(values) { }
+      string getValue(uint64_t leafValue) const { return values[leafValue]; }
+      uint64_t getId(uint64_t leafValue) const { return leafValue * 3; }
+  };
+}
+
+TEST(PerfectHash, Lookup) {
+  vector<string> values;
+  for (uint64_t i = 0; i < 200000; i++) {
+    values.push_back("http://example.org/" + to_string(i));
+  }
+  VectorLeafStore store(values);
+
+  PerfectHash<string> index(&store);
+  PerfectHash<uint64_t> idIndex(&store);
+  for (uint64_t i = 0; i < values.size(); i++) {
+    index.insert(values[i], i);
+    idIndex.insert(i * 3, i);
+  }
+
+  uint64_t value;
+  ASSERT_TRUE(index.lookup(values[7], value));
+  ASSERT_EQ(7u, value);
+
+  // Large enough to be built in parallel
+  index.freeze();
+  idIndex.freeze();
+  ASSERT_TRUE(index.isFrozen());
+  ASSERT_THROW(index.insert("x", 0), Exception);
+  // Leaf values are packed to 18 bits; function and rank overhead stay within a few bits per key
+  ASSERT_LT(index.frozenSize(), values.size() * sizeof(uint32_t));
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    ASSERT_TRUE(index.lookup(values[i], value));
+    ASSERT_EQ(i, value);
+    ASSERT_TRUE(idIndex.lookup(i * 3, value));
+    ASSERT_EQ(i, value);
+  }
+
+  ASSERT_FALSE(index.lookup("http://example.org/", value));
+  ASSERT_FALSE(index.lookup("http://example.org/12345678", value));
+  ASSERT_FALSE(index.lookup("", value));
+  ASSERT_FALSE(idIndex.lookup(1, value));
+  ASSERT_THROW(index.rangeLookup("http://"), Exception);
+}
+
+TEST(PerfectHash, Empty) {
+  vector<string> values;
+  VectorLeafStore store(values);
+  PerfectHash<string> index(&store);
+  index.freeze();
+
+  uint64_t value;
+  ASSERT_FALSE(index.lookup("", value));
+  ASSERT_FALSE(index.lookup("value", value));
+}
+
+TEST(PerfectHash, WideLeafValues) {
+  vector<string> values;
+  VectorLeafStore store(values);
+  PerfectHash<uint64_t> idIndex(&store);
+  // 63 bit values, most of them spanning two words
+  const uint64_t base = 1ull << 62;
+  for (uint64_t i = 0; i < 1000; i++) {
+    idIndex.insert((base + i) * 3, base + i);
+  }
+  idIndex.freeze();
+
+  uint64_t value;
+  for (uint64_t i = 0; i < 1000; i++) {
+    ASSERT_TRUE(idIndex.lookup((base + i) * 3, value));
+    ASSERT_EQ(base + i, value);
+  }
+  ASSERT_FALSE(idIndex.lookup(3, value));
+}
+
+TEST(PerfectHash, StringIndex) {
+  StringDictionary<ART, PerfectHash, SlottedPage<48>, IndirectStrategy> dict;
+  vector<string> values;
+  for (uint64_t i = 0; i < 5000; i++) {
+    values.push_back("value" + to_string(i * 7));
+  }
+  dict.bulkInsert(values.size(), values.data());
+
+  for (uint64_t i = 0; i < values.size(); i++) {
+    uint64_t id;
+    ASSERT_TRUE(dict.lookup(values[i], id));
+    string value;
+    ASSERT_TRUE(dict.lookup(id, value));
+    ASSERT_EQ(values[i], value);
+  }
+}
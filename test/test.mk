@@ -1,4 +1,8 @@
-test_sources = PageTests.cpp IntegrationTests.cpp
+test_sources = PageTests.cpp IntegrationTests.cpp ExternalSorterTests.cpp \
+							 LoadPipelineTests.cpp NodeArenaTests.cpp NodeSearchTests.cpp \
+							 FrozenARTTests.cpp HATTests.cpp \
+							 FingerprintHashTests.cpp PerfectHashTests.cpp FingerprintARTTests.cpp \
+							 BloomFilterTests.cpp
 test_executables = test
 test_dependencies = src
 test_libraries = gmock gtest